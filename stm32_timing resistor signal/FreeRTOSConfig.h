@@ -0,0 +1,84 @@
+/**
+ ****************************************************************************************************
+ * @file        FreeRTOSConfig.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * myTASK_RTOS Ϊ 1 ʱʹõ FreeRTOS (STM32F103, 72MHz, Cortex-M3 ˿ portable/RVDS/ARM_CM3)
+ * Ҫ FreeRTOS ں˵ tasks.cqueue.clist.c  port.c, ȫ̬, Ҫ heap_x.c
+ *
+ * жȼ(HAL_Init Ϊ NVIC_PRIORITYGROUP_4, 4λȫռȼ):
+ *   3 ~ 15 Ե FromISR ӿ: ADC DMA(3)ڽ/DMA(3)TIM4 (3)
+ *   0 ~ 2  ںٽ, ܵ FreeRTOS ӿ:  EXTI
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/******************************************************************************************/
+/*  */
+
+#define configUSE_PREEMPTION 1
+#define configUSE_TIME_SLICING 0 /* ȼͬ, ҪʱƬת */
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
+#define configCPU_CLOCK_HZ (72000000UL)
+#define configTICK_RATE_HZ ((TickType_t)1000) /*  HAL  1ms һ, SysTick ߹ */
+#define configMAX_PRIORITIES 5
+#define configMINIMAL_STACK_SIZE ((unsigned short)128)
+#define configMAX_TASK_NAME_LEN 8
+#define configUSE_16_BIT_TICKS 0
+#define configIDLE_SHOULD_YIELD 1
+#define configUSE_TASK_NOTIFICATIONS 1
+#define configUSE_MUTEXES 0
+#define configUSE_COUNTING_SEMAPHORES 0
+#define configQUEUE_REGISTRY_SIZE 0
+
+/******************************************************************************************/
+/* ڴ: ȫ̬ */
+
+#define configSUPPORT_STATIC_ALLOCATION 1
+#define configSUPPORT_DYNAMIC_ALLOCATION 0
+
+/******************************************************************************************/
+/* Ӻ͵ */
+
+#define configUSE_IDLE_HOOK 0
+#define configUSE_TICK_HOOK 0
+#define configCHECK_FOR_STACK_OVERFLOW 0
+#define configUSE_MALLOC_FAILED_HOOK 0
+#define configUSE_TRACE_FACILITY 0
+#define configGENERATE_RUN_TIME_STATS 0 /* ʱ myTASK  DWT->CYCCNT ͳ */
+#define configUSE_TIMERS 0
+#define configUSE_CO_ROUTINES 0
+
+/******************************************************************************************/
+/* ѡӿ */
+
+#define INCLUDE_vTaskDelay 1
+#define INCLUDE_vTaskDelayUntil 0
+#define INCLUDE_vTaskDelete 0
+#define INCLUDE_vTaskSuspend 1 /* portMAX_DELAY ʾ޵ȴ */
+#define INCLUDE_xTaskGetSchedulerState 1
+#define INCLUDE_uxTaskGetStackHighWaterMark 0
+
+/******************************************************************************************/
+/* Cortex-M3 жȼ */
+
+#define configPRIO_BITS 4                                     /* STM32F1 ʹ4λȼ */
+#define configLIBRARY_LOWEST_INTERRUPT_PRIORITY 15
+#define configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY 3        /* ռȼ >= 3 жϿԵ FromISR ӿ */
+#define configKERNEL_INTERRUPT_PRIORITY (configLIBRARY_LOWEST_INTERRUPT_PRIORITY << (8 - configPRIO_BITS))
+#define configMAX_SYSCALL_INTERRUPT_PRIORITY (configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY << (8 - configPRIO_BITS))
+
+/* ˿ڵ쳣ֱΪе, stm32f1xx_it.c  myTASK_RTOS Ϊ 1 ʱٶ */
+#define vPortSVCHandler SVC_Handler
+#define xPortPendSVHandler PendSV_Handler
+
+#endif
@@ -21,59 +21,187 @@
 #include "myEXTI.h"
 #include "myADC.h"
 #include "myTIME.h"
+#include "myPROF.h"
+#include "myCMD.h"
+#include "myFRAME.h"
+#include "mySWEEP.h"
+#include "myTUNE.h"
+#include "myTASK.h"
+#include "myRAW.h"
+#include "myLINK.h"
+#include "myVALID.h"
+#include "myCFG.h"
+#include <string.h>
 
-uint8_t len;        // ͵ݳȣλֽڣԴδʼ
 uint32_t adc_value; //  ADC ȡֵ
+uint32_t adc_sum;   // һ ADC ݵۼӺ
+uint8_t valid_flags; // У־(myVALID)
 float voltage;      // תĵѹֵλV
 float R;            // ֵλM
 
-#define myADC_DMA_BUF_SIZE 100              /* ADC DMAɼ BUFС */
 uint16_t g_adc_dma_buf[myADC_DMA_BUF_SIZE]; /* ADC DMA BUF */
 extern uint8_t g_adc_dma_start;             /* DMA״̬־, 0,δ; 1,  */
+uint8_t g_report_cnt = 0;                   /* Ѵݿ,  myPROF_REPORT_PERIOD һң֡ */
+uint8_t g_adc_busy = 0;                     /* ڲɼһ */
+uint16_t g_adc_block_len = 0;               /* ڲɼݵĵ */
+uint32_t g_adc_block_tick = 0;              /* һɼʱ, ms */
 
 int main(void)
 	{
     HAL_Init();                         /* ʼ HAL */
-    sys_stm32_clock_init(RCC_PLL_MUL9); /* ʱ, 72Mhz */
-    delay_init(72);                     /* ʼ ʱ */
-    usart_init(115200);                 /* ʼ ڣʺʵʱ¼ADCƵʳ */
+    sys_stm32_clock_init(myCFG_RCC_PLL_MUL); /* ʱ, 72Mhz */
+    delay_init(myCFG_SYSCLK / 1000000);      /* ʼ ʱ */
+    myLINK_init();                      /* ʼ λ·(ڻUSB,  myLINK.h)ڲʺʵʱ¼ADCƵʳ */
     led_init();                         /* ʼ ϵLED */
+    myPROF_init();                      /* ʼ DWTڼ, ͳ */
 
     myTIME_Init();                            /* ʼ ʱʱ(1s) */
-    myPWM_init(100 - 1, 72 - 1);              /* ʼ PWM */
+    myPWM_init(myCFG_PWM_ARR, myCFG_PWM_PSC); /* ʼ PWM, Ƶʺռձȼ myCFG.h */
     myEXTI_init();                            /* ʼ ж */
     myADC_DMA_init((uint32_t)&g_adc_dma_buf); /* ʼ myADC_DMA */
-    myADC_DMA_enable(myADC_DMA_BUF_SIZE);     /* һADC DMAɼ */
+    myCMD_init();                             /* ʼ λ */
+
+    if (myTUNE_get_auto())
+    {
+        myTUNE_request(myTUNE_REASON_START); /* һݴʱƽ */
+    }
+
+#if myTASK_RTOS
+    myTASK_start(); /* ѭ,  */
+#endif
+    g_adc_block_len = g_mycmd_cfg.avg_depth;
+    g_adc_block_tick = HAL_GetTick();
+    g_adc_busy = 1;
+    myADC_DMA_enable(g_adc_block_len); /* һADC DMAɼ */
 
     // uint32_t current_time_ms = HAL_GetTick(); // ȡǰʱ䣬λms
     // uint32_t current_time_us = GetElapsedTime();
 
     while (1)
     {
+        myCMD_poll(); /* ִλ, ޸ĵôһݿʼЧ */
+
+        // ɨƵɼ: ָPWM, Ƶ׼¼
+        if (g_adc_dma_start == 1 && mySWEEP_running())
+        {
+            mySWEEP_finish();
+            g_adc_dma_start = 0;
+            g_adc_busy = 0;
+        }
+
+        // һɼ: ͳƺһ, ȫʱӦ
+        if (g_adc_dma_start == 1 && myTUNE_running())
+        {
+            g_adc_dma_start = 0;
+            g_adc_busy = myTUNE_step();
+        }
+
         // ȴDMA
         if (g_adc_dma_start == 1)
         {
+            myPROF_BEGIN(myPROF_STAGE_LOOP);
+
             // ݴ
-            adc_value = 0;
-            for (uint8_t i = 0; i < myADC_DMA_BUF_SIZE; i++)
+            myPROF_BEGIN(myPROF_STAGE_AVERAGE);
+            adc_sum = 0;
+            for (uint16_t i = 0; i < g_adc_block_len; i++)
             {
-                adc_value += g_adc_dma_buf[i];
+                adc_sum += g_adc_dma_buf[i];
             }
-            adc_value /= myADC_DMA_BUF_SIZE; // ֵ
+            adc_value = adc_sum / g_adc_block_len; // ֵ
+            myPROF_END(myPROF_STAGE_AVERAGE);
 
+            myPROF_BEGIN(myPROF_STAGE_CONVERT);
             voltage = (float)adc_value * (3.3f / 4096);
             R = (3.26 - voltage) * 4.96 / voltage;
+            myPROF_END(myPROF_STAGE_CONVERT);
+            valid_flags = myVALID_sample(HAL_GetTick(), adc_sum, g_adc_block_len, R); /* ·//ȺȻ, ״̬仯ʱ͹֡ */
+            if (!valid_flags)
+            {
+                myTUNE_track(R); /* ֵԽʮʱ */
+            }
+
+            if (myLINK_tx_busy())
+            {
+                myPROF_uart_backlog(); /* һηδ */
+            }
+
+            myPROF_BEGIN(myPROF_STAGE_PRINTF);
+            if (!myVALID_output(valid_flags))
+            {
+                /* DROP: 㲻 */
+            }
+            else if (g_mycmd_cfg.stream == myCMD_STREAM_TEXT)
+            {
+                if (valid_flags)
+                {
+                    myLINK_printf("%.4f !%02X\n", R, valid_flags); /* TAG: ӱ־ */
+                }
+                else
+                {
+                    myLINK_printf("%.4f\n", R);
+                }
+            }
+            else if (g_mycmd_cfg.stream == myCMD_STREAM_FRAME)
+            {
+                uint8_t payload[13], *p = payload;
+                uint32_t r_bits;
+
+                memcpy(&r_bits, &R, sizeof(r_bits)); // float  IEEE754 λģʽ
+                p = myFRAME_put_u32(p, HAL_GetTick());
+                p = myFRAME_put_u16(p, (uint16_t)adc_value);
+                p = myFRAME_put_u16(p, g_adc_block_len);
+                p = myFRAME_put_u32(p, r_bits);
+                *p++ = valid_flags;
+                myFRAME_send(myFRAME_TYPE_SAMPLE, payload, (uint16_t)(p - payload));
+            }
+            myPROF_END(myPROF_STAGE_PRINTF);
+
+            myPROF_BEGIN(myPROF_STAGE_UART_TX);
+            myLINK_tx_wait(); /* ȴͽ */
+            myPROF_END(myPROF_STAGE_UART_TX);
+
+            myPROF_END(myPROF_STAGE_LOOP);
+            if (++g_report_cnt >= myPROF_REPORT_PERIOD)
+            {
+                g_report_cnt = 0;
+                myPROF_report(); /* ң֡, ıݷֿ */
+            }
+
+            g_adc_dma_start = 0; /* DMAɼ״̬־ */
+            g_adc_busy = 0;
+            LED0_TOGGLE();
+        }
+
+        // ɨƵʱ֮
+        if (!g_adc_busy && mySWEEP_pending())
+        {
+            g_adc_busy = 1;
+            mySWEEP_start();
+        }
+
+        // ʱ֮
+        if (!g_adc_busy && myTUNE_pending())
+        {
+            g_adc_busy = 1;
+            myTUNE_start();
+        }
 
-            printf("%.4f\n", R);
-            HAL_UART_Transmit(&g_uart1_handle, (uint8_t *)g_usart_rx_buf, len, 1000); /* ͽյ */
-            while (__HAL_UART_GET_FLAG(&g_uart1_handle, UART_FLAG_TC) != SET)
-                ; /* ȴͽ */
+        // ԭʼʱ֮, ֮ͨݿ
+        if (!g_adc_busy && myRAW_pending())
+        {
+            myRAW_start();
+        }
 
-            g_adc_dma_start = 0;                  /* DMAɼ״̬־ */
-            myADC_DMA_enable(myADC_DMA_BUF_SIZE); /* һADC DMAɼ */
+        // ÿ period_ms ʼһβɼ, ȴڼܼʱӦ
+        if (!g_adc_busy && !myRAW_busy() && HAL_GetTick() - g_adc_block_tick >= g_mycmd_cfg.period_ms)
+        {
+            g_adc_block_tick = HAL_GetTick();
+            g_adc_block_len = g_mycmd_cfg.avg_depth;
+            g_adc_busy = 1;
+            myADC_DMA_enable(g_adc_block_len); /* һADC DMAɼ */
         }
 
-        LED0_TOGGLE();
-        delay_ms(1000); // ÿ30뿪ʼһβɼ
+        __WFI(); /* ȴж(SysTick ÿ1msһ), ԭ delay_ms ת */
     }
 }
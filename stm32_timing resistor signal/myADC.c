@@ -13,12 +13,23 @@
  */
 
 #include "myADC.h"
+#include "myPROF.h"
+#include "myTASK.h"
+#include "myRAW.h"
 
 /***************************************ͨADCɼ(DMAȡ)*****************************************/
 
 DMA_HandleTypeDef g_dma_adc_handle = {0}; // DMA
 ADC_HandleTypeDef g_adc_dma_handle = {0}; // ADC
 uint8_t g_adc_dma_start = 0;              // DMA״̬־, 0,δ; 1, 
+uint32_t g_myadc_rate = myCFG_ADC_RATE; // ǰת, ʼʱ myCFG_ADC_SMP
+
+/* ʱ(λ: ADC),  ADC_SAMPLETIME_1CYCLE_5 ~ ADC_SAMPLETIME_239CYCLES_5 Ӧ */
+static const uint16_t g_adc_smp_half_cycles[8] = {
+    myCFG_ADC_SMP_HALF(0), myCFG_ADC_SMP_HALF(1), myCFG_ADC_SMP_HALF(2), myCFG_ADC_SMP_HALF(3),
+    myCFG_ADC_SMP_HALF(4), myCFG_ADC_SMP_HALF(5), myCFG_ADC_SMP_HALF(6), myCFG_ADC_SMP_HALF(7)};
+static uint8_t g_adc_smp = myCFG_ADC_SMP; /* ǰʱ䵵λ */
+static uint32_t g_adc_dma_mar = 0; /* ʼʱĴ洢ַ, ѭƽõĻ */
 
 /**
  * @brief       ADC DMAȡ ʼ
@@ -47,7 +58,7 @@ void myADC_DMA_init(uint32_t mar)
 
     /* ADCʱ */
     adc_clk_init.PeriphClockSelection = RCC_PERIPHCLK_ADC; /* ADCʱ */
-    adc_clk_init.AdcClockSelection = RCC_ADCPCLK2_DIV6;    /* Ƶ6ʱΪ72M/6=12MHz */
+    adc_clk_init.AdcClockSelection = myCFG_ADC_PRESC;      /* 14MHzСƵ, 72M/6=12MHz */
     HAL_RCCEx_PeriphCLKConfig(&adc_clk_init);              /* ADCʱ */
 
     /* ADɼͨӦIOŹģʽ */
@@ -83,13 +94,17 @@ void myADC_DMA_init(uint32_t mar)
     /* ADCͨ */
     adc_ch_conf.Channel = myADC_ADCX_CHY;                   /* ͨ */
     adc_ch_conf.Rank = ADC_REGULAR_RANK_1;                  /*  */
-    adc_ch_conf.SamplingTime = ADC_SAMPLETIME_239CYCLES_5;  /* ʱ䣬:239.5ADC */
+    adc_ch_conf.SamplingTime = myCFG_ADC_SMP;               /* ʱ䵵λ,  ADC_SAMPLETIME_xCYCLES_5 ֵͬ */
     HAL_ADC_ConfigChannel(&g_adc_dma_handle, &adc_ch_conf); /* ͨ */
 
     /* DMAжȼ */
     HAL_NVIC_SetPriority(myADC_ADCX_DMACx_IRQn, 3, 3);
     HAL_NVIC_EnableIRQ(myADC_ADCX_DMACx_IRQn);
 
+    g_adc_smp = myCFG_ADC_SMP;
+    myPROF_set_conv_cycles(myADC_conv_cycles()); /* жӳͳưǰʱ DMA ʱ */
+
+    g_adc_dma_mar = mar;
     HAL_DMA_Start_IT(&g_dma_adc_handle, (uint32_t)&ADC1->DR, mar, 0); /* DMAж */
     HAL_ADC_Start_DMA(&g_adc_dma_handle, &mar, 0);                    /* ADCͨDMA */
 }
@@ -101,6 +116,19 @@ void myADC_DMA_init(uint32_t mar)
  * @retval      
  */
 void myADC_DMA_enable(uint16_t cndtr)
+{
+    myADC_DMA_enable_buf(g_adc_dma_mar, cndtr);
+}
+
+/**
+ * @brief       ʹһADC DMA, дָ
+ *   @note      ɨƵҪ myADC_DMA_BUF_SIZE Ĳɼ; ֮ myADC_DMA_enable()
+ *              ָʼʱĻ
+ * @param       mar  : 洢ַ
+ * @param       cndtr: DMAĴ
+ * @retval      
+ */
+void myADC_DMA_enable_buf(uint32_t mar, uint16_t cndtr)
 {
     // üĴ
     myADC_ADCX->CR2 &= ~(1 << 0); // ر ADCX
@@ -108,9 +136,12 @@ void myADC_DMA_enable(uint16_t cndtr)
     myADC_ADCX_DMACx->CCR &= ~(1 << 0); // ر DMA 
     while (myADC_ADCX_DMACx->CCR & (1 << 0))
         ;                            // ȴ DMA ͨx ȫʧܣȷDMAԱ
+    myADC_ADCX_DMACx->CMAR = mar;    //  DMA Ĵ洢ַ
     myADC_ADCX_DMACx->CNDTR = cndtr; //  DMA ݴͨβ cndtr ݣ
     myADC_ADCX_DMACx->CCR |= 1 << 0; //  DMA 
 
+    myPROF_dma_start(cndtr); // ¼ʱ, ͳжϽӳ; ת, ƽʱжϿܽŵ
+
     myADC_ADCX->CR2 |= 1 << 0;  //  ADC
     myADC_ADCX->CR2 |= 1 << 22; // תͨ
 }
@@ -122,9 +153,92 @@ void myADC_DMA_enable(uint16_t cndtr)
  */
 void myADC_ADCX_DMACx_IRQHandler(void)
 {
+    uint32_t now = myPROF_CYCCNT(); // жϵʱ
+
+    if (myRAW_running())
+    {
+        myRAW_adc_irq(); // ԭʼ: /ȫʱ DMA 
+        return;
+    }
+
     if (myADC_ADCX_DMACx_IS_TC())
     {
+        myPROF_isr_entry(now, g_adc_dma_start); // һδһ, Ϊ
         g_adc_dma_start = 1;       // DMA
         myADC_ADCX_DMACx_CLR_TC(); // жϱ־λIFCRĴӦλ 1
+#if myTASK_RTOS
+        myTASK_notify_isr(myTASK_EVT_ADC, now); // Ѳɼ
+#endif
+    }
+}
+
+/**
+ * @brief       Ĳѡʱ
+ *   @note      ת = ADCʱ / (ʱ + 12.5);
+ *              ѡܴﵽʵʱ(ݳ), ʳʱ̲ʱ
+ *              239.5 ~ 1.5 ڶӦԼ 47.6k ~ 857k /
+ * @param       rate: Ĳ, /
+ * @retval      ʵʲ, /
+ */
+uint32_t myADC_set_rate(uint32_t rate)
+{
+    uint8_t smp = 7;
+
+    while (smp > 0 && myADC_smp_rate(smp) < rate)
+    {
+        smp--;
     }
+    return myADC_set_smp(smp);
+}
+
+/**
+ * @brief       òʱ䵵λ
+ * @param       smp: 0 ~ 7, Ӧ ADC_SAMPLETIME_1CYCLE_5 ~ ADC_SAMPLETIME_239CYCLES_5
+ * @retval      ʵʲ, /
+ */
+uint32_t myADC_set_smp(uint8_t smp)
+{
+    ADC_ChannelConfTypeDef adc_ch_conf = {0};
+
+    adc_ch_conf.Channel = myADC_ADCX_CHY;
+    adc_ch_conf.Rank = ADC_REGULAR_RANK_1;
+    adc_ch_conf.SamplingTime = ADC_SAMPLETIME_1CYCLE_5 + smp; /* 8ʱı */
+    HAL_ADC_ConfigChannel(&g_adc_dma_handle, &adc_ch_conf); /* һתʼЧ */
+
+    g_adc_smp = smp;
+    g_myadc_rate = myADC_smp_rate(smp);
+    myPROF_set_conv_cycles(myADC_conv_cycles());
+    return g_myadc_rate;
+}
+
+/**
+ * @brief       ǰʱ䵵λ
+ * @param       
+ * @retval      0 ~ 7
+ */
+uint8_t myADC_get_smp(void)
+{
+    return g_adc_smp;
+}
+
+/**
+ * @brief       ĳʱµת
+ * @param       smp: 0 ~ 7
+ * @retval      , /
+ */
+uint32_t myADC_smp_rate(uint8_t smp)
+{
+    return myADC_CLK * 2 / (g_adc_smp_half_cycles[smp] + 25);
+}
+
+/**
+ * @brief       ǰʱµתĺʱ
+ *   @note      (ʱ + 12.5)ADC  myCFG_ADC_DIV Ƶ,    myCFG_ADC_DIV / 2;
+ *              72MHz6Ƶ239.5 ʱΪ 1512
+ * @param       
+ * @retval      תʱ, CPU
+ */
+uint16_t myADC_conv_cycles(void)
+{
+    return (g_adc_smp_half_cycles[g_adc_smp] + 25) * myCFG_ADC_DIV / 2;
 }
@@ -17,6 +17,7 @@
 #include "./SYSTEM/sys/sys.h"
 #include "./SYSTEM/delay/delay.h"
 #include "myTIME.h"
+#include "myCFG.h"
 
 /******************************************************************************************/
 /* ADC  */
@@ -55,10 +56,21 @@
         DMA1->IFCR |= 1 << 1;     \
     } while (0) /*  DMA1_Channel1 ɱ־ */
 
+#define myADC_DMA_BUF_SIZE myCFG_ADC_DMA_SIZE /* ADC DMAɼ BUFС, Ҳƽ */
+#define myADC_CLK myCFG_ADC_CLK               /* ADCʱ, Hz: 72M / 6 */
+
 /******************************************************************************************/
 /* ⲿӿں*/
 
+extern uint32_t g_myadc_rate; /* ǰת, / */
+
 void myADC_DMA_init(uint32_t mar);     // ADC DMA ʼ
 void myADC_DMA_enable(uint16_t cndtr); // ʹһADC DMAɼ
+void myADC_DMA_enable_buf(uint32_t mar, uint16_t cndtr); // ʹһADC DMAɼ, дָ
+uint32_t myADC_set_rate(uint32_t rate); // Ĳѡʱ, ʵʲ
+uint32_t myADC_set_smp(uint8_t smp);    // òʱ䵵λ(0~7), ʵʲ
+uint8_t myADC_get_smp(void);            // ǰʱ䵵λ
+uint32_t myADC_smp_rate(uint8_t smp);   // ĳʱµת
+uint16_t myADC_conv_cycles(void);       // ǰʱµתCPU
 
 #endif
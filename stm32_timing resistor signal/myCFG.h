@@ -0,0 +1,193 @@
+/**
+ ****************************************************************************************************
+ * @file        myCFG.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * ɼıʱ: ֻдĿֵ(PWM Ƶʡʱ䵵λƽϱڡ),
+ * ԤƵϵװֵADC ʱӷƵDMA 泤ȶɺƵ, ǳ, ʱûж⿪;
+ * (ADC ʱӳ 14MHzPWM ƵһݵĲɼʱ䳬ϱڡ
+ * ڴ)ڱʱ #error , ȵϲŷ
+ *
+ * myCFG_SENSOR ѡ񴫸Ԥ; Ҳڱ -D ( myTASK_RTOSmyLINK_USB ͬ),
+ *  -DmyCFG_SENSOR=1 -DmyCFG_ADC_AVG=128
+ * λ(PWM/RATE/AVG/PERIOD)ԶʱԿ޸, ϵʱ״̬ͻС
+ *
+ * ļֻʽ,  HAL,  PC ֱӼƵ(sim Ŀ¼ make check-config)
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef _MYCFG_H
+#define _MYCFG_H
+
+#ifndef myCFG_SENSOR
+#define myCFG_SENSOR 0 /* 0, ; 1,  */
+#endif
+
+/******************************************************************************************/
+/* Ԥ */
+
+#if myCFG_SENSOR == 0
+/* : Ӧ(M ), Ĳʱòݳ */
+#define myCFG_SENSOR_PWM_FREQ 10000 /* ϵʱ PWM Ƶ, Hz */
+#define myCFG_SENSOR_ADC_SMP 7      /* 239.5  */
+#define myCFG_SENSOR_ADC_AVG 100    /* ÿƽ */
+#define myCFG_SENSOR_REPORT_MS 1000 /* ϱ */
+#elif myCFG_SENSOR == 1
+/*  + Ŵ: 迹͡Ӧ, ̲ʱ任ȡ */
+#define myCFG_SENSOR_PWM_FREQ 100000
+#define myCFG_SENSOR_ADC_SMP 2      /* 13.5  */
+#define myCFG_SENSOR_ADC_AVG 256
+#define myCFG_SENSOR_REPORT_MS 100
+#else
+#error "myCFG_SENSOR ֻ 0  1"
+#endif
+
+#ifndef myCFG_PWM_FREQ
+#define myCFG_PWM_FREQ myCFG_SENSOR_PWM_FREQ
+#endif
+#ifndef myCFG_PWM_DUTY
+#define myCFG_PWM_DUTY 500 /* ϵʱռձ, ǧֱ */
+#endif
+#ifndef myCFG_ADC_SMP
+#define myCFG_ADC_SMP myCFG_SENSOR_ADC_SMP
+#endif
+#ifndef myCFG_ADC_AVG
+#define myCFG_ADC_AVG myCFG_SENSOR_ADC_AVG
+#endif
+#ifndef myCFG_REPORT_MS
+#define myCFG_REPORT_MS myCFG_SENSOR_REPORT_MS
+#endif
+#ifndef myCFG_UART_BAUD
+#define myCFG_UART_BAUD 115200
+#endif
+
+/* л PWM Ƶ */
+#define myCFG_KEY1_PWM_FREQ 10000
+#define myCFG_WKUP_PWM_FREQ 5000
+
+/******************************************************************************************/
+/* ʱ: HSE 8MHz, PLL 9 Ƶ; APB1 2 Ƶ, ϵĶʱʱӼӱ */
+
+#define myCFG_HSE 8000000
+#define myCFG_PLL_MUL 9
+#define myCFG_SYSCLK (myCFG_HSE * myCFG_PLL_MUL)
+#define myCFG_PCLK1 (myCFG_SYSCLK / 2)
+#define myCFG_PCLK2 myCFG_SYSCLK
+#define myCFG_TIM_CLK (myCFG_PCLK1 * 2) /* TIM2~TIM7 */
+#define myCFG_TIM1_CLK myCFG_PCLK2      /* TIM1  APB2  */
+#define myCFG_CAT_(a, b) a##b
+#define myCFG_CAT(a, b) myCFG_CAT_(a, b)
+#define myCFG_RCC_PLL_MUL myCFG_CAT(RCC_PLL_MUL, myCFG_PLL_MUL) /* sys_stm32_clock_init Ĳ */
+
+/******************************************************************************************/
+/* ADC: ʱȡ 14MHz СƵ; תһ = ʱ + 12.5  ADC  */
+
+#define myCFG_ADC_CLK_MAX 14000000
+#define myCFG_ADC_DIV (myCFG_PCLK2 / 2 <= myCFG_ADC_CLK_MAX   ? 2 \
+                       : myCFG_PCLK2 / 4 <= myCFG_ADC_CLK_MAX ? 4 \
+                       : myCFG_PCLK2 / 6 <= myCFG_ADC_CLK_MAX ? 6 \
+                                                              : 8)
+#define myCFG_ADC_CLK (myCFG_PCLK2 / myCFG_ADC_DIV)
+#define myCFG_ADC_PRESC (myCFG_ADC_DIV == 2 ? RCC_ADCPCLK2_DIV2 \
+                         : myCFG_ADC_DIV == 4 ? RCC_ADCPCLK2_DIV4 \
+                         : myCFG_ADC_DIV == 6 ? RCC_ADCPCLK2_DIV6 \
+                                              : RCC_ADCPCLK2_DIV8)
+
+/* ʱ䵵λ smp(0~7) ӦİADC,  ADC_SAMPLETIME_1CYCLE_5 ~ ADC_SAMPLETIME_239CYCLES_5 Ӧ */
+#define myCFG_ADC_SMP_HALF(smp) ((smp) == 0 ? 3 : (smp) == 1 ? 15 : (smp) == 2 ? 27 : (smp) == 3 ? 57 \
+                                 : (smp) == 4 ? 83 : (smp) == 5 ? 111 : (smp) == 6 ? 143 : 479)
+#define myCFG_ADC_RATE (myCFG_ADC_CLK * 2 / (myCFG_ADC_SMP_HALF(myCFG_ADC_SMP) + 25)) /* / */
+#define myCFG_ADC_CONV_CYCLES ((myCFG_ADC_SMP_HALF(myCFG_ADC_SMP) + 25) * myCFG_ADC_DIV / 2) /* תʱ, CPU(CPU  APB2 ͬƵ) */
+#define myCFG_ADC_DMA_SIZE myCFG_ADC_AVG                                           /* DMA  = ƽ */
+#define myCFG_BLOCK_US ((myCFG_ADC_AVG * 1000000 + myCFG_ADC_RATE - 1) / myCFG_ADC_RATE) /* ɼһʱ */
+
+/******************************************************************************************/
+/* ʱ:  myPWM_set_freq() ͬ, ȡʹװֵ 65535 СƵϵ */
+
+#define myCFG_PWM_PSC_OF(f) ((myCFG_TIM_CLK / (f) - 1) / 65536)
+#define myCFG_PWM_ARR_OF(f) (myCFG_TIM_CLK / (f) / (myCFG_PWM_PSC_OF(f) + 1) - 1)
+#define myCFG_PWM_REAL_OF(f) (myCFG_TIM_CLK / (myCFG_PWM_PSC_OF(f) + 1) / (myCFG_PWM_ARR_OF(f) + 1))
+#define myCFG_PWM_PSC myCFG_PWM_PSC_OF(myCFG_PWM_FREQ)
+#define myCFG_PWM_ARR myCFG_PWM_ARR_OF(myCFG_PWM_FREQ)
+
+#define myCFG_TIME_HZ 1000000                          /* myTIME Ƶ: 1s */
+#define myCFG_TIME_PSC (myCFG_TIM_CLK / myCFG_TIME_HZ - 1)
+#define myCFG_TIME_ARR 999                             /* 1ms һ */
+#define myCFG_DEBOUNCE_HZ 10000                        /* ʱƵ */
+#define myCFG_DEBOUNCE_PSC (myCFG_TIM_CLK / myCFG_DEBOUNCE_HZ - 1)
+
+/******************************************************************************************/
+/* ʱ */
+
+#define myCFG_PWM_ERR_PERMIL 5  /* PWM Ƶ, ǧֱ */
+#define myCFG_PWM_STEPS_MIN 100 /* һٵļֵ, ռձȷֱʲ 1% */
+#define myCFG_PWM_INEXACT(f) ((myCFG_PWM_REAL_OF(f) - (f)) * 1000 > (f) * myCFG_PWM_ERR_PERMIL || \
+                              ((f) - myCFG_PWM_REAL_OF(f)) * 1000 > (f) * myCFG_PWM_ERR_PERMIL)
+#define myCFG_BLOCK_RATE_MAX 2000 /* ɼ(PERIOD 0)ʱÿ봦Ŀ: DMA ж + ѭƽԤ */
+#define myCFG_DMA_RAM_MAX 4096  /* ADC DMA ռõ RAM , ֽ */
+#define myCFG_TEXT_LINE_MAX 12  /* һı󳤶, ֽ */
+#define myCFG_LINK_USE 50       /* ıռôڴİٷֱ, Ӧң֡ */
+
+#if myCFG_SYSCLK > 72000000 || myCFG_PCLK1 > 36000000
+#error "ϵͳʱӳ 72MHz  APB1  36MHz"
+#endif
+
+#if myCFG_ADC_CLK > myCFG_ADC_CLK_MAX || myCFG_ADC_CLK < 600000
+#error "ADC ʱӱ 0.6~14MHz ֮"
+#endif
+
+#if myCFG_ADC_SMP < 0 || myCFG_ADC_SMP > 7
+#error "myCFG_ADC_SMP ֻ 0~7"
+#endif
+
+#if myCFG_ADC_AVG < 2 || myCFG_ADC_AVG > 65535 || myCFG_ADC_AVG % 2
+#error "myCFG_ADC_AVG  2~65535 ֮ż(DMA  16 λ; ԭʼ淢)"
+#endif
+
+#if myCFG_ADC_DMA_SIZE * 2 > myCFG_DMA_RAM_MAX
+#error "ADC DMA 泬 myCFG_DMA_RAM_MAX"
+#endif
+
+#if myCFG_BLOCK_US > myCFG_REPORT_MS * 1000
+#error "ɼһݵʱ䳬ϱ, С myCFG_ADC_AVG ̲ʱ"
+#endif
+
+#if myCFG_ADC_RATE / myCFG_ADC_AVG > myCFG_BLOCK_RATE_MAX
+#error "ɼʱÿĿ myCFG_BLOCK_RATE_MAX,  myCFG_ADC_AVG ӳʱ"
+#endif
+
+#if myCFG_PWM_FREQ < 2 || myCFG_PWM_FREQ > myCFG_TIM_CLK / myCFG_PWM_STEPS_MIN || myCFG_PWM_DUTY > 1000
+#error "PWM ƵʳΧռձȴ 1000"
+#endif
+
+#if myCFG_PWM_INEXACT(myCFG_PWM_FREQ)
+#error "myCFG_PWM_FREQ ڶʱʱµ myCFG_PWM_ERR_PERMIL"
+#endif
+
+#if myCFG_PWM_INEXACT(myCFG_KEY1_PWM_FREQ) || myCFG_PWM_INEXACT(myCFG_WKUP_PWM_FREQ)
+#error "л PWM Ƶ myCFG_PWM_ERR_PERMIL"
+#endif
+
+#if myCFG_TIM_CLK % myCFG_TIME_HZ || myCFG_TIME_PSC > 65535 || myCFG_TIM_CLK % myCFG_DEBOUNCE_HZ || myCFG_DEBOUNCE_PSC > 65535
+#error "ʱʱӲֳ myTIME ʱļƵ"
+#endif
+
+/* USART1  APB2 , 16 : BRR = PCLK2 / (),  2% ն˻ */
+#define myCFG_UART_BRR ((myCFG_PCLK2 + myCFG_UART_BAUD / 2) / myCFG_UART_BAUD)
+#if myCFG_UART_BRR < 16 || (myCFG_PCLK2 / myCFG_UART_BRR - myCFG_UART_BAUD) * 50 > myCFG_UART_BAUD || \
+    (myCFG_UART_BAUD - myCFG_PCLK2 / myCFG_UART_BRR) * 50 > myCFG_UART_BAUD
+#error "myCFG_UART_BAUD  APB2 ʱµ 2%"
+#endif
+
+#if myCFG_TEXT_LINE_MAX * 10 * 1000 / myCFG_REPORT_MS > myCFG_UART_BAUD * myCFG_LINK_USE / 100
+#error "ϱ̫, ıڴ myCFG_LINK_USE%"
+#endif
+
+#endif
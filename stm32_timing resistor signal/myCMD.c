@@ -0,0 +1,683 @@
+/**
+ ****************************************************************************************************
+ * @file        myCMD.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ ****************************************************************************************************
+ */
+
+#include "myCMD.h"
+
+/***************************************ƴӺ*****************************************/
+
+static const char *const g_mycmd_err_str[] = {"OK", "ERR UNKNOWN", "ERR ARG", "ERR RANGE", "ERR LONG", "ERR BUSY"};
+
+/**
+ * @brief       һֽ, ƴһ
+ *   @note      '\r'  '\n' Ϊн, к;  myCMD_LINE_MAX ж
+ * @param       line: ƴ״̬
+ * @param       c   : յֽ
+ * @retval      myCMD_LINE_PENDING / myCMD_LINE_READY / myCMD_LINE_TOO_LONG
+ */
+uint8_t myCMD_line_push(myCMD_LINE *line, uint8_t c)
+{
+    if (c == '\r' || c == '\n')
+    {
+        uint8_t ret = line->overflow ? myCMD_LINE_TOO_LONG : (line->len ? myCMD_LINE_READY : myCMD_LINE_PENDING);
+
+        line->buf[line->len] = '\0';
+        line->len = 0;
+        line->overflow = 0;
+        return ret;
+    }
+
+    if (line->len >= myCMD_LINE_MAX)
+    {
+        line->overflow = 1;
+    }
+    else
+    {
+        line->buf[line->len++] = (char)c;
+    }
+    return myCMD_LINE_PENDING;
+}
+
+/* ոƱ */
+static const char *myCMD_skip_space(const char *p)
+{
+    while (*p == ' ' || *p == '\t')
+    {
+        p++;
+    }
+    return p;
+}
+
+/**
+ * @brief       ȡһʲתΪд
+ * @param       p   : ȡλ
+ * @param       word: ,  size
+ * @param       size: 泤
+ * @retval      ֮λ; ʳʱ NULL
+ */
+static const char *myCMD_get_word(const char *p, char *word, uint8_t size)
+{
+    uint8_t n = 0;
+
+    p = myCMD_skip_space(p);
+    while (*p && *p != ' ' && *p != '\t')
+    {
+        if (n + 1 >= size)
+        {
+            return 0;
+        }
+        word[n++] = (*p >= 'a' && *p <= 'z') ? (char)(*p - 'a' + 'A') : *p;
+        p++;
+    }
+    word[n] = '\0';
+    return p;
+}
+
+/**
+ * @brief       תʮ޷
+ * @param       word: 
+ * @param       v   : 
+ * @retval      0, ɹ; 1, ֻ򳬳32λ
+ */
+static uint8_t myCMD_to_u32(const char *word, uint32_t *v)
+{
+    uint32_t x = 0;
+
+    if (*word == '\0')
+    {
+        return 1;
+    }
+    while (*word)
+    {
+        if (*word < '0' || *word > '9' || x > (0xFFFFFFFFUL - (uint32_t)(*word - '0')) / 10)
+        {
+            return 1;
+        }
+        x = x * 10 + (uint32_t)(*word - '0');
+        word++;
+    }
+    *v = x;
+    return 0;
+}
+
+/* ַ */
+static uint8_t myCMD_equal(const char *a, const char *b)
+{
+    while (*a && *a == *b)
+    {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+/**
+ * @brief       һ
+ *   @note      ֻ﷨Ͳ; ֵΧӲй, ִʱ.
+ *              MODE Ĳ myCMD_STREAM 롢TUNE Ĳ myCMD_TUNE_MODE 롢
+ *              VALID Ĳ myCMD_VALID_MODE  arg[0]
+ * @param       text: һ,  '\0' β
+ * @param       req : 
+ * @retval      myCMD_OK 
+ */
+myCMD_ERR myCMD_parse(const char *text, myCMD_REQ *req)
+{
+    char word[12];
+    const char *p = text;
+    uint8_t max_args, min_args;
+
+    req->id = myCMD_ID_NONE;
+    req->argc = 0;
+    req->arg[0] = 0;
+    req->arg[1] = 0;
+    req->arg[2] = 0;
+
+    p = myCMD_get_word(p, word, sizeof(word));
+    if (!p)
+    {
+        return myCMD_ERR_UNKNOWN;
+    }
+
+    if (myCMD_equal(word, "PWM"))
+    {
+        req->id = myCMD_ID_PWM;
+        min_args = 1;
+        max_args = 2;
+    }
+    else if (myCMD_equal(word, "RATE"))
+    {
+        req->id = myCMD_ID_RATE;
+        min_args = max_args = 1;
+    }
+    else if (myCMD_equal(word, "AVG"))
+    {
+        req->id = myCMD_ID_AVG;
+        min_args = max_args = 1;
+    }
+    else if (myCMD_equal(word, "PERIOD"))
+    {
+        req->id = myCMD_ID_PERIOD;
+        min_args = max_args = 1;
+    }
+    else if (myCMD_equal(word, "MODE"))
+    {
+        req->id = myCMD_ID_MODE;
+        min_args = max_args = 1;
+    }
+    else if (myCMD_equal(word, "STATUS"))
+    {
+        req->id = myCMD_ID_STATUS;
+        min_args = max_args = 0;
+    }
+    else if (myCMD_equal(word, "SWEEP"))
+    {
+        req->id = myCMD_ID_SWEEP;
+        min_args = 0;
+        max_args = 3;
+    }
+    else if (myCMD_equal(word, "TUNE"))
+    {
+        req->id = myCMD_ID_TUNE;
+        min_args = 0;
+        max_args = 1;
+    }
+    else if (myCMD_equal(word, "VALID"))
+    {
+        req->id = myCMD_ID_VALID;
+        min_args = 0;
+        max_args = 1;
+    }
+    else
+    {
+        return myCMD_ERR_UNKNOWN;
+    }
+
+    while (1)
+    {
+        uint32_t v;
+
+        p = myCMD_get_word(p, word, sizeof(word));
+        if (!p)
+        {
+            return myCMD_ERR_ARG;
+        }
+        if (word[0] == '\0')
+        {
+            break; /* β */
+        }
+        if (req->argc >= max_args)
+        {
+            return myCMD_ERR_ARG;
+        }
+
+        if (req->id == myCMD_ID_MODE)
+        {
+            if (myCMD_equal(word, "TEXT"))
+            {
+                v = myCMD_STREAM_TEXT;
+            }
+            else if (myCMD_equal(word, "FRAME"))
+            {
+                v = myCMD_STREAM_FRAME;
+            }
+            else if (myCMD_equal(word, "OFF"))
+            {
+                v = myCMD_STREAM_OFF;
+            }
+            else if (myCMD_equal(word, "RAW"))
+            {
+                v = myCMD_STREAM_RAW;
+            }
+            else
+            {
+                return myCMD_ERR_ARG;
+            }
+        }
+        else if (req->id == myCMD_ID_TUNE)
+        {
+            if (myCMD_equal(word, "AUTO"))
+            {
+                v = myCMD_TUNE_AUTO;
+            }
+            else if (myCMD_equal(word, "OFF"))
+            {
+                v = myCMD_TUNE_OFF;
+            }
+            else
+            {
+                return myCMD_ERR_ARG;
+            }
+        }
+        else if (req->id == myCMD_ID_VALID)
+        {
+            if (myCMD_equal(word, "TAG"))
+            {
+                v = myCMD_VALID_TAG;
+            }
+            else if (myCMD_equal(word, "DROP"))
+            {
+                v = myCMD_VALID_DROP;
+            }
+            else if (myCMD_equal(word, "OFF"))
+            {
+                v = myCMD_VALID_OFF;
+            }
+            else
+            {
+                return myCMD_ERR_ARG;
+            }
+        }
+        else if (req->id == myCMD_ID_PWM && req->argc == 0 && myCMD_equal(word, "OFF"))
+        {
+            req->id = myCMD_ID_PWM_OFF; /* PWM OFF ٽ */
+            max_args = 0;
+            continue;
+        }
+        else if (myCMD_to_u32(word, &v))
+        {
+            return myCMD_ERR_ARG;
+        }
+
+        req->arg[req->argc++] = v;
+    }
+
+    if (req->id != myCMD_ID_PWM_OFF && req->argc < min_args)
+    {
+        return myCMD_ERR_ARG;
+    }
+    if (req->id == myCMD_ID_SWEEP && req->argc == 1)
+    {
+        return myCMD_ERR_ARG; /* ֹƵɶԸ */
+    }
+    return myCMD_OK;
+}
+
+/**
+ * @brief       ӦӦı
+ * @param       err: 
+ * @retval      Ӧı
+ */
+const char *myCMD_err_str(myCMD_ERR err)
+{
+    if ((uint32_t)err >= sizeof(g_mycmd_err_str) / sizeof(g_mycmd_err_str[0]))
+    {
+        return "ERR";
+    }
+    return g_mycmd_err_str[err];
+}
+
+#ifndef myCMD_PARSER_ONLY
+
+/***************************************DMAպִ*****************************************/
+
+#include <stdio.h>
+#include "./SYSTEM/usart/usart.h"
+#include "myADC.h"
+#include "myPWM.h"
+#include "myEXTI.h"
+#include "myFRAME.h"
+#include "mySWEEP.h"
+#include "myTUNE.h"
+#include "myTASK.h"
+#include "myRAW.h"
+#include "myLINK.h"
+#include "myUSB.h"
+#include "myVALID.h"
+
+#if USART_EN_RX
+#error "myCMD ӹ˴1,  usart.h н USART_EN_RX  0"
+#endif
+
+myCMD_CONFIG g_mycmd_cfg = {myADC_DMA_BUF_SIZE, myCFG_REPORT_MS, myCMD_STREAM_TEXT}; /* ʱ, ϵֵ myCFG.h */
+
+DMA_HandleTypeDef g_dma_usart_rx_handle = {0};  /* ڽ DMA  */
+static uint8_t g_cmd_rx_buf[myCMD_RX_BUF_SIZE]; /* DMA ѭջ */
+static uint16_t g_cmd_rx_pos = 0;               /* ȡλ */
+static myCMD_LINE g_cmd_line;                   /* жƴӵĵǰ */
+static char g_cmd_pending[myCMD_LINE_MAX + 1];  /* ȴѭִе */
+static volatile uint8_t g_cmd_pending_flag = 0; /* 0, ; 1, ; 2,  */
+static volatile uint8_t g_cmd_busy_cnt = 0;     /* ѭִж */
+
+/**
+ * @brief        DMA պͿж
+ *   @note       myLINK_init() ֮; DMA ѭģʽ, Ҫ.
+ *              USB ʱ myUSB_rx_callback() , ʲô
+ * @param       
+ * @retval      
+ */
+void myCMD_init(void)
+{
+#if !myLINK_USB
+    __HAL_RCC_DMA1_CLK_ENABLE(); /* DMA1ʱʹ */
+
+    g_dma_usart_rx_handle.Instance = myCMD_RX_DMACx;                      /* DMAͨ */
+    g_dma_usart_rx_handle.Init.Direction = DMA_PERIPH_TO_MEMORY;          /* 赽洢ģʽ */
+    g_dma_usart_rx_handle.Init.PeriphInc = DMA_PINC_DISABLE;              /* ģʽ */
+    g_dma_usart_rx_handle.Init.MemInc = DMA_MINC_ENABLE;                  /* 洢ģʽ */
+    g_dma_usart_rx_handle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE; /* ݳ:8λ */
+    g_dma_usart_rx_handle.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;    /* 洢ݳ:8λ */
+    g_dma_usart_rx_handle.Init.Mode = DMA_CIRCULAR;                       /* ѭģʽ */
+    g_dma_usart_rx_handle.Init.Priority = DMA_PRIORITY_LOW;               /* ADCɼ */
+    HAL_DMA_Init(&g_dma_usart_rx_handle);
+
+    __HAL_LINKDMA(&g_uart1_handle, hdmarx, g_dma_usart_rx_handle); /* DMA봮ϵ */
+
+    HAL_DMA_Start(&g_dma_usart_rx_handle, (uint32_t)&USART1->DR, (uint32_t)g_cmd_rx_buf, myCMD_RX_BUF_SIZE);
+    __HAL_DMA_ENABLE_IT(&g_dma_usart_rx_handle, DMA_IT_HT | DMA_IT_TC); /* /ȫʱҲȡһ, ֹݸδȡĲ */
+
+    USART1->CR3 |= USART_CR3_DMAR; /* ڽʹDMA */
+    __HAL_UART_CLEAR_IDLEFLAG(&g_uart1_handle);
+    __HAL_UART_ENABLE_IT(&g_uart1_handle, UART_IT_IDLE); /* һ֡ݽ߿ʱж */
+
+    /* жռȼͬ, ụ */
+    HAL_NVIC_SetPriority(myCMD_UART_IRQn, 3, 2);
+    HAL_NVIC_EnableIRQ(myCMD_UART_IRQn);
+    HAL_NVIC_SetPriority(myCMD_RX_DMACx_IRQn, 3, 2);
+    HAL_NVIC_EnableIRQ(myCMD_RX_DMACx_IRQn);
+#endif
+}
+
+/**
+ * @brief       ƴһֽ, õһʱѭִ, жϷ
+ * @param       c: յֽ
+ * @retval      
+ */
+static void myCMD_rx_byte(uint8_t c)
+{
+    uint8_t ret = myCMD_line_push(&g_cmd_line, c);
+
+    if (ret == myCMD_LINE_PENDING)
+    {
+        return;
+    }
+    if (g_cmd_pending_flag)
+    {
+        g_cmd_busy_cnt++; /* һûִ */
+    }
+    else
+    {
+        uint8_t i = 0;
+
+        do
+        {
+            g_cmd_pending[i] = g_cmd_line.buf[i];
+        } while (g_cmd_line.buf[i++]);
+        g_cmd_pending_flag = ret; /* myCMD_LINE_READY  myCMD_LINE_TOO_LONG */
+#if myTASK_RTOS
+        myTASK_notify_isr(myTASK_EVT_CMD, 0); /* ɲɼִ */
+#endif
+    }
+}
+
+/**
+ * @brief       ȡ DMA дݲƴ, жϷ
+ * @param       
+ * @retval      
+ */
+static void myCMD_rx_update(void)
+{
+    uint16_t pos = myCMD_RX_BUF_SIZE - __HAL_DMA_GET_COUNTER(&g_dma_usart_rx_handle); /* DMA һдλ */
+
+    if (pos >= myCMD_RX_BUF_SIZE)
+    {
+        pos = 0;
+    }
+
+    while (g_cmd_rx_pos != pos)
+    {
+        myCMD_rx_byte(g_cmd_rx_buf[g_cmd_rx_pos]);
+        if (++g_cmd_rx_pos >= myCMD_RX_BUF_SIZE)
+        {
+            g_cmd_rx_pos = 0;
+        }
+    }
+}
+
+/**
+ * @brief       1жϷ, ֻж
+ * @param       
+ * @retval      
+ */
+void myCMD_UART_IRQHandler(void)
+{
+    if (__HAL_UART_GET_FLAG(&g_uart1_handle, UART_FLAG_IDLE))
+    {
+        __HAL_UART_CLEAR_IDLEFLAG(&g_uart1_handle); /* ȶSRٶDR */
+        myCMD_rx_update();
+    }
+}
+
+/**
+ * @brief       ڽ DMA /ȫжϷ
+ * @param       
+ * @retval      
+ */
+void myCMD_RX_DMACx_IRQHandler(void)
+{
+    myCMD_RX_DMACx_CLR_FLAGS();
+    myCMD_rx_update();
+}
+
+#if myLINK_USB
+/**
+ * @brief       USB ջʱ USB ж, ȡƴ
+ *   @note      ȴִʱȡ, ڽջ; Ųһ OUT ʱ˵ NAK,
+ *              ͣ, 񴮿ѭִж. myCMD_poll() ִٴһ
+ * @param       
+ * @retval      
+ */
+void myUSB_rx_callback(void)
+{
+    uint8_t c;
+
+    while (!g_cmd_pending_flag && myUSB_read(&c, 1))
+    {
+        myCMD_rx_byte(c);
+    }
+}
+#endif
+
+/**
+ * @brief       ִһ, Ӧı
+ * @param       req  : 
+ * @param       reply: Ӧ,  myCMD_REPLY_MAX
+ * @retval      myCMD_OK 
+ */
+static myCMD_ERR myCMD_execute(const myCMD_REQ *req, char *reply)
+{
+    static const char *const stream_name[] = {"TEXT", "FRAME", "OFF", "RAW"};
+    static const char *const valid_name[] = {"OFF", "TAG", "DROP"};
+
+    if ((mySWEEP_busy() || myTUNE_running()) &&
+        (req->id == myCMD_ID_PWM || req->id == myCMD_ID_PWM_OFF || req->id == myCMD_ID_RATE ||
+         req->id == myCMD_ID_SWEEP || req->id == myCMD_ID_TUNE))
+    {
+        return myCMD_ERR_BUSY; /* ɨƵָɨƵǰ PWM  */
+    }
+    if (myTUNE_running() && req->id == myCMD_ID_AVG)
+    {
+        return myCMD_ERR_BUSY; /* ʱдƽ */
+    }
+    if (myRAW_busy() && (req->id == myCMD_ID_RATE || req->id == myCMD_ID_SWEEP || req->id == myCMD_ID_TUNE))
+    {
+        return myCMD_ERR_BUSY; /* ʱ ADC ԭʼռ */
+    }
+
+    switch (req->id)
+    {
+    case myCMD_ID_PWM:
+    {
+        uint32_t duty = req->argc > 1 ? req->arg[1] : g_mypwm_duty;
+
+        if (req->arg[0] < myPWM_FREQ_MIN || req->arg[0] > myPWM_FREQ_MAX || duty > 1000)
+        {
+            return myCMD_ERR_RANGE;
+        }
+        myPWM_GPIO_SetMode(myPWM_GPIO_MODE_PWM);
+        myPWM_set_freq(req->arg[0], (uint16_t)duty);
+        sprintf(reply, "OK PWM %lu %u", (unsigned long)g_mypwm_freq, g_mypwm_duty);
+        break;
+    }
+
+    case myCMD_ID_PWM_OFF:
+        myPWM_GPIO_SetMode(myPWM_GPIO_MODE_OUTPUT);
+        sprintf(reply, "OK PWM OFF");
+        break;
+
+    case myCMD_ID_RATE:
+        if (req->arg[0] == 0)
+        {
+            return myCMD_ERR_RANGE;
+        }
+        myTUNE_set_auto(0); /* ֶ */
+        sprintf(reply, "OK RATE %lu", (unsigned long)myADC_set_rate(req->arg[0]));
+        break;
+
+    case myCMD_ID_AVG:
+        if (req->arg[0] < 1 || req->arg[0] > myADC_DMA_BUF_SIZE)
+        {
+            return myCMD_ERR_RANGE;
+        }
+        myTUNE_set_auto(0);
+        g_mycmd_cfg.avg_depth = (uint16_t)req->arg[0]; /* һݿʼЧ */
+        sprintf(reply, "OK AVG %u", g_mycmd_cfg.avg_depth);
+        break;
+
+    case myCMD_ID_PERIOD:
+        if (req->arg[0] > 60000)
+        {
+            return myCMD_ERR_RANGE;
+        }
+        g_mycmd_cfg.period_ms = (uint16_t)req->arg[0];
+        sprintf(reply, "OK PERIOD %u", g_mycmd_cfg.period_ms);
+        break;
+
+    case myCMD_ID_MODE:
+        if (req->arg[0] == myCMD_STREAM_RAW && myLINK_USB)
+        {
+            return myCMD_ERR_ARG; /* ԭʼʹôڷ DMA */
+        }
+        if (req->arg[0] == myCMD_STREAM_RAW)
+        {
+            uint32_t rate = myRAW_request(); /* ѭӦл */
+
+            g_mycmd_cfg.stream = myCMD_STREAM_RAW;
+            sprintf(reply, "OK MODE RAW %lu %lu", (unsigned long)myRAW_BAUD, (unsigned long)rate);
+            break;
+        }
+        myRAW_stop(); /* ָԭʺӦ */
+        g_mycmd_cfg.stream = (uint8_t)req->arg[0];
+        sprintf(reply, "OK MODE %s", stream_name[g_mycmd_cfg.stream]);
+        break;
+
+    case myCMD_ID_STATUS:
+        sprintf(reply, "OK PWM %lu %u %s RATE %lu AVG %u PERIOD %u MODE %s BUSY %u TUNE %s",
+                (unsigned long)g_mypwm_freq, g_mypwm_duty, g_mypwm_gpio_mode == myPWM_GPIO_MODE_PWM ? "ON" : "OFF",
+                (unsigned long)g_myadc_rate, g_mycmd_cfg.avg_depth, g_mycmd_cfg.period_ms,
+                stream_name[g_mycmd_cfg.stream], g_cmd_busy_cnt, myTUNE_get_auto() ? "AUTO" : "OFF");
+        break;
+
+    case myCMD_ID_SWEEP:
+        if (req->argc >= 2)
+        {
+            uint32_t steps = req->argc > 2 ? req->arg[2] : mySWEEP_DEFAULT_STEPS;
+
+            if (steps > mySWEEP_MAX_STEPS || mySWEEP_set_log(req->arg[0], req->arg[1], (uint8_t)steps))
+            {
+                return myCMD_ERR_RANGE;
+            }
+        }
+        mySWEEP_request(g_mycmd_cfg.avg_depth); /* ѭڵǰݴ */
+        sprintf(reply, "OK SWEEP %u", mySWEEP_steps());
+        break;
+
+    case myCMD_ID_TUNE:
+        if (req->argc && req->arg[0] == myCMD_TUNE_OFF)
+        {
+            myTUNE_set_auto(0);
+            sprintf(reply, "OK TUNE OFF");
+            break;
+        }
+        if (req->argc)
+        {
+            myTUNE_set_auto(1);
+        }
+        myTUNE_request(myTUNE_REASON_CMD); /* ѭڵǰݴ */
+        sprintf(reply, req->argc ? "OK TUNE AUTO" : "OK TUNE");
+        break;
+
+    case myCMD_ID_VALID:
+        if (req->argc)
+        {
+            myVALID_set_mode((uint8_t)req->arg[0]); /* ͬʱռ */
+            sprintf(reply, "OK VALID %s", valid_name[req->arg[0]]);
+            break;
+        }
+        sprintf(reply, "OK VALID %s %lu %lu", valid_name[myVALID_get_mode()],
+                (unsigned long)myVALID_state()->bad, (unsigned long)myVALID_state()->total);
+        break;
+
+    default:
+        return myCMD_ERR_UNKNOWN;
+    }
+
+    return myCMD_OK;
+}
+
+/**
+ * @brief       ִյ myFRAME_TYPE_REPLY ֡Ӧ
+ *   @note      ѭе, ޸òжĲɼ̳ͻ
+ * @param       
+ * @retval      
+ */
+void myCMD_poll(void)
+{
+    char reply[myCMD_REPLY_MAX];
+    myCMD_REQ req;
+    myCMD_ERR err;
+    uint16_t len = 0;
+
+    if (g_cmd_pending_flag == 0)
+    {
+        return;
+    }
+
+    if (g_cmd_pending_flag == myCMD_LINE_TOO_LONG)
+    {
+        err = myCMD_ERR_LONG;
+    }
+    else
+    {
+        err = myCMD_parse(g_cmd_pending, &req);
+        if (err == myCMD_OK)
+        {
+            err = myCMD_execute(&req, reply);
+        }
+    }
+    g_cmd_pending_flag = 0; /* Խһ */
+#if myLINK_USB
+    myUSB_rx_kick(); /* USB ջһ */
+#endif
+
+    if (err != myCMD_OK)
+    {
+        sprintf(reply, "%s", myCMD_err_str(err));
+    }
+    while (reply[len])
+    {
+        len++;
+    }
+    myFRAME_send(myFRAME_TYPE_REPLY, (const uint8_t *)reply, len);
+}
+
+#endif
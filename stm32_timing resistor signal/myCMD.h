@@ -0,0 +1,172 @@
+/**
+ ****************************************************************************************************
+ * @file        myCMD.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * λӿ: 1 DMA ѭд뻺, (IDLE)жϺ DMA /ȫжȡ,
+ * ƴ '\r'  '\n' βı, ѭ myCMD_poll() ִв myFRAME_TYPE_REPLY ֡Ӧ,
+ * պͽ ADC ɼ
+ *
+ * (ִСд, Ϊʮ):
+ *   PWM <ƵHz> [ռձȡ]   лΪPWMƵ/ռձ, ʡռձʱֵǰֵ
+ *   PWM OFF                   PWMŸΪ
+ *   RATE </>              ADC,  myADC_set_rate() ѡʱ, Ӧʵֵ; ˳Զ
+ *   AVG <n>                   ÿƽĵ, 1 ~ myADC_DMA_BUF_SIZE; ˳Զ
+ *   PERIOD <ms>               ɼ, 0 ʾһһ
+ *   MODE TEXT|FRAME|OFF       ʽ: ı / myFRAME_TYPE_SAMPLE ֡ / 
+ *   MODE RAW                  ԭʼ(myRAW.h): Ӧ "OK MODE RAW <> <>" 󴮿лò,
+ *                             Ӧ, ֱ²յ MODE TEXT|FRAME|OFF
+ *   STATUS                    ѯǰ
+ *   SWEEP [ʼHz ֹHz []] ɨƵһ(Ĭ16), ʡԲʱʹһεƵʱ;
+ *                             ÿƵʵĲȡ AVG ,  myFRAME_TYPE_SPECTRUM ֡
+ *   TUNE [AUTO|OFF]           һβʱƽ,  myFRAME_TYPE_TUNE ֡;
+ *                             AUTO Զģʽ(ֵԽʮʱ)һ, OFF رԶģʽ(Ĭ)
+ *   VALID [TAG|DROP|OFF]      У(myVALID.h): TAG ճ־, DROP (Ĭ),
+ *                             OFF У; ʡԲʱӦ "OK VALID <ʽ> <> <У>"
+ * ԭʼڼ RATESWEEPTUNE Ӧ ERR BUSY; USB (myLINK.h) MODE RAW Ӧ ERR ARG
+ * Ӧ: "OK ..."  "ERR <ԭ>"
+ *
+ * ע: ԭ usart.c  USART_EN_RX Ϊ1ʱ USART1_IRQHandler ֽжϽ,
+ *       ʹñģ usart.h н USART_EN_RX  0
+ * USB ʱ OUT ˵(myUSB_rx_callback), ͬжƴ,  myCMD_poll() ִ
+ *
+ *  myCMD_PARSER_ONLY ֻƴӺ,  HAL,  PC  gcc (sim Ŀ¼ make check-cmd)
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef _MYCMD_H
+#define _MYCMD_H
+#include <stdint.h>
+
+/******************************************************************************************/
+/*  */
+
+#define myCMD_RX_BUF_SIZE 64 /* DMA ѭջ, ֽ */
+#define myCMD_LINE_MAX 48    /* 󳤶() */
+#define myCMD_REPLY_MAX 96   /* Ӧ󳤶 */
+
+/*  */
+typedef enum
+{
+    myCMD_ID_NONE = 0,
+    myCMD_ID_PWM,     /* PWM <freq> [duty] */
+    myCMD_ID_PWM_OFF, /* PWM OFF */
+    myCMD_ID_RATE,    /* RATE <rate> */
+    myCMD_ID_AVG,     /* AVG <n> */
+    myCMD_ID_PERIOD,  /* PERIOD <ms> */
+    myCMD_ID_MODE,    /* MODE TEXT|FRAME|OFF|RAW */
+    myCMD_ID_STATUS,  /* STATUS */
+    myCMD_ID_SWEEP,   /* SWEEP [f_start f_stop [steps]] */
+    myCMD_ID_TUNE,    /* TUNE [AUTO|OFF] */
+    myCMD_ID_VALID    /* VALID [TAG|DROP|OFF] */
+} myCMD_ID;
+
+/* , ӦıһһӦ */
+typedef enum
+{
+    myCMD_OK = 0,
+    myCMD_ERR_UNKNOWN, /* δ֪ */
+    myCMD_ERR_ARG,     /* ʽ */
+    myCMD_ERR_RANGE,   /* Χ */
+    myCMD_ERR_LONG,    /*  */
+    myCMD_ERR_BUSY     /* ɨƵԭʼ, ݲ޸ PWM Ͳ */
+} myCMD_ERR;
+
+/* ʽ */
+typedef enum
+{
+    myCMD_STREAM_TEXT = 0, /* printf ı */
+    myCMD_STREAM_FRAME,    /* myFRAME_TYPE_SAMPLE ֡ */
+    myCMD_STREAM_OFF,      /*  */
+    myCMD_STREAM_RAW       /* ÿ ADC ֵ DMA ֱӷ(myRAW.h) */
+} myCMD_STREAM;
+
+/* TUNE Ĳ */
+typedef enum
+{
+    myCMD_TUNE_OFF = 0, /* رԶ */
+    myCMD_TUNE_AUTO     /* Զ */
+} myCMD_TUNE_MODE;
+
+/* VALID Ĳ,  myVALID_MODE_* һ */
+typedef enum
+{
+    myCMD_VALID_OFF = 0, /* У */
+    myCMD_VALID_TAG,     /* ־ */
+    myCMD_VALID_DROP     /*  */
+} myCMD_VALID_MODE;
+
+/*  */
+typedef struct
+{
+    myCMD_ID id;
+    uint8_t argc;
+    uint32_t arg[3];
+} myCMD_REQ;
+
+/* ƴ״̬ */
+typedef struct
+{
+    char buf[myCMD_LINE_MAX + 1];
+    uint8_t len;
+    uint8_t overflow; /* ѳ, β */
+} myCMD_LINE;
+
+/* myCMD_line_push ֵ */
+#define myCMD_LINE_PENDING 0  /* δ */
+#define myCMD_LINE_READY 1    /* õһ, buf  '\0' β */
+#define myCMD_LINE_TOO_LONG 2 /* һн, Ѷ */
+
+/******************************************************************************************/
+/* ƴӺͽ( HAL) */
+
+uint8_t myCMD_line_push(myCMD_LINE *line, uint8_t c);   /* һֽ */
+myCMD_ERR myCMD_parse(const char *text, myCMD_REQ *req); /* һ */
+const char *myCMD_err_str(myCMD_ERR err);                /* ӦӦı */
+
+#ifndef myCMD_PARSER_ONLY
+#include "./SYSTEM/sys/sys.h"
+
+/******************************************************************************************/
+/* ڽ DMA 
+ * ע: USART1_RX DMAֻͨ: DMA1_Channel5
+ */
+
+#define myCMD_UART_IRQn USART1_IRQn
+#define myCMD_UART_IRQHandler USART1_IRQHandler
+
+#define myCMD_RX_DMACx DMA1_Channel5
+#define myCMD_RX_DMACx_IRQn DMA1_Channel5_IRQn
+#define myCMD_RX_DMACx_IRQHandler DMA1_Channel5_IRQHandler
+#define myCMD_RX_DMACx_CLR_FLAGS() \
+    do                             \
+    {                              \
+        DMA1->IFCR |= 7 << 16;     \
+    } while (0) /*  DMA1_Channel5 ȫ//봫־ */
+
+/* ʱ, ѭȡ */
+typedef struct
+{
+    uint16_t avg_depth; /* ƽĵ */
+    uint16_t period_ms; /* ɼ, ms */
+    uint8_t stream;     /* myCMD_STREAM */
+} myCMD_CONFIG;
+
+extern myCMD_CONFIG g_mycmd_cfg;
+
+/******************************************************************************************/
+/* ⲿӿں*/
+
+void myCMD_init(void); /*  DMA պͿж */
+void myCMD_poll(void); /* ѭ: ִյӦ */
+
+#endif
+
+#endif
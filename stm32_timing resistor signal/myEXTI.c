@@ -12,13 +12,15 @@
  ****************************************************************************************************
  */
 
-#include "./SYSTEM/delay/delay.h"
 #include "myEXTI.h"
 #include "myPWM.h"
 #include "myLED.h"
+#include "mySWEEP.h"
 
 extern TIM_HandleTypeDef mygtimx_pwm_chy_handle; /*  myPWM.h Ķʱx */
 myPWM_GPIO_MODE g_mypwm_gpio_mode;               /* PWMGPIO ģʽ */
+TIM_HandleTypeDef g_debounce_tim_handle;         /* ʱ */
+static volatile uint16_t g_key_pending = 0;      /* ȴȷϵİ(źŰλ) */
 
 /**
  * GPIO밴ӳ䣺PA0 WK_UP; PE4 KEY0; PE3 KEY1
@@ -96,6 +98,21 @@ void myEXTI_init(void)
     HAL_NVIC_SetPriority(WKUP_INT_IRQn, 2, 2); /* ռ2ȼ2 */
     HAL_NVIC_EnableIRQ(WKUP_INT_IRQn);         /* ʹж0 */
 
+    /* ʱ: 10kHz , ģʽ, һκԶֹͣ */
+    myEXTI_DEBOUNCE_TIM_CLK_ENABLE();
+    g_debounce_tim_handle.Instance = myEXTI_DEBOUNCE_TIM;
+    g_debounce_tim_handle.Init.Prescaler = myCFG_DEBOUNCE_PSC;                                /* 72MHz / 7200 = 10kHz */
+    g_debounce_tim_handle.Init.Period = myEXTI_DEBOUNCE_MS * (myCFG_DEBOUNCE_HZ / 1000) - 1; /* ʱ = ʱ */
+    g_debounce_tim_handle.Init.CounterMode = TIM_COUNTERMODE_UP;
+    g_debounce_tim_handle.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    HAL_TIM_Base_Init(&g_debounce_tim_handle);
+    myEXTI_DEBOUNCE_TIM->CR1 |= TIM_CR1_OPM;                   /* ģʽ */
+    __HAL_TIM_CLEAR_IT(&g_debounce_tim_handle, TIM_IT_UPDATE); /* ʼĸ¼ */
+    __HAL_TIM_ENABLE_IT(&g_debounce_tim_handle, TIM_IT_UPDATE);
+
+    HAL_NVIC_SetPriority(myEXTI_DEBOUNCE_TIM_IRQn, 3, 1); /* ռ3ADC DMAжͬ, ݲɼ */
+    HAL_NVIC_EnableIRQ(myEXTI_DEBOUNCE_TIM_IRQn);
+
     myPWM_GPIO_SetAsOutput(); // ʼΪģʽ
     g_mypwm_gpio_mode = myPWM_GPIO_MODE_OUTPUT;
 }
@@ -104,71 +121,83 @@ void myEXTI_init(void)
  * @brief       ûضĻص
  *              жϷҪ
  *              HALеⲿжϷô˺
+ *   @note      ֻ¼¿ʼʱ, ʱжִ
  * @param       GPIO_Pin:жź
  * @retval      
  */
 void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 {
-    delay_ms(20); /*  */
+    g_key_pending |= GPIO_Pin;
+
+    __HAL_TIM_DISABLE(&g_debounce_tim_handle);
+    __HAL_TIM_SET_COUNTER(&g_debounce_tim_handle, 0); /* ڼÿض¼ʱ */
+    __HAL_TIM_ENABLE(&g_debounce_tim_handle);
+}
 
-    switch (GPIO_Pin)
+/**
+ * @brief       ʱжϷ
+ *              ʱûµı, ȷϰƽִа
+ * @param       
+ * @retval      
+ */
+void myEXTI_DEBOUNCE_TIM_IRQHandler(void)
+{
+    uint16_t keys;
+
+    if (__HAL_TIM_GET_FLAG(&g_debounce_tim_handle, TIM_FLAG_UPDATE))
     {
-    case KEY0_INT_GPIO_PIN:
-        // KEY0 жź
-        if (HAL_GPIO_ReadPin(KEY0_INT_GPIO_PORT, KEY0_INT_GPIO_PIN) == 0) // ǷΪ͵ƽȷ£
+        __HAL_TIM_CLEAR_IT(&g_debounce_tim_handle, TIM_IT_UPDATE);
+
+        __disable_irq(); /* ⲿжȼ, ȡ֮ܲµİ */
+        keys = g_key_pending;
+        g_key_pending = 0;
+        __enable_irq();
+        if (mySWEEP_busy())
         {
-            if (g_mypwm_gpio_mode != myPWM_GPIO_MODE_OUTPUT)
-            {
-                myPWM_GPIO_SetAsOutput();                   // PWMΪ 
-                g_mypwm_gpio_mode = myPWM_GPIO_MODE_OUTPUT; // ģʽ״̬
-            }
+            keys = 0; /* ɨƵڼ TIM3 ɨƵռ, ԰ */
+        }
 
+        if ((keys & KEY0_INT_GPIO_PIN) && HAL_GPIO_ReadPin(KEY0_INT_GPIO_PORT, KEY0_INT_GPIO_PIN) == 0) // ǷΪ͵ƽȷ£
+        {
+            myPWM_GPIO_SetMode(myPWM_GPIO_MODE_OUTPUT); // PWMΪ 
             myLED0_TOGGLE();
         }
-        break;
 
-    case KEY1_INT_GPIO_PIN:
-        // KEY1 жź
-        if (HAL_GPIO_ReadPin(KEY1_INT_GPIO_PORT, KEY1_INT_GPIO_PIN) == 0)
+        if ((keys & KEY1_INT_GPIO_PIN) && HAL_GPIO_ReadPin(KEY1_INT_GPIO_PORT, KEY1_INT_GPIO_PIN) == 0)
         {
-            if (g_mypwm_gpio_mode != myPWM_GPIO_MODE_PWM)
-            {
-                myPWM_GPIO_SetAsPWM();                   // PWMΪ PWM 
-                g_mypwm_gpio_mode = myPWM_GPIO_MODE_PWM; // ģʽ״̬
-            }
-
-            /* ޸ PWM ƵΪ10kHzֱӸ¼Ĵ */
-            __HAL_TIM_DISABLE(&mygtimx_pwm_chy_handle); // ͣʱ
-
-            __HAL_TIM_SET_PRESCALER(&mygtimx_pwm_chy_handle, 72 - 1);              // ·Ƶϵ psc
-            __HAL_TIM_SET_AUTORELOAD(&mygtimx_pwm_chy_handle, 100 - 1);            // װֵ arr
-            __HAL_TIM_SET_COMPARE(&mygtimx_pwm_chy_handle, GTIM_TIMX_PWM_CHY, 50); // ռձ (arr+1)/2
-
-            __HAL_TIM_ENABLE(&mygtimx_pwm_chy_handle); // ʱ
+            myPWM_GPIO_SetMode(myPWM_GPIO_MODE_PWM); // PWMΪ PWM 
+            myPWM_set_freq(myCFG_KEY1_PWM_FREQ, myCFG_PWM_DUTY); // ޸ PWM ƵΪ10kHz, ռձ50%
         }
-        break;
 
-    case WKUP_INT_GPIO_PIN:
-        // WKUP жź
-        if (HAL_GPIO_ReadPin(WKUP_INT_GPIO_PORT, WKUP_INT_GPIO_PIN) == 1) // ǷΪߵƽȷ£
+        if ((keys & WKUP_INT_GPIO_PIN) && HAL_GPIO_ReadPin(WKUP_INT_GPIO_PORT, WKUP_INT_GPIO_PIN) == 1) // ǷΪߵƽȷ£
         {
-            if (g_mypwm_gpio_mode != myPWM_GPIO_MODE_PWM)
-            {
-                myPWM_GPIO_SetAsPWM();                   // PWMΪ PWM 
-                g_mypwm_gpio_mode = myPWM_GPIO_MODE_PWM; // ģʽ״̬
-            }
-
-            /* ޸ PWM ƵΪ5kHzֱӸ¼Ĵ */
-            __HAL_TIM_DISABLE(&mygtimx_pwm_chy_handle); // ͣʱ
+            myPWM_GPIO_SetMode(myPWM_GPIO_MODE_PWM); // PWMΪ PWM 
+            myPWM_set_freq(myCFG_WKUP_PWM_FREQ, myCFG_PWM_DUTY); // ޸ PWM ƵΪ5kHz, ռձ50%
+        }
+    }
+}
 
-            __HAL_TIM_SET_PRESCALER(&mygtimx_pwm_chy_handle, 72 - 1);               // ·Ƶϵ psc
-            __HAL_TIM_SET_AUTORELOAD(&mygtimx_pwm_chy_handle, 200 - 1);             // װֵ arr
-            __HAL_TIM_SET_COMPARE(&mygtimx_pwm_chy_handle, GTIM_TIMX_PWM_CHY, 100); // ռձ (arr+1)/2
+/**
+ * @brief       л PWM Źģʽ, Ǹģʽʱ
+ * @param       mode: myPWM_GPIO_MODE_PWM  myPWM_GPIO_MODE_OUTPUT
+ * @retval      
+ */
+void myPWM_GPIO_SetMode(myPWM_GPIO_MODE mode)
+{
+    if (g_mypwm_gpio_mode == mode)
+    {
+        return;
+    }
 
-            __HAL_TIM_ENABLE(&mygtimx_pwm_chy_handle); // ʱ
-        }
-        break;
+    if (mode == myPWM_GPIO_MODE_PWM)
+    {
+        myPWM_GPIO_SetAsPWM();
+    }
+    else
+    {
+        myPWM_GPIO_SetAsOutput();
     }
+    g_mypwm_gpio_mode = mode; // ģʽ״̬
 }
 
 // PWMΪ 
@@ -61,10 +61,29 @@ extern myPWM_GPIO_MODE g_mypwm_gpio_mode; // 
 #define WKUP_INT_IRQn EXTI0_IRQn
 #define WKUP_INT_IRQHandler EXTI0_IRQHandler
 
+/* ʱ
+ * ⲿжֻ¼()嶨ʱ, ʱʱڸжȷϵƽִа,
+ * ڼıػ᲻Ƴȷʱ, жﲻ delay_ms 
+ */
+#define myEXTI_DEBOUNCE_TIM TIM4
+#define myEXTI_DEBOUNCE_TIM_IRQn TIM4_IRQn
+#define myEXTI_DEBOUNCE_TIM_IRQHandler TIM4_IRQHandler
+#define myEXTI_DEBOUNCE_TIM_CLK_ENABLE() \
+    do                                   \
+    {                                    \
+        __HAL_RCC_TIM4_CLK_ENABLE();     \
+    } while (0) /* TIM4 ʱʹ */
+#define myEXTI_DEBOUNCE_MS 20 /* ʱ, ms */
+
+#if myEXTI_DEBOUNCE_MS * (myCFG_DEBOUNCE_HZ / 1000) > 65536
+#error "ʱ䳬ʱļΧ"
+#endif
+
 /******************************************************************************************/
 
 void myEXTI_init(void); /* ⲿжϳʼ */
 void myPWM_GPIO_SetAsOutput(void);
 void myPWM_GPIO_SetAsPWM(void);
+void myPWM_GPIO_SetMode(myPWM_GPIO_MODE mode); /* л PWM Źģʽ, Ǹģʽʱ */
 
 #endif
@@ -0,0 +1,139 @@
+/**
+ ****************************************************************************************************
+ * @file        myFRAME.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ ****************************************************************************************************
+ */
+
+#include "myFRAME.h"
+#include "myTASK.h"
+#include "myRAW.h"
+#include "myLINK.h"
+
+static uint8_t g_myframe_seq = 0;                                          /* ֡, ÿһ֡1 */
+static uint8_t g_myframe_buf[myFRAME_MAX_PAYLOAD + myFRAME_OVERHEAD]; /* ͻ */
+
+/* CRC-16/CCITT-FALSE ֽڲ */
+static const uint16_t g_crc16_nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF};
+
+/**
+ * @brief       CRC16 
+ *   @note      ɷֶμ: һδ 0xFFFF, ֮һεĽ
+ * @param       data: 
+ * @param       len : ݳ
+ * @param       crc : ֵ
+ * @retval      CRC16
+ */
+uint16_t myFRAME_crc16(const uint8_t *data, uint16_t len, uint16_t crc)
+{
+    while (len--)
+    {
+        crc = (crc << 4) ^ g_crc16_nibble[((crc >> 12) ^ (*data >> 4)) & 0x0F];
+        crc = (crc << 4) ^ g_crc16_nibble[((crc >> 12) ^ (*data & 0x0F)) & 0x0F];
+        data++;
+    }
+    return crc;
+}
+
+/**
+ * @brief       ֡
+ * @param       out    : ,  len + myFRAME_OVERHEAD
+ * @param       type   : ֡
+ * @param       seq    : ֡
+ * @param       payload: 
+ * @param       len    : س
+ * @retval      ֡ܳ
+ */
+uint16_t myFRAME_encode(uint8_t *out, uint8_t type, uint8_t seq, const uint8_t *payload, uint16_t len)
+{
+    uint16_t crc;
+    uint16_t i;
+
+    out[0] = myFRAME_SYNC0;
+    out[1] = myFRAME_SYNC1;
+    out[2] = type;
+    out[3] = seq;
+    myFRAME_put_u16(&out[4], len);
+    for (i = 0; i < len; i++)
+    {
+        out[myFRAME_HEADER_SIZE + i] = payload[i];
+    }
+
+    crc = myFRAME_crc16(&out[2], len + 4, 0xFFFF);
+    myFRAME_put_u16(&out[myFRAME_HEADER_SIZE + len], crc);
+
+    return len + myFRAME_OVERHEAD;
+}
+
+/**
+ * @brief       ֡λ·ͣ main.c еĲݷͷʽһ, ڻUSB myLINK.h
+ *   @note      myTASK_RTOS Ϊ 1 ҵʱ, ֡ͻ󽻸, ;
+ *              ԭʼڼ䴮ڱ DMA ռ, ֱӶ, ռ
+ * @param       type   : ֡
+ * @param       payload: 
+ * @param       len    : س,  myFRAME_MAX_PAYLOAD Ĳֱض
+ * @retval      
+ */
+void myFRAME_send(uint8_t type, const uint8_t *payload, uint16_t len)
+{
+    uint16_t frame_len;
+
+    if (myRAW_running())
+    {
+        return;
+    }
+    if (len > myFRAME_MAX_PAYLOAD)
+    {
+        len = myFRAME_MAX_PAYLOAD;
+    }
+
+#if myTASK_RTOS
+    if (myTASK_running())
+    {
+        uint8_t *buf = myTASK_tx_alloc();
+
+        if (buf == NULL)
+        {
+            return; /* ڻѹ, һ֡, ռ */
+        }
+        myTASK_tx_lock();
+        frame_len = myFRAME_encode(buf, type, g_myframe_seq++, payload, len);
+        myTASK_tx_post(buf, frame_len);
+        myTASK_tx_unlock();
+        return;
+    }
+#endif
+    frame_len = myFRAME_encode(g_myframe_buf, type, g_myframe_seq++, payload, len);
+    myLINK_write(g_myframe_buf, frame_len);
+}
+
+/**
+ * @brief       Сд 16/32 λ
+ * @param       p: дλ
+ * @param       v: ֵ
+ * @retval      һдλ
+ */
+uint8_t *myFRAME_put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+uint8_t *myFRAME_put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    return p + 4;
+}
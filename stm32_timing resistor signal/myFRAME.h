@@ -0,0 +1,58 @@
+/**
+ ****************************************************************************************************
+ * @file        myFRAME.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef _MYFRAME_H
+#define _MYFRAME_H
+#include <stdint.h>
+
+/******************************************************************************************/
+/* ֡ʽ printf ıݹһڣ
+ *
+ * | 0xA5 | 0x5A | type | seq | len() | len() | payload[len] | crc() | crc() |
+ *
+ * ͬ 0xA5  ASCII ַ, λݴ˰Ѷ֡ıзֿ
+ * crc: CRC-16/CCITT-FALSE(ʽ0x1021, ֵ0xFFFF), У鷶Χ type ~ payload ĩβ
+ * ֶֽξΪС
+ */
+
+#define myFRAME_SYNC0 0xA5
+#define myFRAME_SYNC1 0x5A
+#define myFRAME_HEADER_SIZE 6                                      /* ͬ + type + seq + len */
+#define myFRAME_CRC_SIZE 2
+#define myFRAME_OVERHEAD (myFRAME_HEADER_SIZE + myFRAME_CRC_SIZE) /* ÿֽ֡ */
+#define myFRAME_MAX_PAYLOAD 256                                    /* ֡, ֽ */
+
+/* ֡ */
+typedef enum
+{
+    myFRAME_TYPE_TELEMETRY = 0x01, /* ң */
+    myFRAME_TYPE_SAMPLE = 0x02,    /* : ʱms(u32) ADCֵ(u16) ƽ(u16) ֵM(float32) У־(u8, myVALID_FLAG_*) */
+    myFRAME_TYPE_REPLY = 0x03,     /* Ӧı(myCMD) */
+    myFRAME_TYPE_SPECTRUM = 0x04,  /* ɨƵƵ׼¼(mySWEEP) */
+    myFRAME_TYPE_TUNE = 0x05,      /* ʱ/ƽ¼(myTUNE) */
+    myFRAME_TYPE_TASKS = 0x06,     /* ӳٺкʱͳ(myTASK) */
+    myFRAME_TYPE_FAULT = 0x07,     /* Уϳ/ʧ¼(myVALID) */
+} myFRAME_TYPE;
+
+/******************************************************************************************/
+/* ⲿӿں*/
+
+uint16_t myFRAME_crc16(const uint8_t *data, uint16_t len, uint16_t crc);                                      /* CRC16  */
+uint16_t myFRAME_encode(uint8_t *out, uint8_t type, uint8_t seq, const uint8_t *payload, uint16_t len); /* ֡, ֡ */
+void myFRAME_send(uint8_t type, const uint8_t *payload, uint16_t len);                                  /* ֡ͨڷ */
+
+uint8_t *myFRAME_put_u16(uint8_t *p, uint16_t v); /* Сд, һдλ */
+uint8_t *myFRAME_put_u32(uint8_t *p, uint32_t v);
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ ****************************************************************************************************
+ * @file        myLINK.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ ****************************************************************************************************
+ */
+
+#include "myLINK.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include "./SYSTEM/usart/usart.h"
+#include "myUSB.h"
+
+/**
+ * @brief       ʼ λ·
+ *   @note      USB ʱʼ, ſ
+ * @param       
+ * @retval      
+ */
+void myLINK_init(void)
+{
+#if myLINK_USB
+    myUSB_init();
+#else
+    usart_init(myLINK_UART_BAUD);
+#endif
+}
+
+/**
+ * @brief       
+ *   @note      : , ʱһֽڻλĴ;
+ *              USB: д뷢ͻ漴, ʱȴȡ, δ򿪶˿ʱ
+ * @param       data: 
+ * @param       len : 
+ * @retval      
+ */
+void myLINK_write(const uint8_t *data, uint16_t len)
+{
+#if myLINK_USB
+    myUSB_write(data, len);
+#else
+    HAL_UART_Transmit(&g_uart1_handle, (uint8_t *)data, len, 1000);
+#endif
+}
+
+/**
+ * @brief       ʽ,  printf(ԭ usart.c  fputc ֻ)
+ * @param       fmt: ʽ
+ * @retval      ͵ֽ,  myLINK_PRINTF_MAX - 1 Ĳֱض
+ */
+int myLINK_printf(const char *fmt, ...)
+{
+    char buf[myLINK_PRINTF_MAX];
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n > (int)sizeof(buf) - 1)
+    {
+        n = sizeof(buf) - 1;
+    }
+    if (n > 0)
+    {
+        myLINK_write((const uint8_t *)buf, (uint16_t)n);
+    }
+    return n;
+}
+
+/**
+ * @brief       һεݻû
+ * @param       
+ * @retval      1, ڻڷ / USB ͻﻹûߵ; 0, 
+ */
+uint8_t myLINK_tx_busy(void)
+{
+#if myLINK_USB
+    return !myUSB_tx_idle();
+#else
+    return __HAL_UART_GET_FLAG(&g_uart1_handle, UART_FLAG_TC) != SET;
+#endif
+}
+
+/**
+ * @brief       ȴͽ
+ *   @note      USB ķͻжϰ, Ҫȴ, ֱӷ
+ * @param       
+ * @retval      
+ */
+void myLINK_tx_wait(void)
+{
+#if !myLINK_USB
+    while (__HAL_UART_GET_FLAG(&g_uart1_handle, UART_FLAG_TC) != SET)
+        ;
+#endif
+}
@@ -0,0 +1,47 @@
+/**
+ ****************************************************************************************************
+ * @file        myLINK.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * λ·: ı(myLINK_printf)֡(myFRAME_send)Ӧ𶼾 myLINK_write() ,
+ * ʱ myLINK_USB ѡ䷽ʽ, ģ鲻Ҫ޸:
+ * 0, USART1 115200 , Լ 11.5kB/s;  myCMD  DMA 
+ * 1, USB ȫ CDC ⴮(myUSB.h), ˫˵, ֻѯ;  OUT ˵
+ * λַʽ¿ֽͬ, telemetry ű򿪶ӦĴڼ(USB ʱЧ)
+ *
+ * ԭʼ(myRAW)ֱʹ USART1 ķ DMA, ֻڴڴ¿
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef _MYLINK_H
+#define _MYLINK_H
+#include <stdint.h>
+#include "myCFG.h"
+
+#ifndef myLINK_USB
+#define myLINK_USB 0 /* 1, USB CDC ⴮; 0, USART1 */
+#endif
+
+/******************************************************************************************/
+/*  */
+
+#define myLINK_UART_BAUD myCFG_UART_BAUD /* ڴĲ */
+#define myLINK_PRINTF_MAX 128   /* myLINK_printf 󳤶 */
+
+/******************************************************************************************/
+/* ⲿӿں*/
+
+void myLINK_init(void);                                  /* ʼ ڻUSB */
+void myLINK_write(const uint8_t *data, uint16_t len);    /* , ·æʱȴ */
+int myLINK_printf(const char *fmt, ...);                 /* ʽ,  printf */
+uint8_t myLINK_tx_busy(void);                            /* һεݻû */
+void myLINK_tx_wait(void);                               /* ȴͽ */
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ ****************************************************************************************************
+ * @file        myMLP.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * ˳ "MLP int8 export" űе IntMLP.forward ȫһ, λͬ;
+ * ޸ıļʱҪͬʱ޸Ľű
+ *
+ ****************************************************************************************************
+ */
+
+#include <math.h>
+#include "myMLP.h"
+
+/**
+ * @brief       һ int8 , int32 ۼ
+ *   @note      Cortex-M3 û SIMD ˼, չ4μѭ
+ * @param       w  : Ȩ
+ * @param       x  : 
+ * @param       n  : 
+ * @param       acc: ֵ(ƫ)
+ * @retval      ۼӽ
+ */
+static int32_t mymlp_dot(const int8_t *w, const int8_t *x, uint16_t n, int32_t acc)
+{
+    uint16_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        acc += w[i] * x[i];
+        acc += w[i + 1] * x[i + 1];
+        acc += w[i + 2] * x[i + 2];
+        acc += w[i + 3] * x[i + 3];
+    }
+    for (; i < n; i++)
+    {
+        acc += w[i] * x[i];
+    }
+    return acc;
+}
+
+/**
+ * @brief       һ
+ * @param       model: 
+ * @param       x    : ԭʼ, model->n_in 
+ * @param       out  : , model->n_out ; Ϊ NULL
+ * @retval      : ; ع: 0
+ */
+int myMLP_run(const myMLP_MODEL *model, const float *x, float *out)
+{
+    int8_t buf[2][myMLP_MAX_WIDTH];
+    int8_t *cur = buf[0], *next = buf[1], *tmp;
+    const myMLP_LAYER *layer;
+    uint16_t i, o;
+    uint8_t k;
+    int32_t acc, idx;
+    float v, y, best_v = 0;
+    int best = 0;
+
+    /* : round((x - center) * inv_step), ͵ 127 */
+    for (i = 0; i < model->n_in; i++)
+    {
+        v = (x[i] - model->in_center[i]) * model->in_inv_step[i];
+        v = floorf(v + 0.5f);
+        cur[i] = (int8_t)(v > 127.0f ? 127 : (v < -127.0f ? -127 : (int)v));
+    }
+
+    for (k = 0; k < model->n_layers; k++)
+    {
+        layer = &model->layers[k];
+
+        for (o = 0; o < layer->out; o++)
+        {
+            acc = mymlp_dot(layer->weight + (uint32_t)o * layer->in, cur, layer->in, layer->bias[o]);
+
+            if (layer->lut == 0) /*  */
+            {
+                y = (float)acc * layer->out_scale[o];
+                if (out)
+                {
+                    out[o] = y;
+                }
+                if (o == 0 || y > best_v)
+                {
+                    best_v = y;
+                    best = o;
+                }
+                continue;
+            }
+
+            /* ز: ± = round(acc * mult / 2^shift) */
+            idx = (int32_t)(((int64_t)acc * layer->mult[o] + ((int64_t)1 << (layer->shift[o] - 1))) >> layer->shift[o]);
+            if (idx > myMLP_LUT_SIZE / 2 - 1)
+            {
+                idx = myMLP_LUT_SIZE / 2 - 1;
+            }
+            else if (idx < -myMLP_LUT_SIZE / 2)
+            {
+                idx = -myMLP_LUT_SIZE / 2;
+            }
+            next[o] = layer->lut[idx + myMLP_LUT_SIZE / 2];
+        }
+
+        tmp = cur;
+        cur = next;
+        next = tmp;
+    }
+
+    if (model->task != myMLP_TASK_CLASSIFY)
+    {
+        return 0;
+    }
+    if (model->n_out == 1) /* :  logit */
+    {
+        return best_v > 0;
+    }
+    return best;
+}
+
+/**
+ * @brief       һĳ˼Ӵ
+ * @param       model: 
+ * @retval      ˼Ӵ
+ */
+uint32_t myMLP_macs(const myMLP_MODEL *model)
+{
+    uint32_t macs = 0;
+    uint8_t k;
+
+    for (k = 0; k < model->n_layers; k++)
+    {
+        macs += (uint32_t)model->layers[k].in * model->layers[k].out;
+    }
+    return macs;
+}
@@ -0,0 +1,71 @@
+/**
+ ****************************************************************************************************
+ * @file        myMLP.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * int8  MLP (sklearn MLPRegressor / MLPClassifier,  "MLP int8 export" ű):
+ * 1, : ÿѵݷΧΪ int8, x_q = round((x - center) * inv_step); Ԥ
+ *    (MinMaxScaler / StandardScaler)ѺϲһȨغƫ, 豸ֱԭʼ
+ * 2, ȫӲ: int8 Ȩ(ÿͨһ߶)  int8 , int32 ۼ, ƫΪ int32
+ * 3, ز: ۼֵ Q31 , õĲ±(-256 ~ 255),  512  int8 õ;
+ *    tanh / logistic / relu / identity òʵ, ûи
+ * 4, : ۼֵ  ϵõ(عֵ logit), ෵ߵ
+ *
+ * ֻ <stdint.h>  <math.h>,  PC  gcc ; sim Ŀ¼ make mlpsim  mlpsim,
+ * ˶뵼űοʵλһ, ʱ
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef _MYMLP_H
+#define _MYMLP_H
+#include <stdint.h>
+
+/******************************************************************************************/
+/*  */
+
+#define myMLP_MAX_WIDTH 256     /* һԪ, ջ鼤ĴС */
+#define myMLP_LUT_SIZE 512      /* , ± -256 ~ 255 */
+#define myMLP_TASK_CLASSIFY 0   /* : myMLP_run  */
+#define myMLP_TASK_REGRESS 1    /* ع:  out[0] */
+
+/* һȫӲ */
+typedef struct
+{
+    uint16_t in;              /*  */
+    uint16_t out;             /*  */
+    const int8_t *weight;     /* [out][in] */
+    const int32_t *bias;      /* [out], ߶ = Ȩس߶  ߶ */
+    const int32_t *mult;      /* [out], ز: ۼֵ± Q31  */
+    const uint8_t *shift;     /* [out], ز: ˻λ (>= 1) */
+    const int8_t *lut;        /* ز: ; NULL ʾ */
+    const float *out_scale;   /* : [out], ۼֵķϵ */
+} myMLP_LAYER;
+
+/*  */
+typedef struct
+{
+    uint8_t task;             /* myMLP_TASK_CLASSIFY / myMLP_TASK_REGRESS */
+    uint8_t n_layers;
+    uint16_t n_in;            /*  */
+    uint16_t n_out;           /* (Ϊ 1,  > 0 Ϊ 1) */
+    const float *in_center;   /* [n_in]  */
+    const float *in_inv_step; /* [n_in] ĵ */
+    const myMLP_LAYER *layers;
+} myMLP_MODEL;
+
+/******************************************************************************************/
+/* ⲿӿں*/
+
+extern const myMLP_MODEL g_mymlp_model;       /* űɵ myMLP_model.c ж */
+
+int myMLP_run(const myMLP_MODEL *model, const float *x, float *out); /* һ, (ع鷵 0) */
+uint32_t myMLP_macs(const myMLP_MODEL *model);                       /* һĳ˼Ӵ */
+
+#endif
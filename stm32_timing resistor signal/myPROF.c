@@ -0,0 +1,207 @@
+/**
+ ****************************************************************************************************
+ * @file        myPROF.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ ****************************************************************************************************
+ */
+
+#include "myPROF.h"
+#include "myFRAME.h"
+
+#ifdef myPROF_MOCK_CYCCNT
+volatile uint32_t g_myprof_mock_cyccnt = 0; /* ģڼ, ɲԴƽ */
+#endif
+
+myPROF_STATS g_myprof_stats;                 /* ͳ */
+static volatile uint32_t g_myprof_dma_due = 0; /*  DMA ʱ(CYCCNT) */
+static uint32_t g_myprof_conv_cycles = myPROF_ADC_CONV_CYCLES; /* ADCתʱ, CPU */
+
+/**
+ * @brief       ʹ DWT ڼ, ͳ
+ * @param       
+ * @retval      
+ */
+void myPROF_init(void)
+{
+#ifndef myPROF_MOCK_CYCCNT
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; /* ʹ DWT/ITM */
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk; /* ڼ */
+#endif
+    myPROF_reset();
+}
+
+/**
+ * @brief       ͳ
+ * @param       
+ * @retval      
+ */
+void myPROF_reset(void)
+{
+    uint8_t i;
+
+    myPROF_IRQ_DISABLE();
+    for (i = 0; i < myPROF_STAGE_NUM; i++)
+    {
+        g_myprof_stats.stage[i].count = 0;
+        g_myprof_stats.stage[i].min = 0xFFFFFFFF;
+        g_myprof_stats.stage[i].max = 0;
+        g_myprof_stats.stage[i].sum = 0;
+    }
+    for (i = 0; i < myPROF_ISR_BINS; i++)
+    {
+        g_myprof_stats.isr_hist[i] = 0;
+    }
+    g_myprof_stats.isr_max = 0;
+    g_myprof_stats.dma_overrun = 0;
+    g_myprof_stats.uart_backlog = 0;
+    myPROF_IRQ_ENABLE();
+}
+
+/**
+ * @brief       ¼һν׶κʱ
+ *   @note      CYCCNT Ϊ32λ, 72MHz Լ59.6sһ, ޷ȷһλ
+ * @param       stage : ׶
+ * @param       cycles: ʱ, λCPU
+ * @retval      
+ */
+void myPROF_record(myPROF_STAGE stage, uint32_t cycles)
+{
+    myPROF_SPAN *span = &g_myprof_stats.stage[stage];
+
+    span->count++;
+    span->sum += cycles;
+    if (cycles < span->min)
+    {
+        span->min = cycles;
+    }
+    if (cycles > span->max)
+    {
+        span->max = cycles;
+    }
+}
+
+/**
+ * @brief       ޸Ĳʱµתʱ
+ * @param       cycles: ADCתʱ, CPU
+ * @retval      
+ */
+void myPROF_set_conv_cycles(uint32_t cycles)
+{
+    g_myprof_conv_cycles = cycles;
+}
+
+/**
+ * @brief       ¼ DMA ʱ̲ʱ
+ * @param       cndtr: DMAĴ
+ * @retval      
+ */
+void myPROF_dma_start(uint16_t cndtr)
+{
+    g_myprof_dma_due = myPROF_CYCCNT() + (uint32_t)cndtr * g_myprof_conv_cycles;
+}
+
+/**
+ * @brief       DMA жڵ, ͳжϽӳ
+ *   @note      ӳ = жʱ - ʱ, ʱ̵ļΪ0;
+ *              ֵδADCϵȶʱ, ֻʺϿֲ
+ * @param       now    : жʱ CYCCNT
+ * @param       pending: һǷδ(g_adc_dma_start)
+ * @retval      
+ */
+void myPROF_isr_entry(uint32_t now, uint8_t pending)
+{
+    int32_t late = (int32_t)(now - g_myprof_dma_due);
+    uint32_t cycles = late > 0 ? (uint32_t)late : 0;
+    uint8_t bin = 0;
+
+    while (bin < myPROF_ISR_BINS - 1 && cycles >= (16UL << bin))
+    {
+        bin++;
+    }
+    g_myprof_stats.isr_hist[bin]++;
+
+    if (cycles > g_myprof_stats.isr_max)
+    {
+        g_myprof_stats.isr_max = cycles;
+    }
+    if (pending)
+    {
+        g_myprof_stats.dma_overrun++;
+    }
+}
+
+/**
+ * @brief       ڻѹ1
+ * @param       
+ * @retval      
+ */
+void myPROF_uart_backlog(void)
+{
+    g_myprof_stats.uart_backlog++;
+}
+
+/**
+ * @brief       ͳƿл(С)
+ *   @note      ظʽ:
+ *              汾(u8) ׶(u8) Ƶ(u32)
+ *              ׶: (u32) С(u32) (u32) ۼƵ32λ(u32) ۼƸ32λ(u32)
+ *              ֵ(u8) ֱͼ(u32  ֵ) ӳ(u32) DMA(u32) ڻѹ(u32)
+ * @param       buf: ,  myPROF_PAYLOAD_SIZE
+ * @retval      س
+ */
+uint16_t myPROF_serialize(uint8_t *buf)
+{
+    uint8_t *p = buf;
+    uint8_t i;
+
+    myPROF_IRQ_DISABLE(); /* ж޸ֱͼͼ, лڼжϱ֤һ */
+
+    *p++ = myPROF_VERSION;
+    *p++ = myPROF_STAGE_NUM;
+    p = myFRAME_put_u32(p, myPROF_CPU_HZ);
+    for (i = 0; i < myPROF_STAGE_NUM; i++)
+    {
+        myPROF_SPAN *span = &g_myprof_stats.stage[i];
+
+        p = myFRAME_put_u32(p, span->count);
+        p = myFRAME_put_u32(p, span->count ? span->min : 0);
+        p = myFRAME_put_u32(p, span->max);
+        p = myFRAME_put_u32(p, (uint32_t)span->sum);
+        p = myFRAME_put_u32(p, (uint32_t)(span->sum >> 32));
+    }
+    *p++ = myPROF_ISR_BINS;
+    for (i = 0; i < myPROF_ISR_BINS; i++)
+    {
+        p = myFRAME_put_u32(p, g_myprof_stats.isr_hist[i]);
+    }
+    p = myFRAME_put_u32(p, g_myprof_stats.isr_max);
+    p = myFRAME_put_u32(p, g_myprof_stats.dma_overrun);
+    p = myFRAME_put_u32(p, g_myprof_stats.uart_backlog);
+
+    myPROF_IRQ_ENABLE();
+
+    return (uint16_t)(p - buf);
+}
+
+/**
+ * @brief       ң֡ͳ
+ * @param       
+ * @retval      
+ */
+void myPROF_report(void)
+{
+    uint8_t payload[myPROF_PAYLOAD_SIZE];
+    uint16_t len;
+
+    len = myPROF_serialize(payload);
+    myFRAME_send(myFRAME_TYPE_TELEMETRY, payload, len);
+    myPROF_reset();
+}
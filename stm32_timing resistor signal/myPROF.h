@@ -0,0 +1,102 @@
+/**
+ ****************************************************************************************************
+ * @file        myPROF.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ *  DWT->CYCCNT ͳ:
+ * 1, ѭ׶(ƽ㻻㡢printfڷ)ĺʱ: /С//ۼ, λCPU
+ * 2, ADC DMA жϽӳֱͼ(ڰʱ DMA ʱ)
+ * 3, DMA (һδһ)ʹڻѹ(ǰһ֡δ)
+ * ͳƽ myPROF_report() ң֡(myFRAME_TYPE_TELEMETRY), ıݻ
+ *
+ *  myPROF_MOCK_CYCCNT ٷ DWT, ڼȫֱ g_myprof_mock_cyccnt ṩ,
+ * ͳƺл PC  gcc (sim Ŀ¼ make check-prof)
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef _MYPROF_H
+#define _MYPROF_H
+
+#include "myCFG.h"
+
+#ifdef myPROF_MOCK_CYCCNT
+#include <stdint.h>
+extern volatile uint32_t g_myprof_mock_cyccnt;
+#define myPROF_CYCCNT() (g_myprof_mock_cyccnt)
+#define myPROF_IRQ_DISABLE()
+#define myPROF_IRQ_ENABLE()
+#else
+#include "./SYSTEM/sys/sys.h"
+#define myPROF_CYCCNT() (DWT->CYCCNT)
+#define myPROF_IRQ_DISABLE() __disable_irq()
+#define myPROF_IRQ_ENABLE() __enable_irq()
+#endif
+
+/******************************************************************************************/
+/*  */
+
+#define myPROF_CPU_HZ myCFG_SYSCLK  /* CPU Ƶ, λݴ˰ڻʱ */
+#define myPROF_ADC_CONV_CYCLES myCFG_ADC_CONV_CYCLES /* ADCתʱ(CPU)ֵ, Ӧϵʱ myCFG_ADC_SMP */
+#define myPROF_REPORT_PERIOD 10     /* ÿٿADCݷһң֡ */
+#define myPROF_ISR_BINS 8           /* жӳֱͼֵ: <16, 16~31, 32~63, ... , >=1024  */
+#define myPROF_VERSION 1            /* ң⸺ظʽ汾 */
+
+/* ѭ׶ */
+typedef enum
+{
+    myPROF_STAGE_AVERAGE = 0, /* DMAƽ */
+    myPROF_STAGE_CONVERT,     /* ѹ/踡㻻 */
+    myPROF_STAGE_PRINTF,      /* printf ʽ */
+    myPROF_STAGE_UART_TX,     /* HAL_UART_Transmit ȴͽ */
+    myPROF_STAGE_LOOP,        /* һݵ */
+    myPROF_STAGE_NUM
+} myPROF_STAGE;
+
+/* ׶κʱͳ, λCPU */
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} myPROF_SPAN;
+
+typedef struct
+{
+    myPROF_SPAN stage[myPROF_STAGE_NUM];
+    uint32_t isr_hist[myPROF_ISR_BINS]; /* жϽӳֱͼ */
+    uint32_t isr_max;                   /* жϽӳ */
+    uint32_t dma_overrun;               /* DMA  */
+    uint32_t uart_backlog;              /* ڻѹ */
+} myPROF_STATS;
+
+/* ң⸺س: 汾 + ׶ + Ƶ + ׶(54ֽ) + ֵ + ֱͼ + ӳ +  */
+#define myPROF_PAYLOAD_SIZE (2 + 4 + myPROF_STAGE_NUM * 20 + 1 + myPROF_ISR_BINS * 4 + 4 + 8)
+
+/* ׶μʱ: ͬһڳɶʹ */
+#define myPROF_BEGIN(stage) uint32_t myprof_t0_##stage = myPROF_CYCCNT()
+#define myPROF_END(stage) myPROF_record(stage, myPROF_CYCCNT() - myprof_t0_##stage)
+
+extern myPROF_STATS g_myprof_stats;
+
+/******************************************************************************************/
+/* ⲿӿں*/
+
+void myPROF_init(void);                                 /* ʹ DWT ڼ, ͳ */
+void myPROF_reset(void);                                /* ͳ */
+void myPROF_record(myPROF_STAGE stage, uint32_t cycles); /* ¼һν׶κʱ */
+void myPROF_set_conv_cycles(uint32_t cycles);           /* ޸Ĳʱµתʱ */
+void myPROF_dma_start(uint16_t cndtr);                  /* ¼ DMA ʱ̲ʱ */
+void myPROF_isr_entry(uint32_t now, uint8_t pending);   /* DMA жڵ */
+void myPROF_uart_backlog(void);                         /* ڻѹ1 */
+uint16_t myPROF_serialize(uint8_t *buf);                /* ͳƿл, ظس */
+void myPROF_report(void);                               /* ң֡ͳ */
+
+#endif
@@ -15,6 +15,8 @@
 #include "myPWM.h"
 
 TIM_HandleTypeDef mygtimx_pwm_chy_handle;
+uint32_t g_mypwm_freq = myCFG_PWM_FREQ; /* ǰ PWM Ƶ, Hz */
+uint16_t g_mypwm_duty = myCFG_PWM_DUTY; /* ǰ PWM ռձ, ǧֱ */
 
 /**
  * @brief       ͨöʱ PWM ʼʹPWMģʽ2
@@ -40,7 +42,7 @@ void myPWM_init(uint16_t arr, uint16_t psc)
 
     timx_oc_pwm_chy.OCPolarity = TIM_OCNPOLARITY_HIGH; // ԸߣߵƽЧ
     timx_oc_pwm_chy.OCMode = TIM_OCMODE_PWM2;          // ȽģʽPWM2CNT>=CRRʱЧƽ
-    timx_oc_pwm_chy.Pulse = arr / 2;                   // ʼռձ50%
+    timx_oc_pwm_chy.Pulse = (arr + 1) * g_mypwm_duty / 1000; // ʼռձ myCFG_PWM_DUTY
 
     HAL_TIM_PWM_ConfigChannel(&mygtimx_pwm_chy_handle, &timx_oc_pwm_chy, GTIM_TIMX_PWM_CHY); // PWMıȽֵռձȵ
 
@@ -72,3 +74,37 @@ void HAL_TIM_PWM_MspInit(TIM_HandleTypeDef *htim)
         HAL_GPIO_Init(myPWM_GPIO_PORT, &gpio_init_struct);
     }
 }
+
+/**
+ * @brief       ʱ޸ PWM ƵʺռձȣֱӸ¼Ĵ
+ *   @note      ڶʱʱ72MHzѡСķƵϵ, ʹװֵ65535, ռձȷֱ;
+ *               10kHz ʱ psc=0, arr=7199
+ * @param       freq: Ƶ, λHz, Χ myPWM_FREQ_MIN ~ myPWM_FREQ_MAX
+ * @param       duty: ռձ, ǧֱ, 0 ~ 1000
+ * @retval      0, ɹ; 1, Χ
+ */
+uint8_t myPWM_set_freq(uint32_t freq, uint16_t duty)
+{
+    uint32_t cycles, psc, arr;
+
+    if (freq < myPWM_FREQ_MIN || freq > myPWM_FREQ_MAX || duty > 1000)
+    {
+        return 1;
+    }
+
+    cycles = myPWM_TIM_CLK / freq; // һPWMڵĶʱʱ
+    psc = (cycles - 1) / 65536;    // ֤ arr <= 65535
+    arr = cycles / (psc + 1) - 1;
+
+    __HAL_TIM_DISABLE(&mygtimx_pwm_chy_handle); // ͣʱ
+
+    __HAL_TIM_SET_PRESCALER(&mygtimx_pwm_chy_handle, psc);                                       // ·Ƶϵ psc
+    __HAL_TIM_SET_AUTORELOAD(&mygtimx_pwm_chy_handle, arr);                                      // װֵ arr
+    __HAL_TIM_SET_COMPARE(&mygtimx_pwm_chy_handle, GTIM_TIMX_PWM_CHY, (arr + 1) * duty / 1000); // ռձ
+
+    __HAL_TIM_ENABLE(&mygtimx_pwm_chy_handle); // ʱ
+
+    g_mypwm_freq = freq;
+    g_mypwm_duty = duty;
+    return 0;
+}
@@ -15,6 +15,7 @@
 #ifndef _MYPWM_H
 #define _MYPWM_H
 #include "./SYSTEM/sys/sys.h"
+#include "myCFG.h"
 
 /******************************************************************************************/
 /* ͨöʱ  */
@@ -54,8 +55,16 @@
         __HAL_RCC_TIM3_CLK_ENABLE();   \
     } while (0) /* TIM3 ʱʹ */
 
+#define myPWM_TIM_CLK myCFG_TIM_CLK /* ʱʱ, Hz */
+#define myPWM_FREQ_MIN 2        /* ʱõƵʷΧ, Hz */
+#define myPWM_FREQ_MAX 1000000
+
 /******************************************************************************************/
 
-void myPWM_init(uint16_t arr, uint16_t psc); /* ͨöʱ PWMʼ */
+extern uint32_t g_mypwm_freq; /* ǰ PWM Ƶ, Hz */
+extern uint16_t g_mypwm_duty; /* ǰ PWM ռձ, ǧֱ */
+
+void myPWM_init(uint16_t arr, uint16_t psc);           /* ͨöʱ PWMʼ */
+uint8_t myPWM_set_freq(uint32_t freq, uint16_t duty); /* ʱ޸ PWM Ƶʺռձ */
 
 #endif
@@ -0,0 +1,305 @@
+/**
+ ****************************************************************************************************
+ * @file        myRAW.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ ****************************************************************************************************
+ */
+
+#include "myRAW.h"
+#include "myFRAME.h"
+#include "myTASK.h"
+#include "./SYSTEM/usart/usart.h"
+
+extern uint16_t g_adc_dma_buf[myADC_DMA_BUF_SIZE]; /*  main.c  ADC DMA BUF,  */
+
+/* ԭʼ״̬ */
+#define myRAW_IDLE 0
+#define myRAW_PENDING 1
+#define myRAW_RUNNING 2
+
+#define myRAW_TX_NONE 0xFF /*  DMA  */
+
+static volatile uint8_t g_raw_state = myRAW_IDLE;  /* ԭʼ״̬ */
+static uint8_t g_raw_hdr[2][myRAW_HEADER_SIZE];    /* Եİͷ */
+static uint16_t g_raw_seq = 0;                     /* , ÿдһ1 */
+static uint8_t g_raw_drop = 0;                     /* ۼֹİ */
+static volatile uint8_t g_raw_tx_half = myRAW_TX_NONE; /*  DMA ڷ(ռ)һ */
+static volatile uint8_t g_raw_tx_data = 0;         /* 0, ڷͷ; 1, ڷ */
+static uint32_t g_raw_cr2 = 0;                     /* ǰ ADC CR2 */
+static uint32_t g_raw_brr = 0;                     /* ǰĴڲʼĴ */
+static uint8_t g_raw_smp = 0;                      /* ǰĲʱ䵵λ */
+
+/**
+ * @brief       ʱ
+ *   @note      ÿ myRAW_HALF ռ ͷ + 2   ֽ, ÿֽ 10 λ;
+ *               =  / 10   /   myRAW_LINK_USE%, ȡ֤.
+ *              2Mbaud ʱΪ 819 , Լ 87.9k /
+ * @param       
+ * @retval      , ʱʱ
+ */
+static uint32_t myRAW_period(void)
+{
+    uint64_t num = (uint64_t)myRAW_TIMX_CLK * 10 * (myRAW_HEADER_SIZE + 2 * myRAW_HALF) * 100;
+    uint64_t den = (uint64_t)myRAW_BAUD * myRAW_HALF * myRAW_LINK_USE;
+
+    return (uint32_t)((num + den - 1) / den);
+}
+
+/**
+ * @brief       ԭʼģʽ, ѭ֮
+ *   @note       MODE RAW , Ӧԭʷͺл
+ * @param       
+ * @retval      ʹõĲ, /
+ */
+uint32_t myRAW_request(void)
+{
+    if (g_raw_state == myRAW_IDLE)
+    {
+        g_raw_state = myRAW_PENDING;
+    }
+    return myRAW_TIMX_CLK / myRAW_period();
+}
+
+/**
+ * @brief       ԭʼȴ
+ * @param       
+ * @retval      0, ; 1, 
+ */
+uint8_t myRAW_pending(void)
+{
+    return g_raw_state == myRAW_PENDING;
+}
+
+/**
+ * @brief       ԭʼ
+ *   @note      ʱڱ DMA ռ, myFRAME_send ݴ˶
+ * @param       
+ * @retval      0, ; 1, 
+ */
+uint8_t myRAW_running(void)
+{
+    return g_raw_state == myRAW_RUNNING;
+}
+
+/**
+ * @brief       ԭʼȴ
+ *   @note      ѭݴ˲ͨݿ, ִʱݴ˾ܾ޸Ĳ
+ * @param       
+ * @retval      0, ; 1, 
+ */
+uint8_t myRAW_busy(void)
+{
+    return g_raw_state != myRAW_IDLE;
+}
+
+/**
+ * @brief       һδ DMA 
+ * @param       data: 
+ * @param       len : ֽ
+ * @retval      
+ */
+static void myRAW_tx(const void *data, uint16_t len)
+{
+    myRAW_TX_DMACx->CCR &= ~(1 << 0); // ر DMA 
+    while (myRAW_TX_DMACx->CCR & (1 << 0))
+        ;
+    myRAW_TX_DMACx->CMAR = (uint32_t)data;
+    myRAW_TX_DMACx->CNDTR = len;
+    myRAW_TX_DMACx->CCR |= 1 << 0; //  DMA 
+}
+
+/**
+ * @brief       ԭʼ
+ *   @note       ADC (һѴ)ʱ. е( MODE RAW Ӧ)л;
+ *              ֮ÿ㶼 TIM1 -> ADC -> DMA , CPU ÿһждͷ.
+ *              úüĴ, ֹHAL ADC ʹڵ޸
+ * @param       
+ * @retval      
+ */
+void myRAW_start(void)
+{
+    uint32_t period = myRAW_period();
+
+#if myTASK_RTOS
+    myTASK_tx_flush(); /* ȷ */
+#endif
+    while (__HAL_UART_GET_FLAG(&g_uart1_handle, UART_FLAG_TC) != SET)
+        ; /* ȴһֽڷͽ */
+
+    g_raw_brr = USART1->BRR;
+    g_raw_smp = myADC_get_smp();
+    g_raw_cr2 = myADC_ADCX->CR2;
+    USART1->BRR = myRAW_UART_CLK / myRAW_BAUD;
+    myADC_set_rate(myRAW_TIMX_CLK / period); /* üתĲʱ */
+
+    /* ADC: ת,  TIM1_CC1 ¼ */
+    myADC_ADCX->CR2 &= ~(1 << 0);                           // ر ADCX
+    myADC_ADCX->CR2 &= ~((1 << 1) | (7 << 17));             // CONT=0, EXTSEL=000 (TIM1_CC1)
+    myADC_ADCX->CR2 |= 1 << 20;                             // EXTTRIG, ⲿ
+
+    /* ADC DMA: ѭд g_adc_dma_buf, ȫжһ */
+    myADC_ADCX_DMACx->CCR &= ~(1 << 0); // ر DMA 
+    while (myADC_ADCX_DMACx->CCR & (1 << 0))
+        ;
+    myADC_ADCX_DMACx->CMAR = (uint32_t)g_adc_dma_buf;
+    myADC_ADCX_DMACx->CNDTR = myADC_DMA_BUF_SIZE;
+    myADC_ADCX_DMACx->CCR |= (1 << 5) | (1 << 2) | (1 << 1); // CIRC, HTIE, TCIE
+    myADC_ADCX_DMACx->CCR |= 1 << 0;                         //  DMA 
+
+    /* ڷ DMA: 洢, 洢, 8λ, ж */
+    myRAW_TX_DMACx->CCR = 0;
+    myRAW_TX_DMACx->CPAR = (uint32_t)&USART1->DR;
+    myRAW_TX_DMACx->CCR = (1 << 1) | (1 << 4) | (1 << 7);
+    myRAW_TX_DMACx_CLR_FLAGS();
+    USART1->CR3 |= USART_CR3_DMAT; /* ڷʹDMA */
+    HAL_NVIC_SetPriority(myRAW_TX_DMACx_IRQn, 3, 3); /*  ADC DMA жͬ, ụ */
+    HAL_NVIC_EnableIRQ(myRAW_TX_DMACx_IRQn);
+
+    /* TIM1: PWM1 ģʽ, CC1 Ƚ¼ʱ */
+    myRAW_TIMX_CLK_ENABLE();
+    myRAW_TIMX->CR1 = 0;
+    myRAW_TIMX->PSC = 0;
+    myRAW_TIMX->ARR = period - 1;
+    myRAW_TIMX->CCR1 = period / 2;
+    myRAW_TIMX->CCMR1 = 6 << 4;  // OC1M=110, PWMģʽ1
+    myRAW_TIMX->CCER = 1 << 0;   // CC1E
+    myRAW_TIMX->BDTR = 1 << 15;  // MOE, ߼ʱıȽܿ
+    myRAW_TIMX->EGR = 1 << 0;    // UG, װ PSC
+    myRAW_TIMX->CNT = 0;
+
+    g_raw_seq = 0;
+    g_raw_drop = 0;
+    g_raw_tx_half = myRAW_TX_NONE;
+    g_raw_state = myRAW_RUNNING;
+
+    myADC_ADCX->CR2 |= 1 << 0;    // ϵ ADC, ʱת
+    myRAW_TIMX->CR1 |= 1 << 0;    // ʱ
+}
+
+/**
+ * @brief       ֹͣԭʼ, ָ ADCDMA ʹ
+ *   @note       MODE TEXT|FRAME|OFF , ֮Ӧԭʷ; δʱֻȡ.
+ *              ADC ָΪת, һ myADC_DMA_enable() ճ
+ * @param       
+ * @retval      
+ */
+void myRAW_stop(void)
+{
+    if (g_raw_state != myRAW_RUNNING)
+    {
+        g_raw_state = myRAW_IDLE;
+        return;
+    }
+
+    __disable_irq(); /* ڼ DMA жϲٰԭʼ, Ҳܱͨݿ */
+    myRAW_TIMX->CR1 &= ~(1 << 0);        // ֹͣʱ
+    myADC_ADCX->CR2 &= ~(1 << 0);        // ر ADCX
+    myADC_ADCX_DMACx->CCR &= ~(1 << 0);  // ر ADC DMA 
+    myADC_ADCX_DMACx->CCR &= ~((1 << 5) | (1 << 2)); // ָδ, رհж
+    DMA1->IFCR |= 7 << 0;                //  DMA1_Channel1 ȫ־
+    myRAW_TX_DMACx->CCR &= ~(1 << 0);    // ֹڷ͵İ
+    myRAW_TX_DMACx_CLR_FLAGS();
+    HAL_NVIC_DisableIRQ(myRAW_TX_DMACx_IRQn);
+    USART1->CR3 &= ~USART_CR3_DMAT;
+    g_raw_tx_half = myRAW_TX_NONE;
+    g_raw_state = myRAW_IDLE;
+    __enable_irq();
+
+    while (__HAL_UART_GET_FLAG(&g_uart1_handle, UART_FLAG_TC) != SET)
+        ; /* λĴֽڷٸĲ */
+    USART1->BRR = g_raw_brr;
+
+    myADC_ADCX->CR2 = g_raw_cr2 & ~(1 << 0); // ָת, ADON һɼλ
+    myADC_set_smp(g_raw_smp);
+}
+
+/**
+ * @brief       һ뻺д: дͷ,  DMA 
+ *   @note      ڻڷһʱ, һ뼴 ADC , ֹ( g_raw_drop)ٷһ
+ * @param       half: 0, ǰһ; 1, һ
+ * @retval      
+ */
+static void myRAW_send_half(uint8_t half)
+{
+    uint8_t *h = g_raw_hdr[half], *p = h + 2;
+    uint8_t i, x = 0;
+
+    if (g_raw_tx_half != myRAW_TX_NONE)
+    {
+        myRAW_TX_DMACx->CCR &= ~(1 << 0); // ·, δİ
+        myRAW_TX_DMACx_CLR_FLAGS();
+        g_raw_drop++;
+    }
+
+    h[0] = myRAW_SYNC0;
+    h[1] = myRAW_SYNC1;
+    p = myFRAME_put_u16(p, g_raw_seq++);
+    p = myFRAME_put_u16(p, myRAW_HALF);
+    *p++ = g_raw_drop;
+    for (i = 2; i < myRAW_HEADER_SIZE - 1; i++)
+    {
+        x ^= h[i];
+    }
+    *p = x;
+
+    g_raw_tx_half = half;
+    g_raw_tx_data = 0;
+    myRAW_tx(h, myRAW_HEADER_SIZE);
+}
+
+/**
+ * @brief       ԭʼʱ ADC DMA жϴ
+ *   @note       ADC DMA жϷ myRAW_running() ʱ; ж־λʱȺ˳
+ * @param       
+ * @retval      
+ */
+void myRAW_adc_irq(void)
+{
+    uint32_t isr = DMA1->ISR;
+
+    DMA1->IFCR |= 7 << 0; //  DMA1_Channel1 ȫ//봫־
+    if (isr & (1 << 2))
+    {
+        myRAW_send_half(0); /* ǰһд, ADC ʼдһ */
+    }
+    if (isr & (1 << 1))
+    {
+        myRAW_send_half(1); /* һд, ADC صͷ */
+    }
+}
+
+/**
+ * @brief       ڷ DMA жϷ
+ *   @note      ͷŷһ; ݷһ뽻 ADC
+ * @param       
+ * @retval      
+ */
+void myRAW_TX_DMACx_IRQHandler(void)
+{
+    if (!myRAW_TX_DMACx_IS_TC())
+    {
+        return; /* ֹͺж */
+    }
+    myRAW_TX_DMACx_CLR_FLAGS();
+
+    if (g_raw_tx_half == myRAW_TX_NONE)
+    {
+        return;
+    }
+    if (!g_raw_tx_data)
+    {
+        g_raw_tx_data = 1;
+        myRAW_tx(&g_adc_dma_buf[g_raw_tx_half * myRAW_HALF], myRAW_HALF * 2);
+    }
+    else
+    {
+        g_raw_tx_half = myRAW_TX_NONE;
+    }
+}
@@ -0,0 +1,83 @@
+/**
+ ****************************************************************************************************
+ * @file        myRAW.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * ԭʼģʽ(MODE RAW): ƽ, ÿ ADC תڷλ, CPU 㴦
+ * 1, TIM1_CC1 ̶ڴ ADC ת, DMA1_Channel1 ѭд g_adc_dma_buf, ȫж
+ * 2, /ȫждһİͷ(ͬ֡š),  DMA1_Channel4(USART1_TX) ȷͷ,
+ *    ͷжٷһ; ݷ֮ǰһ鴮 DMA 
+ * 3, ADC дһʱڻû(·), ڷһϻᱻ: ֹη
+ *    (λյİ), 붪, ٷµһ; λŷֶʧ
+ * ʰ· myRAW_LINK_USE% ѡ, ʱ䰴 myADC_set_rate() ѡ
+ *
+ * ʽ: 0xA5 0xC3 |  u16 |  u16 | ۼֹ u8 | У u8 |   ADCֵ u16, С
+ * УΪͷ 2 ~ 6 ֽڵ;  myFRAME ֡(0xA5 0x5A)ֲͬͬ, λ
+ *
+ * ʱл myRAW_BAUD(Ӧԭʷ), ˳(MODE TEXT|FRAME|OFF)ʱָԭʺӦ;
+ * ڼ䴮ڱ DMA ռ, (Ӧң)ȫ
+ * TIM1_CH1 Ӧ PA8, δΪ, 
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef _MYRAW_H
+#define _MYRAW_H
+#include "./SYSTEM/sys/sys.h"
+#include "myADC.h"
+
+/******************************************************************************************/
+/* ʱ 
+ * ע: ADC1 ⲿ EXTSEL=000 ̶Ϊ TIM1_CC1 ¼
+ */
+
+#define myRAW_TIMX TIM1
+#define myRAW_TIMX_CLK_ENABLE()      \
+    do                               \
+    {                                \
+        __HAL_RCC_TIM1_CLK_ENABLE(); \
+    } while (0) /* TIM1 ʱʹ */
+#define myRAW_TIMX_CLK myCFG_TIM1_CLK /* TIM1  APB2 , 72MHz */
+
+/* ڷ DMA 
+ * ע: USART1_TX DMAֻͨ: DMA1_Channel4
+ */
+#define myRAW_TX_DMACx DMA1_Channel4
+#define myRAW_TX_DMACx_IRQn DMA1_Channel4_IRQn
+#define myRAW_TX_DMACx_IRQHandler DMA1_Channel4_IRQHandler
+#define myRAW_TX_DMACx_IS_TC() (DMA1->ISR & (1 << 13)) /* ж DMA1_Channel4 ɱ־ */
+#define myRAW_TX_DMACx_CLR_FLAGS() \
+    do                             \
+    {                              \
+        DMA1->IFCR |= 0xF << 12;   \
+    } while (0) /*  DMA1_Channel4 ȫ־ */
+
+/******************************************************************************************/
+/*  */
+
+#define myRAW_BAUD 2000000    /* ԭʼĲ: USART1 ʱ 72MHz / 36, ûзƵ; USB תоƬȶ */
+#define myRAW_UART_CLK myCFG_PCLK2 /* USART1  APB2  */
+#define myRAW_LINK_USE 95     /* ռ·İٷֱ, жӦ */
+#define myRAW_HALF (myADC_DMA_BUF_SIZE / 2) /* ÿ: g_adc_dma_buf һ */
+#define myRAW_HEADER_SIZE 8
+#define myRAW_SYNC0 0xA5
+#define myRAW_SYNC1 0xC3
+
+/******************************************************************************************/
+/* ⲿӿں*/
+
+uint32_t myRAW_request(void); /* ԭʼģʽ, ؽʹõĲ */
+uint8_t myRAW_pending(void);  /* ȴ */
+uint8_t myRAW_running(void);  /* ԭʼ */
+uint8_t myRAW_busy(void);     /* ȴ */
+void myRAW_start(void);       /* (ADCʱ) */
+void myRAW_stop(void);        /* ָֹͣ ADC ʹ */
+void myRAW_adc_irq(void);     /* ADC DMA /ȫжϵ */
+
+#endif
@@ -0,0 +1,349 @@
+/**
+ ****************************************************************************************************
+ * @file        mySWEEP.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ ****************************************************************************************************
+ */
+
+#include <math.h>
+#include "mySWEEP.h"
+#include "myPWM.h"
+#include "myEXTI.h"
+#include "myADC.h"
+#include "myFRAME.h"
+
+extern TIM_HandleTypeDef mygtimx_pwm_chy_handle; /*  myPWM.h Ķʱx */
+
+/* ɨƵ״̬ */
+#define mySWEEP_IDLE 0
+#define mySWEEP_PENDING 1
+#define mySWEEP_RUNNING 2
+
+static mySWEEP_STEP g_sweep_table[mySWEEP_MAX_STEPS];                 /* Ƶʱ, DMA ͻԴ */
+static uint32_t g_sweep_freq[mySWEEP_MAX_STEPS];                      /* ʵƵ, Hz */
+static uint16_t g_sweep_psc = 0;                                      /* ɨƵõķƵϵ */
+static uint8_t g_sweep_steps = 0;                                     /* Ƶʱ, 0 ʾδ */
+static uint16_t g_sweep_samples = 32;                                 /* ÿƵʵĲ */
+static uint16_t g_sweep_seq = 0;                                      /* ɨƵ */
+static volatile uint8_t g_sweep_state = mySWEEP_IDLE;                 /* ɨƵ״̬ */
+static myPWM_GPIO_MODE g_sweep_gpio_mode;                             /* ɨƵǰ PWM ģʽ */
+static uint16_t g_sweep_buf[mySWEEP_MAX_STEPS * mySWEEP_MAX_SAMPLES]; /* ADC DMA , Ƶʷֶ */
+static uint16_t g_sweep_mean[mySWEEP_MAX_STEPS];                      /* Ƶʵľֵ */
+static uint16_t g_sweep_rms[mySWEEP_MAX_STEPS];                       /* ƵʵĽЧֵ */
+
+/**
+ * @brief       Ƶʱ
+ *   @note      ƵȷõķƵϵ, ټÿ ARR  CCR1, ռձʹõǰ g_mypwm_duty;
+ *              ɨƵв޸
+ * @param       freq : Ƶʱ, Hz, ÿ myPWM_FREQ_MIN ~ myPWM_FREQ_MAX ֮
+ * @param       steps: Ƶʸ, 2 ~ mySWEEP_MAX_STEPS
+ * @retval      0, ɹ; 1, ΧɨƵ
+ */
+uint8_t mySWEEP_set_table(const uint32_t *freq, uint8_t steps)
+{
+    uint32_t f_min = myPWM_FREQ_MAX, psc;
+    uint8_t i;
+
+    if (steps < 2 || steps > mySWEEP_MAX_STEPS || g_sweep_state != mySWEEP_IDLE)
+    {
+        return 1;
+    }
+    for (i = 0; i < steps; i++)
+    {
+        if (freq[i] < myPWM_FREQ_MIN || freq[i] > myPWM_FREQ_MAX)
+        {
+            return 1;
+        }
+        if (freq[i] < f_min)
+        {
+            f_min = freq[i];
+        }
+    }
+
+    psc = (myPWM_TIM_CLK / f_min - 1) / 65536; // ֤Ƶʵ arr <= 65535
+    for (i = 0; i < steps; i++)
+    {
+        uint32_t arr = myPWM_TIM_CLK / (psc + 1) / freq[i] - 1;
+
+        if (arr < mySWEEP_ARR_MIN)
+        {
+            return 1; /* Ƶʿ̫, Ƶʵķֱʲ */
+        }
+    }
+
+    for (i = 0; i < steps; i++)
+    {
+        uint32_t arr = myPWM_TIM_CLK / (psc + 1) / freq[i] - 1;
+
+        g_sweep_table[i].arr = (uint16_t)arr;
+        g_sweep_table[i].rcr = 0;
+        g_sweep_table[i].ccr = (uint16_t)((arr + 1) * g_mypwm_duty / 1000);
+        g_sweep_freq[i] = (myPWM_TIM_CLK / (psc + 1) + (arr + 1) / 2) / (arr + 1); // ʵƵ, 
+    }
+    g_sweep_psc = (uint16_t)psc;
+    g_sweep_steps = steps;
+    return 0;
+}
+
+/**
+ * @brief       Ƶʱ
+ *   @note      f_start Դ f_stop(Ӹߵɨ); ֻʱһ
+ * @param       f_start: ʼƵ, Hz
+ * @param       f_stop : ֹƵ, Hz
+ * @param       steps  : Ƶʸ, 2 ~ mySWEEP_MAX_STEPS
+ * @retval      0, ɹ; 1, ΧɨƵ
+ */
+uint8_t mySWEEP_set_log(uint32_t f_start, uint32_t f_stop, uint8_t steps)
+{
+    uint32_t freq[mySWEEP_MAX_STEPS];
+    float ratio, f;
+    uint8_t i;
+
+    if (steps < 2 || steps > mySWEEP_MAX_STEPS || f_start < myPWM_FREQ_MIN || f_stop < myPWM_FREQ_MIN)
+    {
+        return 1;
+    }
+
+    ratio = powf((float)f_stop / (float)f_start, 1.0f / (float)(steps - 1)); // Ƶʱ
+    f = (float)f_start;
+    for (i = 0; i < steps; i++)
+    {
+        freq[i] = (uint32_t)(f + 0.5f);
+        f *= ratio;
+    }
+    freq[steps - 1] = f_stop; /* ۳ */
+
+    return mySWEEP_set_table(freq, steps);
+}
+
+/**
+ * @brief       ǰƵʱ
+ * @param       
+ * @retval      Ƶʸ, 0 ʾδ
+ */
+uint8_t mySWEEP_steps(void)
+{
+    return g_sweep_steps;
+}
+
+/**
+ * @brief       һɨƵ, ѭ֮
+ *   @note      δƵʱʱʹĬϵ 1kHz ~ 100kHz 16
+ * @param       samples: ÿƵʵĲ,  mySWEEP_MIN_SAMPLES ~ mySWEEP_MAX_SAMPLES
+ * @retval      
+ */
+void mySWEEP_request(uint16_t samples)
+{
+    if (g_sweep_state != mySWEEP_IDLE)
+    {
+        return;
+    }
+    if (g_sweep_steps == 0)
+    {
+        mySWEEP_set_log(mySWEEP_DEFAULT_START, mySWEEP_DEFAULT_STOP, mySWEEP_DEFAULT_STEPS);
+    }
+
+    if (samples < mySWEEP_MIN_SAMPLES)
+    {
+        samples = mySWEEP_MIN_SAMPLES;
+    }
+    if (samples > mySWEEP_MAX_SAMPLES)
+    {
+        samples = mySWEEP_MAX_SAMPLES;
+    }
+    g_sweep_samples = samples;
+    g_sweep_state = mySWEEP_PENDING;
+}
+
+/**
+ * @brief       ɨƵȴ
+ * @param       
+ * @retval      0, ; 1, 
+ */
+uint8_t mySWEEP_pending(void)
+{
+    return g_sweep_state == mySWEEP_PENDING;
+}
+
+/**
+ * @brief       ɨƵ
+ * @param       
+ * @retval      0, ; 1, 
+ */
+uint8_t mySWEEP_running(void)
+{
+    return g_sweep_state == mySWEEP_RUNNING;
+}
+
+/**
+ * @brief       ɨƵȴڽ
+ *   @note      ִʱݴ˾ܾ޸ PWM Ͳ
+ * @param       
+ * @retval      0, ; 1, 
+ */
+uint8_t mySWEEP_busy(void)
+{
+    return g_sweep_state != mySWEEP_IDLE;
+}
+
+/**
+ * @brief       ɨƵ
+ *   @note       ADC (һѴ)ʱ; Ƶȫ TIM5 -> TIM3 -> DMA ,
+ *              CPU ֻɨƵʱһ ADC DMA ж.
+ *              úüĴ, ֹHALPWM޸
+ * @param       
+ * @retval      
+ */
+void mySWEEP_start(void)
+{
+    uint16_t conv = myADC_conv_cycles(); // ADCתʱ, CPU
+
+    mySWEEP_DWELL_TIM_CLK_ENABLE();
+
+    g_sweep_gpio_mode = g_mypwm_gpio_mode;
+    myPWM_GPIO_SetMode(myPWM_GPIO_MODE_PWM); // ɨƵҪ PWM 
+
+    /* פʱ: ÿ = һADCת, ÿ samples һ;
+     *  MMS=ʹ ģʽװ PSC,  UG  TRGO ǰ TIM3 */
+    mySWEEP_DWELL_TIM->CR1 = 0;
+    mySWEEP_DWELL_TIM->CR2 = 1 << 4; // MMS=001, TRGO = CNT_EN
+    mySWEEP_DWELL_TIM->PSC = conv - 1;
+    mySWEEP_DWELL_TIM->ARR = g_sweep_samples - 1;
+    mySWEEP_DWELL_TIM->EGR = 1 << 0; // UG, װ PSC
+    mySWEEP_DWELL_TIM->SR = 0;
+    mySWEEP_DWELL_TIM->CNT = 0;
+    mySWEEP_DWELL_TIM->CR2 = 2 << 4; // MMS=010, TRGO = ¼
+
+    /* TIM3 Ƶʱ0ʼ */
+    __HAL_TIM_DISABLE(&mygtimx_pwm_chy_handle);
+    GTIM_TIMX_PWM->PSC = g_sweep_psc;
+    GTIM_TIMX_PWM->ARR = g_sweep_table[0].arr;
+    GTIM_TIMX_PWM_CHY_CCRX = g_sweep_table[0].ccr;
+    GTIM_TIMX_PWM->CCMR1 &= ~(1 << 3); // ر OC1PE, DMA д CCR1 Ч
+    GTIM_TIMX_PWM->EGR = 1 << 0;       // UG, װ PSC
+    GTIM_TIMX_PWM->CNT = 0;
+    GTIM_TIMX_PWM->DCR = (2 << 8) | mySWEEP_DBA_ARR;           // ͻ 3 : ARR, RCR, CCR1
+    GTIM_TIMX_PWM->SMCR = (mySWEEP_DWELL_TS << 4) | (4 << 0); // TS=ITR2, SMS=100 λģʽ
+    GTIM_TIMX_PWM->DIER |= 1 << 14;                            // TDE, ¼ DMA
+
+    /* Ƶ DMA: Ƶʱ1 -> TIM3_DMAR */
+    mySWEEP_DMACx->CCR &= ~(1 << 0); // ر DMA 
+    while (mySWEEP_DMACx->CCR & (1 << 0))
+        ;
+    mySWEEP_DMACx->CPAR = (uint32_t)&GTIM_TIMX_PWM->DMAR;
+    mySWEEP_DMACx->CMAR = (uint32_t)&g_sweep_table[1];
+    mySWEEP_DMACx->CNDTR = (g_sweep_steps - 1) * 3;
+    mySWEEP_DMACx->CCR = (1 << 4) | (1 << 7) | (1 << 8) | (1 << 10) | (2 << 12); // 洢, 洢, 16λ, ȼ
+    mySWEEP_DMACx->CCR |= 1 << 0;                                                 //  DMA 
+
+    __HAL_TIM_ENABLE(&mygtimx_pwm_chy_handle);
+
+    g_sweep_state = mySWEEP_RUNNING;
+    myADC_DMA_enable_buf((uint32_t)g_sweep_buf, g_sweep_steps * g_sweep_samples); // ת
+    mySWEEP_DWELL_TIM->CR1 |= 1 << 0;                                               // פʱ
+}
+
+/* ƽ */
+static uint32_t mySWEEP_isqrt(uint32_t x)
+{
+    uint32_t r = 0, bit = 1UL << 30;
+
+    while (bit > x)
+    {
+        bit >>= 2;
+    }
+    while (bit)
+    {
+        if (x >= r + bit)
+        {
+            x -= r + bit;
+            r = (r >> 1) + bit;
+        }
+        else
+        {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return r;
+}
+
+/**
+ * @brief       ɨƵɼɺ: ָ PWM, ƵʵľֵЧֵƵ֡
+ *   @note      ADC DMA жλ g_adc_dma_start  mySWEEP_running() ʱѭ
+ * @param       
+ * @retval      
+ */
+void mySWEEP_finish(void)
+{
+    uint8_t payload[mySWEEP_PAYLOAD_SIZE(mySWEEP_MAX_STEPS)];
+    uint16_t settle = g_sweep_samples / mySWEEP_SETTLE_DIV;
+    uint16_t n = g_sweep_samples - settle;
+    uint8_t k;
+
+    /* ֹͣƵ·, ָ TIM3 ͨ PWM */
+    mySWEEP_DWELL_TIM->CR1 &= ~(1 << 0);
+    mySWEEP_DMACx->CCR &= ~(1 << 0);
+    GTIM_TIMX_PWM->SMCR = 0;
+    GTIM_TIMX_PWM->DIER &= ~(1 << 14);
+    GTIM_TIMX_PWM->DCR = 0;
+    GTIM_TIMX_PWM->CCMR1 |= 1 << 3;
+    myPWM_set_freq(g_mypwm_freq, g_mypwm_duty); // ָɨƵǰƵ
+    myPWM_GPIO_SetMode(g_sweep_gpio_mode);
+
+    for (k = 0; k < g_sweep_steps; k++)
+    {
+        const uint16_t *p = &g_sweep_buf[k * g_sweep_samples + settle];
+        uint32_t sum = 0;
+        uint64_t sum2 = 0, var;
+        uint16_t i;
+
+        for (i = 0; i < n; i++)
+        {
+            sum += p[i];
+            sum2 += (uint32_t)p[i] * p[i];
+        }
+        var = (sum2 - (uint64_t)sum * sum / n) / n; //  = E[x^2] - E[x]^2
+        g_sweep_mean[k] = (uint16_t)((sum + n / 2) / n);
+        g_sweep_rms[k] = (uint16_t)mySWEEP_isqrt((uint32_t)var);
+    }
+
+    g_sweep_seq++;
+    g_sweep_state = mySWEEP_IDLE;
+    myFRAME_send(myFRAME_TYPE_SPECTRUM, payload, mySWEEP_serialize(payload));
+}
+
+/**
+ * @brief       Ƶ׼¼л(С)
+ *   @note      ظʽ:
+ *              汾(u8) Ƶ(u8) ÿƵʲ(u16) (u16) ADC(u32) ɨƵ(u16)
+ *              Ƶ: ʵƵHz(u32) ADCֵ(u16) Чֵ(u16, ADC)
+ * @param       buf: ,  mySWEEP_PAYLOAD_SIZE(Ƶ)
+ * @retval      س
+ */
+uint16_t mySWEEP_serialize(uint8_t *buf)
+{
+    uint8_t *p = buf;
+    uint8_t k;
+
+    *p++ = mySWEEP_VERSION;
+    *p++ = g_sweep_steps;
+    p = myFRAME_put_u16(p, g_sweep_samples);
+    p = myFRAME_put_u16(p, g_sweep_samples / mySWEEP_SETTLE_DIV);
+    p = myFRAME_put_u32(p, g_myadc_rate);
+    p = myFRAME_put_u16(p, g_sweep_seq);
+    for (k = 0; k < g_sweep_steps; k++)
+    {
+        p = myFRAME_put_u32(p, g_sweep_freq[k]);
+        p = myFRAME_put_u16(p, g_sweep_mean[k]);
+        p = myFRAME_put_u16(p, g_sweep_rms[k]);
+    }
+    return (uint16_t)(p - buf);
+}
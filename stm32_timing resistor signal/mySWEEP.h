@@ -0,0 +1,89 @@
+/**
+ ****************************************************************************************************
+ * @file        mySWEEP.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * PWM ƵɨƵ: Ƶʱθı TIM3 ļƵ, ÿƵʲɼһ ADC ,
+ * һɨƵ myFRAME_TYPE_SPECTRUM ֡͸ƵµľֵͽЧֵ
+ *
+ * Ƶռ CPU:
+ * 1, TIM5 Ϊפʱ, ʱ = ADCתʱ, ÿ samples תһ, TRGO ¼
+ * 2, TIM3 ڸλģʽ, Դ ITR2(TIM5 TRGO): ÿδλ, һ DMA ͻ
+ * 3, DMA1_Channel6(TIM3_TRIG) Ƶʱһ {ARR, RCR, CCR1}  TIM3_DMAR ͻд
+ *    (TIM3 ûظ, RCR λõд뱻)
+ * ADC ת TIM5 ͬʱ,  k ƵʶӦ DMA еĵ k , ÿζͷ
+ * 1/mySWEEP_SETTLE_DIV (ʱ)ֵЧֵ
+ *
+ * ɨƵʹͬһ PSC, Ƶʾ, Ƶʲʹ ARR С mySWEEP_ARR_MIN
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef _MYSWEEP_H
+#define _MYSWEEP_H
+#include "./SYSTEM/sys/sys.h"
+
+/******************************************************************************************/
+/* פʱ 
+ * ע: TIM3 ģʽ ITR2 ̶ TIM5  TRGO, פʱͬʱ޸ mySWEEP_DWELL_TS
+ */
+
+#define mySWEEP_DWELL_TIM TIM5
+#define mySWEEP_DWELL_TIM_CLK_ENABLE() \
+    do                                 \
+    {                                  \
+        __HAL_RCC_TIM5_CLK_ENABLE();   \
+    } while (0) /* TIM5 ʱʹ */
+#define mySWEEP_DWELL_TS 2 /* TIM3 SMCR.TS: ITR2 = TIM5 TRGO */
+
+/* Ƶ DMA 
+ * ע: TIM3_TRIG DMAֻͨ: DMA1_Channel6
+ */
+#define mySWEEP_DMACx DMA1_Channel6
+#define mySWEEP_DBA_ARR 11 /* TIM3_ARR  TIM3_CR1 ƫ / 4, DMA ͻʼĴ */
+
+/******************************************************************************************/
+/*  */
+
+#define mySWEEP_MAX_STEPS 30       /* Ƶʱ󳤶, ܵ֡ */
+#define mySWEEP_MAX_SAMPLES 64     /* ÿƵʵ */
+#define mySWEEP_MIN_SAMPLES 8      /* ÿƵʵС */
+#define mySWEEP_SETTLE_DIV 4       /* ÿοͷ 1/4  */
+#define mySWEEP_ARR_MIN 9          /* ƵµСװֵ, ֤ռձȷֱ */
+#define mySWEEP_VERSION 1          /* Ƶ׸ظʽ汾 */
+#define mySWEEP_DEFAULT_START 1000 /* δƵʱʱʹõĬɨƵ: 1kHz ~ 100kHz, 16 */
+#define mySWEEP_DEFAULT_STOP 100000
+#define mySWEEP_DEFAULT_STEPS 16
+
+/* Ƶʱһ, ˳ TIM3  ARRRCRCCR1 Ĵһ,  DMA ͻֱд */
+typedef struct
+{
+    uint16_t arr;
+    uint16_t rcr; /* TIM3 ޴˼Ĵ, ռλ */
+    uint16_t ccr;
+} mySWEEP_STEP;
+
+/* Ƶ׸س: 汾 +  + ÿ +  +  +  + Ƶ(Ƶu32 ֵu16 Чֵu16) */
+#define mySWEEP_PAYLOAD_SIZE(steps) (12 + (steps) * 8)
+
+/******************************************************************************************/
+/* ⲿӿں*/
+
+uint8_t mySWEEP_set_table(const uint32_t *freq, uint8_t steps);            /* Ƶʱ */
+uint8_t mySWEEP_set_log(uint32_t f_start, uint32_t f_stop, uint8_t steps); /* Ƶʱ */
+uint8_t mySWEEP_steps(void);                                               /* ǰƵʱ */
+void mySWEEP_request(uint16_t samples);                                    /* һɨƵ */
+uint8_t mySWEEP_pending(void);                                             /* ɨƵȴ */
+uint8_t mySWEEP_running(void);                                             /* ɨƵ */
+uint8_t mySWEEP_busy(void);                                                /* ɨƵȴڽ */
+void mySWEEP_start(void);                                                  /* ɨƵ(ADCʱ) */
+void mySWEEP_finish(void);                                                 /* ɨƵɼɺ */
+uint16_t mySWEEP_serialize(uint8_t *buf);                                  /* Ƶ׼¼л */
+
+#endif
@@ -0,0 +1,525 @@
+/**
+ ****************************************************************************************************
+ * @file        myTASK.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ ****************************************************************************************************
+ */
+
+#include "myTASK.h"
+
+#if myTASK_RTOS
+
+#include <stdio.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "./SYSTEM/usart/usart.h"
+#include "./BSP/LED/led.h"
+#include "myADC.h"
+#include "myCMD.h"
+#include "myPROF.h"
+#include "mySWEEP.h"
+#include "myTUNE.h"
+#include "myRAW.h"
+#include "myLINK.h"
+#include "myVALID.h"
+
+extern uint8_t g_adc_dma_start; /* DMA״̬־, 0,δ; 1,  */
+extern void xPortSysTickHandler(void);
+
+/* һ */
+typedef struct
+{
+    uint16_t *buf;   /* ݿ黺 */
+    uint16_t len;    /*  */
+    uint32_t t_post; /* ʱ, CYCCNT */
+} myTASK_BLOCK;
+
+/* Ͷһ */
+typedef struct
+{
+    uint8_t *buf;    /* ͻ */
+    uint16_t len;    /* ֽ */
+    uint32_t t_post; /* ʱ, CYCCNT */
+} myTASK_TX;
+
+myTASK_STATS g_mytask_stats; /* ͳ */
+
+static TaskHandle_t g_task_acq = NULL;               /* ɼ, жϾݴ˷֪ͨ */
+static volatile uint32_t g_task_adc_t = 0;           /* һ ADC DMA жϵʱ */
+static QueueHandle_t g_task_block_free, g_task_block_full; /* ݿ:  /  */
+static QueueHandle_t g_task_tx_free, g_task_tx_full;       /* ͻ:  /  */
+
+/*  */
+static uint16_t g_task_blocks[myTASK_BLOCKS][myADC_DMA_BUF_SIZE];
+static uint8_t g_task_tx_bufs[myTASK_TX_BUFS][myTASK_TX_SIZE];
+
+/* Ͷеľ̬洢 */
+static StaticTask_t g_task_acq_tcb, g_task_proc_tcb, g_task_tx_tcb, g_task_idle_tcb;
+static StackType_t g_task_acq_stack[myTASK_ACQ_STACK];
+static StackType_t g_task_proc_stack[myTASK_PROC_STACK];
+static StackType_t g_task_tx_stack[myTASK_TX_STACK];
+static StackType_t g_task_idle_stack[configMINIMAL_STACK_SIZE];
+static StaticQueue_t g_task_queue_cb[4];
+static uint8_t g_task_block_free_q[myTASK_BLOCKS * sizeof(uint16_t *)];
+static uint8_t g_task_block_full_q[myTASK_BLOCKS * sizeof(myTASK_BLOCK)];
+static uint8_t g_task_tx_free_q[myTASK_TX_BUFS * sizeof(uint8_t *)];
+static uint8_t g_task_tx_full_q[myTASK_TX_BUFS * sizeof(myTASK_TX)];
+
+/**
+ * @brief       ¼һ
+ * @param       id     : 
+ * @param       latency: ӳ, CPU
+ * @param       exec   : кʱ, CPU
+ * @retval      
+ */
+static void myTASK_record(myTASK_ID id, uint32_t latency, uint32_t exec)
+{
+    myTASK_SPAN *span = &g_mytask_stats.task[id];
+
+    taskENTER_CRITICAL(); /* ͳƿл */
+    span->count++;
+    span->lat_sum += latency;
+    if (latency > span->lat_max)
+    {
+        span->lat_max = latency;
+    }
+    if (exec > span->exec_max)
+    {
+        span->exec_max = exec;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief       ɼ: /ݿɼ, ִ, ƽɨƵ
+ *   @note      ʱɼڵȴ; ɼ޵ȴ DMA ֪ͨ.
+ *              ADC  PWM ֻ޸, Ҳִ, Ҫ
+ * @param       arg: δʹ
+ * @retval      
+ */
+static void myTASK_acq(void *arg)
+{
+    TickType_t last = xTaskGetTickCount(); /* һɼʱ */
+    uint16_t *buf = NULL; /* ڲɼݿ */
+    uint16_t len = 0;
+    uint8_t busy = 0, stalled = 0;
+
+    (void)arg;
+    if (xQueueReceive(g_task_block_free, &buf, 0) == pdPASS)
+    {
+        len = g_mycmd_cfg.avg_depth;
+        busy = 1;
+        myADC_DMA_enable_buf((uint32_t)buf, len); /* ѭһȲɼһ, ϵ֮ */
+    }
+    while (1)
+    {
+        TickType_t wait = portMAX_DELAY, elapsed;
+        uint32_t evt = 0, t0;
+
+        if (!busy && !stalled && !myRAW_busy())
+        {
+            elapsed = xTaskGetTickCount() - last;
+            wait = elapsed >= pdMS_TO_TICKS(g_mycmd_cfg.period_ms) ? 0 : pdMS_TO_TICKS(g_mycmd_cfg.period_ms) - elapsed;
+        }
+        xTaskNotifyWait(0, 0xFFFFFFFF, &evt, wait);
+        t0 = myPROF_CYCCNT();
+
+        if (evt & myTASK_EVT_CMD)
+        {
+            myCMD_poll(); /* ޸ĵôһݿʼЧ */
+        }
+
+        if (g_adc_dma_start == 1)
+        {
+            g_adc_dma_start = 0;
+            if (mySWEEP_running())
+            {
+                mySWEEP_finish();
+                busy = 0;
+            }
+            else if (myTUNE_running())
+            {
+                busy = myTUNE_step();
+            }
+            else
+            {
+                myTASK_BLOCK blk = {buf, len, myPROF_CYCCNT()};
+
+                xQueueSend(g_task_block_full, &blk, 0); /* гȵڻ,  */
+                buf = NULL;
+                busy = 0;
+            }
+        }
+
+        if (!busy && mySWEEP_pending())
+        {
+            busy = 1;
+            mySWEEP_start();
+        }
+        if (!busy && myTUNE_pending())
+        {
+            busy = 1;
+            myTUNE_start();
+        }
+        if (!busy && myRAW_pending())
+        {
+            myRAW_start(); /* ԭʼڼֻȴ */
+        }
+        if (!busy && !myRAW_busy() && xTaskGetTickCount() - last >= pdMS_TO_TICKS(g_mycmd_cfg.period_ms))
+        {
+            if (xQueueReceive(g_task_block_free, &buf, 0) == pdPASS)
+            {
+                last = xTaskGetTickCount();
+                len = g_mycmd_cfg.avg_depth;
+                busy = 1;
+                stalled = 0;
+                myADC_DMA_enable_buf((uint32_t)buf, len); /* һADC DMAɼ */
+            }
+            else if (!stalled)
+            {
+                stalled = 1; /* ȴ黹(myTASK_EVT_FREE) */
+                g_mytask_stats.acq_stall++;
+            }
+        }
+
+        myTASK_record(myTASK_ID_ACQ, (evt & myTASK_EVT_ADC) ? t0 - g_task_adc_t : 0, myPROF_CYCCNT() - t0);
+    }
+}
+
+/**
+ * @brief       : ƽֵ, ʽ󽻸
+ * @param       arg: δʹ
+ * @retval      
+ */
+static void myTASK_proc(void *arg)
+{
+    uint8_t report_cnt = 0;
+
+    (void)arg;
+    while (1)
+    {
+        myTASK_BLOCK blk;
+        uint32_t adc_sum = 0, adc_value, t0;
+        float voltage, R;
+        uint16_t i;
+        uint8_t flags;
+
+        xQueueReceive(g_task_block_full, &blk, portMAX_DELAY);
+        t0 = myPROF_CYCCNT();
+        myPROF_BEGIN(myPROF_STAGE_LOOP);
+
+        myPROF_BEGIN(myPROF_STAGE_AVERAGE);
+        for (i = 0; i < blk.len; i++)
+        {
+            adc_sum += blk.buf[i];
+        }
+        adc_value = adc_sum / blk.len; // ֵ
+        myPROF_END(myPROF_STAGE_AVERAGE);
+
+        xQueueSend(g_task_block_free, &blk.buf, 0); /* Ѿ, 黹ɼ */
+        xTaskNotify(g_task_acq, myTASK_EVT_FREE, eSetBits);
+
+        myPROF_BEGIN(myPROF_STAGE_CONVERT);
+        voltage = (float)adc_value * (3.3f / 4096);
+        R = (3.26 - voltage) * 4.96 / voltage;
+        myPROF_END(myPROF_STAGE_CONVERT);
+        flags = myVALID_sample(HAL_GetTick(), adc_sum, blk.len, R);
+        if (!flags)
+        {
+            myTUNE_track(R);
+        }
+
+        myPROF_BEGIN(myPROF_STAGE_PRINTF);
+        if (!myVALID_output(flags))
+        {
+            /* DROP: 㲻 */
+        }
+        else if (g_mycmd_cfg.stream == myCMD_STREAM_TEXT)
+        {
+            uint8_t *out = myTASK_tx_alloc();
+
+            if (out)
+            {
+                myTASK_tx_post(out, (uint16_t)(flags ? snprintf((char *)out, myTASK_TX_SIZE, "%.4f !%02X\n", R, flags)
+                                                     : snprintf((char *)out, myTASK_TX_SIZE, "%.4f\n", R)));
+            }
+        }
+        else if (g_mycmd_cfg.stream == myCMD_STREAM_FRAME)
+        {
+            uint8_t payload[13], *p = payload;
+            uint32_t r_bits;
+
+            memcpy(&r_bits, &R, sizeof(r_bits)); // float  IEEE754 λģʽ
+            p = myFRAME_put_u32(p, HAL_GetTick());
+            p = myFRAME_put_u16(p, (uint16_t)adc_value);
+            p = myFRAME_put_u16(p, blk.len);
+            p = myFRAME_put_u32(p, r_bits);
+            *p++ = flags;
+            myFRAME_send(myFRAME_TYPE_SAMPLE, payload, (uint16_t)(p - payload));
+        }
+        myPROF_END(myPROF_STAGE_PRINTF);
+
+        myPROF_END(myPROF_STAGE_LOOP);
+        if (++report_cnt >= myPROF_REPORT_PERIOD)
+        {
+            report_cnt = 0;
+            myPROF_report();
+            myTASK_report();
+        }
+        LED0_TOGGLE();
+
+        myTASK_record(myTASK_ID_PROC, t0 - blk.t_post, myPROF_CYCCNT() - t0);
+    }
+}
+
+/**
+ * @brief       : ռλ·(ڻUSB), ηıкͶ֡
+ * @param       arg: δʹ
+ * @retval      
+ */
+static void myTASK_tx(void *arg)
+{
+    (void)arg;
+    while (1)
+    {
+        myTASK_TX tx;
+        uint32_t t0;
+
+        xQueueReceive(g_task_tx_full, &tx, portMAX_DELAY);
+        t0 = myPROF_CYCCNT();
+        myLINK_write(tx.buf, tx.len); /* ȴڼȼճ */
+        xQueueSend(g_task_tx_free, &tx.buf, 0);
+        myTASK_record(myTASK_ID_TX, t0 - tx.t_post, myPROF_CYCCNT() - t0);
+    }
+}
+
+/**
+ * @brief       Ͷ, 
+ *   @note       main() ʼ, ѭ, 
+ * @param       
+ * @retval      
+ */
+void myTASK_start(void)
+{
+    uint8_t i;
+
+    g_task_block_free = xQueueCreateStatic(myTASK_BLOCKS, sizeof(uint16_t *), g_task_block_free_q, &g_task_queue_cb[0]);
+    g_task_block_full = xQueueCreateStatic(myTASK_BLOCKS, sizeof(myTASK_BLOCK), g_task_block_full_q, &g_task_queue_cb[1]);
+    g_task_tx_free = xQueueCreateStatic(myTASK_TX_BUFS, sizeof(uint8_t *), g_task_tx_free_q, &g_task_queue_cb[2]);
+    g_task_tx_full = xQueueCreateStatic(myTASK_TX_BUFS, sizeof(myTASK_TX), g_task_tx_full_q, &g_task_queue_cb[3]);
+    for (i = 0; i < myTASK_BLOCKS; i++)
+    {
+        uint16_t *p = g_task_blocks[i];
+
+        xQueueSend(g_task_block_free, &p, 0);
+    }
+    for (i = 0; i < myTASK_TX_BUFS; i++)
+    {
+        uint8_t *p = g_task_tx_bufs[i];
+
+        xQueueSend(g_task_tx_free, &p, 0);
+    }
+    memset(&g_mytask_stats, 0, sizeof(g_mytask_stats));
+
+    g_task_acq = xTaskCreateStatic(myTASK_acq, "acq", myTASK_ACQ_STACK, NULL, myTASK_ACQ_PRIO, g_task_acq_stack,
+                                   &g_task_acq_tcb);
+    xTaskCreateStatic(myTASK_proc, "proc", myTASK_PROC_STACK, NULL, myTASK_PROC_PRIO, g_task_proc_stack,
+                      &g_task_proc_tcb);
+    xTaskCreateStatic(myTASK_tx, "tx", myTASK_TX_STACK, NULL, myTASK_TX_PRIO, g_task_tx_stack, &g_task_tx_tcb);
+
+    vTaskStartScheduler();
+    while (1)
+        ; /* ̬ʱʧ */
+}
+
+/**
+ * @brief       
+ *   @note      ǰ(ʼ׶)ֱ
+ * @param       
+ * @retval      0, ; 1, 
+ */
+uint8_t myTASK_running(void)
+{
+    return xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED;
+}
+
+/**
+ * @brief       ж֪ͨɼ
+ *   @note      жռȼܸ configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+ * @param       evt: myTASK_EVT_ADC / myTASK_EVT_CMD
+ * @param       now: жʱ CYCCNT, ͳƲɼĻӳ
+ * @retval      
+ */
+void myTASK_notify_isr(uint32_t evt, uint32_t now)
+{
+    BaseType_t woken = pdFALSE;
+
+    if (g_task_acq == NULL)
+    {
+        return;
+    }
+    if (evt & myTASK_EVT_ADC)
+    {
+        g_task_adc_t = now;
+    }
+    xTaskNotifyFromISR(g_task_acq, evt, eSetBits, &woken);
+    portYIELD_FROM_ISR(woken); /* ɼȼ, жϷغֱлȥ */
+}
+
+/**
+ * @brief       SysTick жϵ, ƽں˽
+ * @param       
+ * @retval      
+ */
+void myTASK_tick(void)
+{
+    if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED)
+    {
+        xPortSysTickHandler();
+    }
+}
+
+/**
+ * @brief       ȡһзͻ
+ *   @note      ȴ myTASK_TX_WAIT_MS, ڻѹʱ
+ * @param       
+ * @retval      ,  myTASK_TX_SIZE; NULL ʾûпл
+ */
+uint8_t *myTASK_tx_alloc(void)
+{
+    uint8_t *buf;
+
+    if (xQueueReceive(g_task_tx_free, &buf, pdMS_TO_TICKS(myTASK_TX_WAIT_MS)) != pdPASS)
+    {
+        taskENTER_CRITICAL();
+        g_mytask_stats.tx_drop++;
+        taskEXIT_CRITICAL();
+        return NULL;
+    }
+    return buf;
+}
+
+/**
+ * @brief       
+ * @param       buf: myTASK_tx_alloc() ȡõĻ
+ * @param       len: ֽ
+ * @retval      
+ */
+void myTASK_tx_post(uint8_t *buf, uint16_t len)
+{
+    myTASK_TX tx = {buf, len, myPROF_CYCCNT()};
+
+    xQueueSend(g_task_tx_full, &tx, 0); /* гȵڻ,  */
+}
+
+/**
+ * @brief       ֡ŷ䵽ֹ֮л, ֤֡˳
+ * @param       
+ * @retval      
+ */
+void myTASK_tx_lock(void)
+{
+    vTaskSuspendAll();
+}
+
+void myTASK_tx_unlock(void)
+{
+    xTaskResumeAll();
+}
+
+/**
+ * @brief       ȴȫ
+ *   @note      ȡȫзͻ漴˵ûд͵, ԭ黹; ԭʼлǰ
+ * @param       
+ * @retval      
+ */
+void myTASK_tx_flush(void)
+{
+    uint8_t *bufs[myTASK_TX_BUFS];
+    uint8_t i;
+
+    if (!myTASK_running())
+    {
+        return;
+    }
+    for (i = 0; i < myTASK_TX_BUFS; i++)
+    {
+        xQueueReceive(g_task_tx_free, &bufs[i], portMAX_DELAY);
+    }
+    for (i = 0; i < myTASK_TX_BUFS; i++)
+    {
+        xQueueSend(g_task_tx_free, &bufs[i], 0);
+    }
+}
+
+/**
+ * @brief       ͳл(С)
+ *   @note      ظʽ:
+ *              汾(u8) (u8) Ƶ(u32)
+ *              (ɼ): (u32) ӳ(u32) ƽӳ(u32) кʱ(u32)
+ *              ɼȴл(u32) (u32)
+ * @param       buf: ,  myTASK_PAYLOAD_SIZE
+ * @retval      س
+ */
+uint16_t myTASK_serialize(uint8_t *buf)
+{
+    uint8_t *p = buf;
+    uint8_t i;
+
+    taskENTER_CRITICAL();
+    *p++ = myTASK_VERSION;
+    *p++ = myTASK_ID_NUM;
+    p = myFRAME_put_u32(p, myPROF_CPU_HZ);
+    for (i = 0; i < myTASK_ID_NUM; i++)
+    {
+        myTASK_SPAN *span = &g_mytask_stats.task[i];
+
+        p = myFRAME_put_u32(p, span->count);
+        p = myFRAME_put_u32(p, span->lat_max);
+        p = myFRAME_put_u32(p, span->count ? (uint32_t)(span->lat_sum / span->count) : 0);
+        p = myFRAME_put_u32(p, span->exec_max);
+    }
+    p = myFRAME_put_u32(p, g_mytask_stats.acq_stall);
+    p = myFRAME_put_u32(p, g_mytask_stats.tx_drop);
+    taskEXIT_CRITICAL();
+
+    return (uint16_t)(p - buf);
+}
+
+/**
+ * @brief       ͳ֡ͳ
+ * @param       
+ * @retval      
+ */
+void myTASK_report(void)
+{
+    uint8_t payload[myTASK_PAYLOAD_SIZE];
+    uint16_t len;
+
+    len = myTASK_serialize(payload);
+    taskENTER_CRITICAL();
+    memset(&g_mytask_stats, 0, sizeof(g_mytask_stats));
+    taskEXIT_CRITICAL();
+    myFRAME_send(myFRAME_TYPE_TASKS, payload, len);
+}
+
+/**
+ * @brief       ̬ʱں˵, ṩĴ洢
+ */
+void vApplicationGetIdleTaskMemory(StaticTask_t **tcb, StackType_t **stack, uint32_t *size)
+{
+    *tcb = &g_task_idle_tcb;
+    *stack = g_task_idle_stack;
+    *size = configMINIMAL_STACK_SIZE;
+}
+
+#endif
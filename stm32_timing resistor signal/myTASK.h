@@ -0,0 +1,101 @@
+/**
+ ****************************************************************************************************
+ * @file        myTASK.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * FreeRTOS ܹ(myTASK_RTOS Ϊ 1 ʱ main.c ѭ):
+ * 1, ɼ(ȼ):  ADC DMA жϺжϵ֪ͨ, ռ ADC/PWM/ִ,
+ *    ɼڴӿжȡһ黺 DMA, ɺ {ָ, , ʱ} 봦,
+ *    ɨƵҲƽ
+ * 2, : ƽֵʮ, ʽ󽻸, 黹ж
+ * 3, (ȼ): ռλ·(myLINK.h), ηͷͶıкͶ֡
+ * ֻ, ݿͷͻ涼ڹ̶Ļ, ; ʱ
+ * ɼȴл( acq_stall), Ḳδ
+ *
+ * ÿͳ ӳ(¼ -> ʼ)  кʱ ֵ, λCPU,
+ *  myTASK_report()  myFRAME_TYPE_TASKS ֡
+ *
+ * (sim/) make RTOS=1 , ʱµ FreeRTOS ͬ
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef _MYTASK_H
+#define _MYTASK_H
+#include <stdint.h>
+#include "myFRAME.h"
+
+#ifndef myTASK_RTOS
+#define myTASK_RTOS 0 /* 1, FreeRTOS ܹ; 0, main.c ѭ */
+#endif
+
+/******************************************************************************************/
+/*  */
+
+#define myTASK_ACQ_PRIO 3        /* ɼȼ */
+#define myTASK_PROC_PRIO 2       /* ȼ */
+#define myTASK_TX_PRIO 1         /* ȼ */
+#define myTASK_ACQ_STACK 256     /* ջ,  */
+#define myTASK_PROC_STACK 384    /* printf ʽҪϴջ */
+#define myTASK_TX_STACK 192
+#define myTASK_BLOCKS 3          /* ADC ݿ黺: ɼһͬʱһ, һ */
+#define myTASK_TX_BUFS 4         /* ͻ */
+#define myTASK_TX_SIZE (myFRAME_MAX_PAYLOAD + myFRAME_OVERHEAD) /* ͻܷһ֡ */
+#define myTASK_TX_WAIT_MS 20     /* ȴзͻʱ, ʱ( tx_drop) */
+#define myTASK_VERSION 1         /* ͳƸظʽ汾 */
+
+/* ɼ֪ͨλ */
+#define myTASK_EVT_ADC (1 << 0)  /* ADC DMA  */
+#define myTASK_EVT_CMD (1 << 1)  /* յһ */
+#define myTASK_EVT_FREE (1 << 2) /* 黹һ黺 */
+
+/*  */
+typedef enum
+{
+    myTASK_ID_ACQ = 0, /* ɼ */
+    myTASK_ID_PROC,    /*  */
+    myTASK_ID_TX,      /*  */
+    myTASK_ID_NUM
+} myTASK_ID;
+
+/* ͳ, λCPU */
+typedef struct
+{
+    uint32_t count;    /* д */
+    uint32_t lat_max;  /* ӳ */
+    uint64_t lat_sum;  /* ӳۼ */
+    uint32_t exec_max; /* 󵥴кʱ */
+} myTASK_SPAN;
+
+typedef struct
+{
+    myTASK_SPAN task[myTASK_ID_NUM];
+    uint32_t acq_stall; /* ɼȴݿĴ */
+    uint32_t tx_drop;   /* ͻ治 */
+} myTASK_STATS;
+
+/* ͳƸس: 汾 +  + Ƶ + ( ӳ ƽӳ ʱ) +  */
+#define myTASK_PAYLOAD_SIZE (2 + 4 + myTASK_ID_NUM * 16 + 8)
+
+/******************************************************************************************/
+/* ⲿӿں*/
+
+void myTASK_start(void);                          /* Ͷ, ,  */
+uint8_t myTASK_running(void);                     /*  */
+void myTASK_notify_isr(uint32_t evt, uint32_t now); /* ж֪ͨɼ */
+void myTASK_tick(void);                           /* SysTick жϵ */
+uint8_t *myTASK_tx_alloc(void);                   /* ȡһзͻ,  myTASK_TX_SIZE */
+void myTASK_tx_post(uint8_t *buf, uint16_t len);  /*  */
+void myTASK_tx_lock(void);                        /* ֡ŷ䵽ֹ֮л */
+void myTASK_tx_unlock(void);
+void myTASK_tx_flush(void);                       /* ȴͶ */
+uint16_t myTASK_serialize(uint8_t *buf);          /* ͳл */
+void myTASK_report(void);                         /* ͳ֡ */
+
+#endif
@@ -26,9 +26,9 @@ void myTIME_Init(void)
 
     // TIM2 
     mytime_handle.Instance = myTIME;
-    mytime_handle.Init.Prescaler = 71;                         // ԤƵϵ (72 MHz / (71 + 1) = 1 MHz)
+    mytime_handle.Init.Prescaler = myCFG_TIME_PSC;             // ԤƵϵ (72 MHz / (71 + 1) = 1 MHz)
     mytime_handle.Init.CounterMode = TIM_COUNTERMODE_UP;       // ϼ
-    mytime_handle.Init.Period = 999;                           // Զװֵÿ1 Ӧ 1s
+    mytime_handle.Init.Period = myCFG_TIME_ARR;                // Զװֵÿ1 Ӧ 1s
     mytime_handle.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1; // Ƶ72MHz
     HAL_TIM_Base_Init(&mytime_handle);
 
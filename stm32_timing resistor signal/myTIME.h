@@ -15,6 +15,7 @@
 #ifndef _MYTIME_H
 #define _MYTIME_H
 #include "./SYSTEM/sys/sys.h"
+#include "myCFG.h"
 
 /******************************************************************************************/
 /* ʱ ʱ */
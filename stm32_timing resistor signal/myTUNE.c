@@ -0,0 +1,334 @@
+/**
+ ****************************************************************************************************
+ * @file        myTUNE.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ ****************************************************************************************************
+ */
+
+#include <math.h>
+#include "myTUNE.h"
+#include "myADC.h"
+#include "myCMD.h"
+#include "myFRAME.h"
+#include "myPROF.h"
+
+/* ״̬ */
+#define myTUNE_IDLE 0
+#define myTUNE_PENDING 1
+#define myTUNE_RUNNING 2
+
+#define myTUNE_REF (myTUNE_SMP_NUM - 1) /* ׼: 239.5  */
+
+static volatile uint8_t g_tune_state = myTUNE_IDLE;  /* ״̬ */
+static uint8_t g_tune_auto = myTUNE_AUTO_DEFAULT;     /* Զģʽ */
+static uint8_t g_tune_reason = myTUNE_REASON_START;   /* ԭ */
+static int8_t g_tune_decade = myTUNE_DECADE_NONE;     /* ǰֵʮ, M  log10 ȡ */
+static uint8_t g_tune_idx = 0;                        /* ڽеڼβɼ */
+static uint32_t g_tune_t_start = 0;                   /* βɼʱ CYCCNT */
+static uint16_t g_tune_buf[myTUNE_SAMPLES];           /* ADC DMA  */
+static float g_tune_mean[myTUNE_SMP_NUM];             /* ֵ, LSB */
+static float g_tune_var[myTUNE_SMP_NUM];              /* , LSB^2 */
+static uint32_t g_tune_t[myTUNE_SMP_NUM];             /* ɼеʱ, CYCCNT */
+static float g_tune_err[myTUNE_SMP_NUM];              /* ׼ƫ, LSB */
+static float g_tune_tol[myTUNE_SMP_NUM];              /* ľֵƫ, LSB */
+static float g_tune_ref_end;                          /* һλ׼ɼľֵ, LSB */
+static uint32_t g_tune_t_end;                         /* һλ׼ɼеʱ, CYCCNT */
+static myTUNE_SETTING g_tune_before;                  /* ǰ */
+static myTUNE_SETTING g_tune_after;                   /*  */
+
+/**
+ * @brief       һ
+ *   @note      ѭڵǰݴ; ʱ
+ * @param       reason: myTUNE_REASON_START / myTUNE_REASON_CMD / myTUNE_REASON_DECADE
+ * @retval      
+ */
+void myTUNE_request(uint8_t reason)
+{
+    if (g_tune_state == myTUNE_RUNNING)
+    {
+        return;
+    }
+    g_tune_reason = reason;
+    g_tune_state = myTUNE_PENDING;
+}
+
+/**
+ * @brief       ȴ
+ * @param       
+ * @retval      0, ; 1, 
+ */
+uint8_t myTUNE_pending(void)
+{
+    return g_tune_state == myTUNE_PENDING;
+}
+
+/**
+ * @brief       
+ *   @note      ִʱݴ˾ܾ޸Ĳ
+ * @param       
+ * @retval      0, ; 1, 
+ */
+uint8_t myTUNE_running(void)
+{
+    return g_tune_state == myTUNE_RUNNING;
+}
+
+/**
+ * @brief       Զģʽ
+ * @param       on: 0, ر, ͬʱȡȴе; 1, 
+ * @retval      
+ */
+void myTUNE_set_auto(uint8_t on)
+{
+    g_tune_auto = on ? 1 : 0;
+    if (!on && g_tune_state == myTUNE_PENDING)
+    {
+        g_tune_state = myTUNE_IDLE;
+    }
+}
+
+/**
+ * @brief       ǷԶģʽ
+ * @param       
+ * @retval      0, ; 1, 
+ */
+uint8_t myTUNE_get_auto(void)
+{
+    return g_tune_auto;
+}
+
+/**
+ * @brief       ֵڵʮ, Զģʽ¿Խʮʱ
+ *   @note      ʮ d  [10^d, 10^(d+1)) M,  myTUNE_HYST_X100/100 ʮ̵ͻ,
+ *              ֵֹڱ߽總ʱ; ·/·(ֵΪ0 NaN)ʱ
+ * @param       r: ݵֵ, M
+ * @retval      
+ */
+void myTUNE_track(float r)
+{
+    float d, hyst = myTUNE_HYST_X100 / 100.0f;
+
+    if (!(r > 1e-6f && r < 1e6f))
+    {
+        return;
+    }
+    d = log10f(r);
+
+    if (g_tune_decade == myTUNE_DECADE_NONE)
+    {
+        g_tune_decade = (int8_t)floorf(d); /* ϵĵһ, ϵѾڽ */
+        return;
+    }
+    if (d < g_tune_decade - hyst || d >= g_tune_decade + 1 + hyst)
+    {
+        g_tune_decade = (int8_t)floorf(d);
+        if (g_tune_auto)
+        {
+            myTUNE_request(myTUNE_REASON_DECADE);
+        }
+    }
+}
+
+/**
+ * @brief        idx βɼ
+ *   @note      ɼ˳: 239.5 , 71.5 ~ 1.5 , ٲһ 239.5 ;
+ *              βλ׼ʱԲֵ, ۳ڼֵ仯ľֵƫ
+ * @param       idx: 0 ~ myTUNE_SMP_NUM
+ * @retval      
+ */
+static void myTUNE_capture(uint8_t idx)
+{
+    g_tune_idx = idx;
+    myADC_set_smp(idx == 0 || idx == myTUNE_SMP_NUM ? myTUNE_REF : myTUNE_REF - idx);
+    g_tune_t_start = myPROF_CYCCNT();
+    myADC_DMA_enable_buf((uint32_t)g_tune_buf, myTUNE_SAMPLES);
+}
+
+/**
+ * @brief       
+ *   @note       ADC (һѴ)ʱ
+ * @param       
+ * @retval      
+ */
+void myTUNE_start(void)
+{
+    g_tune_before.smp = myADC_get_smp();
+    g_tune_before.avg = g_mycmd_cfg.avg_depth;
+    g_tune_before.rate = g_myadc_rate;
+
+    g_tune_state = myTUNE_RUNNING;
+    myTUNE_capture(0);
+}
+
+/* ĳﵽĿֱƽ */
+static uint16_t myTUNE_avg_depth(float var)
+{
+    float target = myTUNE_TARGET_X100 / 100.0f;
+    float n = ceilf(var / (target * target));
+
+    if (n < 1)
+    {
+        return 1;
+    }
+    if (n > myADC_DMA_BUF_SIZE)
+    {
+        return myADC_DMA_BUF_SIZE;
+    }
+    return (uint16_t)n;
+}
+
+/* ƽ, LSB  100 */
+static uint16_t myTUNE_noise_x100(float var, uint16_t avg)
+{
+    float noise = sqrtf(var / avg) * 100;
+
+    return noise > 65535 ? 65535 : (uint16_t)(noise + 0.5f);
+}
+
+/**
+ * @brief       Ĳѡʱƽ
+ *   @note      ӳ̼齨, һĵλ̵Ķ(һʱʱԽԽ);
+ *              õλѡЧߵ, ƽٵ㶼ﲻĿʱѡƽС
+ * @param       
+ * @retval      ѡеĵλ
+ */
+static uint8_t myTUNE_select(void)
+{
+    float target = myTUNE_TARGET_X100 / 100.0f;
+    float ref = g_tune_mean[myTUNE_REF], ref_var = g_tune_var[myTUNE_REF];
+    float drift = g_tune_ref_end - ref, span = (float)(g_tune_t_end - g_tune_t[myTUNE_REF]);
+    float best_eff = 0, best_noise = 1e30f;
+    uint8_t best = myTUNE_REF, best_ok = 0;
+    int8_t s;
+
+    for (s = 0; s < myTUNE_SMP_NUM; s++)
+    {
+        float w = span > 0 ? (float)(g_tune_t[s] - g_tune_t[myTUNE_REF]) / span : 0; // ׼ֵȨ
+
+        g_tune_err[s] = fabsf(g_tune_mean[s] - (ref + w * drift));
+        g_tune_tol[s] = target + myTUNE_SIGMA_K * sqrtf((g_tune_var[s] + ref_var) / myTUNE_SAMPLES);
+    }
+
+    for (s = myTUNE_REF; s >= 0 && g_tune_err[s] <= g_tune_tol[s]; s--)
+    {
+        uint16_t n = myTUNE_avg_depth(g_tune_var[s]);
+        float eff = (float)myADC_smp_rate((uint8_t)s) / n; // Ч, /
+        float noise = sqrtf(g_tune_var[s] / n);
+        uint8_t ok = noise <= target;
+
+        if ((ok && !best_ok) || (ok && eff >= best_eff) || (!ok && !best_ok && noise <= best_noise))
+        {
+            best = (uint8_t)s;
+            best_eff = eff;
+            best_noise = noise;
+            best_ok = ok;
+        }
+    }
+    g_tune_err[myTUNE_REF] = fabsf(drift); /* ׼ƫΪڼƯ */
+    return best;
+}
+
+/**
+ * @brief       һɼɺ: ͳƱ, һ
+ *   @note      ADC DMA жλ g_adc_dma_start  myTUNE_running() ʱѭ;
+ *              ʱµĲʱƽ,  myFRAME_TYPE_TUNE ֡
+ * @param       
+ * @retval      1, һĲɼ; 0, , ADC 
+ */
+uint8_t myTUNE_step(void)
+{
+    uint8_t payload[myTUNE_PAYLOAD_SIZE];
+    uint32_t sum = 0;
+    uint64_t sum2 = 0;
+    uint32_t t_mid = g_tune_t_start + (myPROF_CYCCNT() - g_tune_t_start) / 2; // βɼеʱ
+    uint16_t i;
+    uint8_t smp;
+
+    for (i = 0; i < myTUNE_SAMPLES; i++)
+    {
+        sum += g_tune_buf[i];
+        sum2 += (uint32_t)g_tune_buf[i] * g_tune_buf[i];
+    }
+
+    if (g_tune_idx < myTUNE_SMP_NUM)
+    {
+        smp = myADC_get_smp();
+        g_tune_mean[smp] = (float)sum / myTUNE_SAMPLES;
+        g_tune_var[smp] = (float)(sum2 - (uint64_t)sum * sum / myTUNE_SAMPLES) / myTUNE_SAMPLES; // E[x^2] - E[x]^2
+        g_tune_t[smp] = t_mid;
+        myTUNE_capture(g_tune_idx + 1);
+        return 1;
+    }
+    g_tune_ref_end = (float)sum / myTUNE_SAMPLES;
+    g_tune_t_end = t_mid;
+
+    g_tune_before.noise_x100 = myTUNE_noise_x100(g_tune_var[g_tune_before.smp], g_tune_before.avg);
+
+    smp = myTUNE_select();
+    g_tune_after.smp = smp;
+    g_tune_after.avg = myTUNE_avg_depth(g_tune_var[smp]);
+    g_tune_after.rate = myADC_set_smp(smp);
+    g_tune_after.noise_x100 = myTUNE_noise_x100(g_tune_var[smp], g_tune_after.avg);
+    g_mycmd_cfg.avg_depth = g_tune_after.avg;
+
+    g_tune_state = myTUNE_IDLE;
+    myFRAME_send(myFRAME_TYPE_TUNE, payload, myTUNE_serialize(payload));
+    return 0;
+}
+
+/* дһ: λ(u8) ƽ(u16) (u32) (u16) */
+static uint8_t *myTUNE_put_setting(uint8_t *p, const myTUNE_SETTING *s)
+{
+    *p++ = s->smp;
+    p = myFRAME_put_u16(p, s->avg);
+    p = myFRAME_put_u32(p, s->rate);
+    return myFRAME_put_u16(p, s->noise_x100);
+}
+
+/*   scale ת u16, Χʱ */
+static uint16_t myTUNE_u16(float v, float scale)
+{
+    v = v * scale + 0.5f;
+    return v > 65535 ? 65535 : (v < 0 ? 0 : (uint16_t)v);
+}
+
+/**
+ * @brief       ¼л(С)
+ *   @note      ظʽ:
+ *              汾(u8) ԭ(u8) ʮ(i8, 127 ʾδ֪) (u8) ÿ(u16) Ŀֱ(u16, LSB100)
+ *              ǰ, : λ(u8) ƽ(u16) (u32) (u16, LSB100)
+ *              (λ 0 ~ 7): ֵ(u16, LSB16) ׼(u16, LSB100) ׼ƫ(u16, LSB100)
+ *                                ƫ(u16, LSB100); ׼(7)ƫΪβλ׼ɼ֮
+ * @param       buf: ,  myTUNE_PAYLOAD_SIZE
+ * @retval      س
+ */
+uint16_t myTUNE_serialize(uint8_t *buf)
+{
+    uint8_t *p = buf;
+    uint8_t s;
+
+    *p++ = myTUNE_VERSION;
+    *p++ = g_tune_reason;
+    *p++ = (uint8_t)g_tune_decade;
+    *p++ = myTUNE_SMP_NUM;
+    p = myFRAME_put_u16(p, myTUNE_SAMPLES);
+    p = myFRAME_put_u16(p, myTUNE_TARGET_X100);
+    p = myTUNE_put_setting(p, &g_tune_before);
+    p = myTUNE_put_setting(p, &g_tune_after);
+    for (s = 0; s < myTUNE_SMP_NUM; s++)
+    {
+        p = myFRAME_put_u16(p, myTUNE_u16(g_tune_mean[s], 16));
+        p = myFRAME_put_u16(p, myTUNE_u16(sqrtf(g_tune_var[s]), 100));
+        p = myFRAME_put_u16(p, myTUNE_u16(g_tune_err[s], 100));
+        p = myFRAME_put_u16(p, myTUNE_u16(g_tune_tol[s], 100));
+    }
+
+    return (uint16_t)(p - buf);
+}
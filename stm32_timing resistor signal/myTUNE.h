@@ -0,0 +1,74 @@
+/**
+ ****************************************************************************************************
+ * @file        myTUNE.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * ADC ʱƽԶ:
+ * 1,  239.5 ڿʼ, ÿʱɼ myTUNE_SAMPLES , ֵͱ׼,
+ *    ٲһ 239.5 , βΰʱֵ̲ΪĻ׼(۳ֵĻ仯)
+ * 2, ֵ׼ƫ Ŀֱ + myTUNE_SIGMA_K ֵ׼ ĵλΪ
+ *    δֽ(źԴ), õ̵Ĳʱ䶼ʹ
+ * 3, ÿõλ ƽ = (׼ / Ŀֱ)^2 ƽ, ѡЧ
+ *    ( / ƽ)ߵһ, ͬʱȡʱ϶̵һ
+ *  myFRAME_TYPE_TUNE ֡, ǰáЧʡ׺͸ֵ
+ *
+ * Ĭϲ, ϵʹ myCFG.h Ĳ; TUNE һ, TUNE AUTO Զģʽ,
+ * ԶģʽֵԽʮ(ͻ)ʱ, ֶ RATE  AVG ˳Զģʽ
+ * ɨƵһ֮, ɼڼ䲻ͨݿ
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef _MYTUNE_H
+#define _MYTUNE_H
+#include "./SYSTEM/sys/sys.h"
+
+/******************************************************************************************/
+/*  */
+
+#define myTUNE_SAMPLES 100       /* ÿʱɼĵ */
+#define myTUNE_SMP_NUM 8         /* ʱ䵵 */
+#define myTUNE_TARGET_X100 50    /* Ŀֱ: ƽͽ 0.5 LSB */
+#define myTUNE_SIGMA_K 3         /* жϽʱֵ׼ı */
+#define myTUNE_HYST_X100 5       /* ʮлͻ, 0.05 ʮ */
+#define myTUNE_AUTO_DEFAULT 0    /* ϵĬԶģʽ: 0, ر( myCFG.h Ĳ); 1, 򿪲ϵһ */
+#define myTUNE_VERSION 1         /* ظʽ汾 */
+#define myTUNE_DECADE_NONE 127   /* ûֵ */
+
+/* ԭ */
+#define myTUNE_REASON_START 0  /* ϵ */
+#define myTUNE_REASON_CMD 1    /* TUNE  */
+#define myTUNE_REASON_DECADE 2 /* ֵԽʮ */
+
+/* һüЧ */
+typedef struct
+{
+    uint8_t smp;         /* ʱ䵵λ 0 ~ 7 */
+    uint16_t avg;        /* ƽ */
+    uint32_t rate;       /* ADC , / */
+    uint16_t noise_x100; /* ƽ = ׼ / sqrt(ƽ), LSB  100 */
+} myTUNE_SETTING;
+
+/* س: ͷ(8) + ǰ(29) + (ֵ16 u16, ׼ u16, ƫ u16, ƫ u16) */
+#define myTUNE_PAYLOAD_SIZE (8 + 2 * 9 + myTUNE_SMP_NUM * 8)
+
+/******************************************************************************************/
+/* ⲿӿں*/
+
+void myTUNE_request(uint8_t reason); /* һ */
+uint8_t myTUNE_pending(void);        /* ȴ */
+uint8_t myTUNE_running(void);        /*  */
+void myTUNE_start(void);             /* (ADCʱ) */
+uint8_t myTUNE_step(void);           /* һɼɺ,  1 ʾڽ */
+void myTUNE_set_auto(uint8_t on);    /* Զģʽ, رʱȡȴе */
+uint8_t myTUNE_get_auto(void);       /* ǷԶģʽ */
+void myTUNE_track(float r);          /* ÿֵ, ʮ */
+uint16_t myTUNE_serialize(uint8_t *buf); /* ¼л */
+
+#endif
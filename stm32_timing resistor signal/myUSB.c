@@ -0,0 +1,827 @@
+/**
+ ****************************************************************************************************
+ * @file        myUSB.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ ****************************************************************************************************
+ */
+
+#include "myUSB.h"
+#include <string.h>
+
+/***************************************շ*****************************************/
+
+/**
+ * @brief       շ
+ *   @note      ߸λлʱ; ۼƶֽ
+ * @param       cdc   : շ״̬
+ * @param       online: Ƿ
+ * @retval      
+ */
+void myUSB_cdc_reset(myUSB_CDC *cdc, uint8_t online)
+{
+    cdc->tx_head = 0;
+    cdc->tx_tail = 0;
+    cdc->tx_len = 0;
+    cdc->tx_busy = 0;
+    cdc->tx_zlp = 0;
+    cdc->rx_head = 0;
+    cdc->rx_tail = 0;
+    cdc->rx_parked = 0;
+    cdc->online = online;
+}
+
+/**
+ * @brief       ͻʣռ
+ *   @note      ڴڴǰռÿռ, ᱻݸ
+ * @param       cdc: շ״̬
+ * @retval      дֽ
+ */
+uint16_t myUSB_tx_space(const myUSB_CDC *cdc)
+{
+    return myUSB_TX_RING - (uint16_t)(cdc->tx_head - cdc->tx_tail);
+}
+
+/**
+ * @brief       д뷢ͻ
+ * @param       cdc : շ״̬
+ * @param       data: 
+ * @param       len : 
+ * @retval      ʵдֽ, ʱС len
+ */
+uint16_t myUSB_tx_push(myUSB_CDC *cdc, const uint8_t *data, uint16_t len)
+{
+    uint16_t space = myUSB_tx_space(cdc);
+    uint16_t pos = cdc->tx_head & (myUSB_TX_RING - 1);
+    uint16_t first;
+
+    if (len > space)
+    {
+        len = space;
+    }
+    first = myUSB_TX_RING - pos; /* ĩβռ */
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(&cdc->tx_buf[pos], data, first);
+    memcpy(&cdc->tx_buf[0], data + first, len - first);
+    cdc->tx_head += len;
+    return len;
+}
+
+/**
+ * @brief       IN ˵ʱȡһδ
+ *   @note      ֻȡһ,  myUSB_TX_CHUNK ֽ; 滹ʱس, յĶ;
+ *              ûݵһδǰʱһ㳤Ȱ, ݴ˽ζȡ
+ * @param       cdc : շ״̬
+ * @param       data: شʼַ, (myUSB_tx_done)ǰᱻд
+ * @param       len : ش䳤, 0 ʾ㳤Ȱ
+ * @retval      1, Ҫ; 0, ˵æû
+ */
+uint8_t myUSB_tx_next(myUSB_CDC *cdc, const uint8_t **data, uint16_t *len)
+{
+    uint16_t used = cdc->tx_head - cdc->tx_tail;
+    uint16_t pos = cdc->tx_tail & (myUSB_TX_RING - 1);
+    uint16_t n = used;
+
+    if (cdc->tx_busy)
+    {
+        return 0;
+    }
+    if (used == 0)
+    {
+        if (!cdc->tx_zlp)
+        {
+            return 0;
+        }
+        cdc->tx_zlp = 0; /* 㳤Ȱ */
+    }
+    else
+    {
+        if (n > myUSB_TX_RING - pos)
+        {
+            n = myUSB_TX_RING - pos; /* ƻػ濪ͷĲ´ٷ */
+        }
+        if (n > myUSB_TX_CHUNK)
+        {
+            n = myUSB_TX_CHUNK;
+        }
+        if (n < used && n > myUSB_EP_SIZE)
+        {
+            n -= n % myUSB_EP_SIZE; /* һβͺͺһ */
+        }
+        cdc->tx_zlp = 0; /* ݽŷ, Ķȡͣ */
+    }
+
+    cdc->tx_len = n;
+    cdc->tx_busy = 1;
+    *data = &cdc->tx_buf[pos];
+    *len = n;
+    return 1;
+}
+
+/**
+ * @brief       IN , ƶλ, ͷſռ
+ * @param       cdc: շ״̬
+ * @retval      
+ */
+void myUSB_tx_done(myUSB_CDC *cdc)
+{
+    cdc->tx_tail += cdc->tx_len;
+    cdc->tx_zlp = cdc->tx_len && (cdc->tx_len % myUSB_EP_SIZE) == 0;
+    cdc->tx_len = 0;
+    cdc->tx_busy = 0;
+}
+
+/**
+ * @brief       OUT , ݷջ
+ *   @note      ֻʣռ䲻 myUSB_RX_ARM ʱ OUT , ʱ;
+ *              ռ䲻һδͣ NAK ״̬,  myUSB_rx_unpark()  1 
+ * @param       cdc : շ״̬
+ * @param       data: յ
+ * @param       len : 
+ * @retval      1,  OUT ; 0, ͣ
+ */
+uint8_t myUSB_rx_push(myUSB_CDC *cdc, const uint8_t *data, uint16_t len)
+{
+    uint16_t space = myUSB_RX_RING - (uint16_t)(cdc->rx_head - cdc->rx_tail);
+    uint16_t i;
+
+    if (len > space)
+    {
+        len = space;
+    }
+    for (i = 0; i < len; i++)
+    {
+        cdc->rx_buf[(uint16_t)(cdc->rx_head + i) & (myUSB_RX_RING - 1)] = data[i];
+    }
+    cdc->rx_head += len;
+
+    if (myUSB_RX_RING - (uint16_t)(cdc->rx_head - cdc->rx_tail) >= myUSB_RX_ARM)
+    {
+        return 1;
+    }
+    cdc->rx_parked = 1;
+    return 0;
+}
+
+/**
+ * @brief       ȡ
+ * @param       cdc: շ״̬
+ * @param       buf: λ
+ * @param       max: ȡֽ
+ * @retval      ȡֽ
+ */
+uint16_t myUSB_rx_pop(myUSB_CDC *cdc, uint8_t *buf, uint16_t max)
+{
+    uint16_t n = cdc->rx_head - cdc->rx_tail;
+    uint16_t i;
+
+    if (n > max)
+    {
+        n = max;
+    }
+    for (i = 0; i < n; i++)
+    {
+        buf[i] = cdc->rx_buf[(uint16_t)(cdc->rx_tail + i) & (myUSB_RX_RING - 1)];
+    }
+    cdc->rx_tail += n;
+    return n;
+}
+
+/**
+ * @brief       ȡݺжǷָ
+ * @param       cdc: շ״̬
+ * @retval      1, ֮ǰͣ˽ڿռ㹻,  OUT ; 0, Ҫ
+ */
+uint8_t myUSB_rx_unpark(myUSB_CDC *cdc)
+{
+    if (cdc->rx_parked && myUSB_RX_RING - (uint16_t)(cdc->rx_head - cdc->rx_tail) >= myUSB_RX_ARM)
+    {
+        cdc->rx_parked = 0;
+        return 1;
+    }
+    return 0;
+}
+
+#ifndef myUSB_CORE_ONLY
+
+/***************************************USB 豸 CDC *****************************************/
+
+#include "./SYSTEM/delay/delay.h"
+
+#define myUSB_VID 0x0483 /* ST ⴮ڵ VID/PID, Windows 10  Linux Ҫװ */
+#define myUSB_PID 0x5740
+
+/* ƶ˵״̬ */
+#define myUSB_EP0_IDLE 0
+#define myUSB_EP0_DATA_IN 1  /* ڷݽ׶ */
+#define myUSB_EP0_DATA_OUT 2 /* ڽݽ׶ */
+#define myUSB_EP0_STATUS 3   /* ״̬׶ */
+
+/* CDC  */
+#define myUSB_CDC_SET_LINE_CODING 0x20
+#define myUSB_CDC_GET_LINE_CODING 0x21
+#define myUSB_CDC_SET_CONTROL_LINE_STATE 0x22
+#define myUSB_CDC_SEND_BREAK 0x23
+
+#define myUSB_CFG_DESC_SIZE 67
+
+static const uint8_t g_usb_dev_desc[18] = {
+    18, 0x01,                                  /* 豸 */
+    0x00, 0x02,                                /* USB 2.0 */
+    0x02, 0x00, 0x00,                          /* CDC , Эڽӿ */
+    myUSB_EP_SIZE,                             /* ƶ˵ */
+    myUSB_VID & 0xFF, myUSB_VID >> 8,
+    myUSB_PID & 0xFF, myUSB_PID >> 8,
+    0x00, 0x02,                                /* 豸汾 2.00, ̼汾һ */
+    1, 2, 3,                                   /* ̡Ʒкַ */
+    1                                          /*  */
+};
+
+static const uint8_t g_usb_cfg_desc[myUSB_CFG_DESC_SIZE] = {
+    9, 0x02, myUSB_CFG_DESC_SIZE, 0x00, 2, 1, 0, 0x80, 50, /* : 2ӿ, ߹ 100mA */
+
+    9, 0x04, 0, 0, 1, 0x02, 0x02, 0x01, 0,                 /* ӿ0: ͨ, ACM, AT */
+    5, 0x24, 0x00, 0x10, 0x01,                             /* Header: CDC 1.10 */
+    5, 0x24, 0x01, 0x00, 1,                                /* Call Management: ݽӿΪ1 */
+    4, 0x24, 0x02, 0x02,                                   /* ACM: ֧ LINE_CODING  CONTROL_LINE_STATE */
+    5, 0x24, 0x06, 0, 1,                                   /* Union: ӿ0, ӽӿ1 */
+    7, 0x05, myUSB_EP_CMD, 0x03, 8, 0, 16,                 /* ж IN, 8ֽ, 16ms */
+
+    9, 0x04, 1, 0, 2, 0x0A, 0x00, 0x00, 0,                 /* ӿ1:  */
+    7, 0x05, myUSB_EP_OUT, 0x02, myUSB_EP_SIZE, 0, 0,      /*  OUT */
+    7, 0x05, myUSB_EP_IN, 0x02, myUSB_EP_SIZE, 0, 0,       /*  IN */
+};
+
+static const char *const g_usb_str[] = {NULL, "CUMT", "Photo Sensor Test"}; /* коƬ UID  */
+
+PCD_HandleTypeDef g_pcd_handle = {0};                /* USB  */
+static myUSB_CDC g_usb_cdc;                          /* շ */
+static uint8_t g_usb_rx_pkt[myUSB_RX_ARM];           /* OUT Ŀĵַ, ɺջ */
+static uint8_t g_usb_ep0_buf[myUSB_EP_SIZE];         /* ƴݽ׶ */
+static uint8_t g_usb_ep0_state = myUSB_EP0_IDLE;
+static uint8_t g_usb_config = 0;                     /* ǰ, 0 ʾδ */
+static uint8_t g_usb_dtr = 0;                        /* ˶˿ */
+static uint8_t g_usb_suspended = 0;                  /* ߹(߻) */
+static uint8_t g_usb_line_coding[7] = {0x00, 0xC2, 0x01, 0x00, 0x00, 0x00, 0x08}; /* 115200 8N1, ֻ治ʹ */
+
+/* á˶˿δʱŽܷ */
+static void myUSB_update_online(void)
+{
+    g_usb_cdc.online = g_usb_config && g_usb_dtr && !g_usb_suspended;
+}
+
+/* IN ˵ʱһδ,  USB жر USB жϺ */
+static void myUSB_tx_start(void)
+{
+    const uint8_t *data;
+    uint16_t len;
+
+    if (g_usb_config && myUSB_tx_next(&g_usb_cdc, &data, &len))
+    {
+        HAL_PCD_EP_Transmit(&g_pcd_handle, myUSB_EP_IN, (uint8_t *)data, len);
+    }
+}
+
+/* һ OUT ,  */
+static void myUSB_rx_start(void)
+{
+    HAL_PCD_EP_Receive(&g_pcd_handle, myUSB_EP_OUT, g_usb_rx_pkt, myUSB_RX_ARM);
+}
+
+/**
+ * @brief       ʼ USB , ʼö
+ *   @note      Ȱ D+  myUSB_REENUM_MS, λŻö; USB ʱ = PLL 72MHz / 1.5 = 48MHz
+ * @param       
+ * @retval      
+ */
+void myUSB_init(void)
+{
+    GPIO_InitTypeDef gpio_init_struct;
+    RCC_PeriphCLKInitTypeDef usb_clk = {0};
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    gpio_init_struct.Pin = myUSB_DP_GPIO_PIN;
+    gpio_init_struct.Mode = GPIO_MODE_OUTPUT_PP;
+    gpio_init_struct.Pull = GPIO_NOPULL;
+    gpio_init_struct.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(myUSB_DP_GPIO_PORT, &gpio_init_struct);
+    HAL_GPIO_WritePin(myUSB_DP_GPIO_PORT, myUSB_DP_GPIO_PIN, GPIO_PIN_RESET); /* Ϊ豸Ѱγ */
+    delay_ms(myUSB_REENUM_MS);
+    HAL_GPIO_DeInit(myUSB_DP_GPIO_PORT, myUSB_DP_GPIO_PIN); /*  USB  */
+
+    usb_clk.PeriphClockSelection = RCC_PERIPHCLK_USB;
+    usb_clk.UsbClockSelection = RCC_USBCLKSOURCE_PLL_DIV1_5;
+    HAL_RCCEx_PeriphCLKConfig(&usb_clk);
+    __HAL_RCC_USB_CLK_ENABLE();
+
+    g_pcd_handle.Instance = USB;
+    g_pcd_handle.Init.dev_endpoints = 8;
+    g_pcd_handle.Init.speed = PCD_SPEED_FULL;
+    g_pcd_handle.Init.low_power_enable = DISABLE;
+    g_pcd_handle.Init.lpm_enable = DISABLE;
+    g_pcd_handle.Init.battery_charging_enable = DISABLE;
+    HAL_PCD_Init(&g_pcd_handle);
+
+    HAL_PCDEx_PMAConfig(&g_pcd_handle, 0x00, PCD_SNG_BUF, myUSB_PMA_EP0_OUT);
+    HAL_PCDEx_PMAConfig(&g_pcd_handle, 0x80, PCD_SNG_BUF, myUSB_PMA_EP0_IN);
+    HAL_PCDEx_PMAConfig(&g_pcd_handle, myUSB_EP_IN, PCD_DBL_BUF, myUSB_PMA_IN_0 | ((uint32_t)myUSB_PMA_IN_1 << 16));
+    HAL_PCDEx_PMAConfig(&g_pcd_handle, myUSB_EP_OUT, PCD_DBL_BUF, myUSB_PMA_OUT_0 | ((uint32_t)myUSB_PMA_OUT_1 << 16));
+    HAL_PCDEx_PMAConfig(&g_pcd_handle, myUSB_EP_CMD, PCD_SNG_BUF, myUSB_PMA_CMD);
+
+    /* 봮жͬ, صͬƴ */
+    HAL_NVIC_SetPriority(myUSB_IRQn, 3, 2);
+    HAL_NVIC_EnableIRQ(myUSB_IRQn);
+    HAL_PCD_Start(&g_pcd_handle);
+}
+
+/**
+ * @brief       USB жϷ
+ *   @note      HAL⴦˵¼, ջݾͽ myUSB_rx_callback()
+ * @param       
+ * @retval      
+ */
+void myUSB_IRQHandler(void)
+{
+    HAL_PCD_IRQHandler(&g_pcd_handle);
+    if (g_usb_cdc.rx_head != g_usb_cdc.rx_tail)
+    {
+        myUSB_rx_callback();
+    }
+}
+
+/**
+ * @brief       Ѵ򿪶˿
+ * @param       
+ * @retval      1, ; 0, δö١˿δ򿪻߹
+ */
+uint8_t myUSB_online(void)
+{
+    return g_usb_cdc.online;
+}
+
+/**
+ * @brief       д뷢ͻ, IN ˵ʱʼ
+ *   @note      Ųʱȴ(ѹ), myUSB_TX_TIMEOUT_MS ûκνչŶʣµ;
+ *              泤ȵдζ, յ֡;
+ *              ʱֱӶ. ȼ USB жϵж
+ * @param       data: 
+ * @param       len : 
+ * @retval      дֽ
+ */
+uint16_t myUSB_write(const uint8_t *data, uint16_t len)
+{
+    uint32_t t0 = HAL_GetTick();
+    uint16_t done = 0;
+
+    while (done < len && g_usb_cdc.online)
+    {
+        uint16_t n = len - done;
+
+        if (n > myUSB_TX_RING)
+        {
+            n = myUSB_TX_RING;
+        }
+        HAL_NVIC_DisableIRQ(myUSB_IRQn); /* 봫жϻ, Ӱ ADC ж */
+        n = myUSB_tx_space(&g_usb_cdc) >= n ? myUSB_tx_push(&g_usb_cdc, data + done, n) : 0;
+        myUSB_tx_start();
+        HAL_NVIC_EnableIRQ(myUSB_IRQn);
+
+        if (n)
+        {
+            done += n;
+            t0 = HAL_GetTick();
+        }
+        else if (HAL_GetTick() - t0 >= myUSB_TX_TIMEOUT_MS)
+        {
+            break;
+        }
+        else
+        {
+            __WFI(); /* ȴжڳռ */
+        }
+    }
+    g_usb_cdc.tx_drop += len - done;
+    return done;
+}
+
+/**
+ * @brief       ͻݶѱ
+ * @param       
+ * @retval      1, ; 0, 
+ */
+uint8_t myUSB_tx_idle(void)
+{
+    return !g_usb_cdc.tx_busy && g_usb_cdc.tx_head == g_usb_cdc.tx_tail;
+}
+
+/**
+ * @brief       ۼƶķֽ(߻ȴʱ)
+ * @param       
+ * @retval      ֽ
+ */
+uint32_t myUSB_tx_drop(void)
+{
+    return g_usb_cdc.tx_drop;
+}
+
+/**
+ * @brief       ȡ, ռ㹻ָ OUT ˵
+ *   @note      ֻ USB ж(myUSB_rx_callback),  OUT ɻ
+ * @param       buf: λ
+ * @param       max: ȡֽ
+ * @retval      ȡֽ
+ */
+uint16_t myUSB_read(uint8_t *buf, uint16_t max)
+{
+    uint16_t n = myUSB_rx_pop(&g_usb_cdc, buf, max);
+
+    if (myUSB_rx_unpark(&g_usb_cdc))
+    {
+        myUSB_rx_start();
+    }
+    return n;
+}
+
+/**
+ * @brief        USB ж, жٵһ myUSB_rx_callback
+ *   @note      صһδִжûȡʱ, ѭִ
+ * @param       
+ * @retval      
+ */
+void myUSB_rx_kick(void)
+{
+    HAL_NVIC_SetPendingIRQ(myUSB_IRQn);
+}
+
+/**
+ * @brief       ջʱ USB ж, ʹ(myCMD)¶
+ * @param       
+ * @retval      
+ */
+__weak void myUSB_rx_callback(void)
+{
+    uint8_t c;
+
+    while (myUSB_read(&c, 1))
+        ; /* ûʹʱ */
+}
+
+/**
+ * @brief       ַ(UTF-16LE)
+ * @param       index: ַ, 0 Ϊб
+ * @param       buf  : λ,  myUSB_EP_SIZE
+ * @retval      , 0 ʾûַ
+ */
+static uint16_t myUSB_string_desc(uint8_t index, uint8_t *buf)
+{
+    uint8_t n = 0;
+
+    if (index == 0)
+    {
+        buf[2] = 0x09; /* Ӣ() */
+        buf[3] = 0x04;
+        n = 1;
+    }
+    else if (index < sizeof(g_usb_str) / sizeof(g_usb_str[0]))
+    {
+        const char *s = g_usb_str[index];
+
+        while (s[n] && n < (myUSB_EP_SIZE - 2) / 2)
+        {
+            buf[2 + 2 * n] = (uint8_t)s[n];
+            buf[3 + 2 * n] = 0;
+            n++;
+        }
+    }
+    else if (index == 3)
+    {
+        uint32_t uid[2];
+
+        uid[0] = HAL_GetUIDw0() + HAL_GetUIDw2(); /* 96λ UID ѹ 12 λʮ */
+        uid[1] = HAL_GetUIDw1();
+        for (n = 0; n < 12; n++)
+        {
+            uint8_t d = n < 8 ? (uid[0] >> (28 - 4 * n)) & 0xF : (uid[1] >> (44 - 4 * n)) & 0xF;
+
+            buf[2 + 2 * n] = d < 10 ? '0' + d : 'A' + d - 10;
+            buf[3 + 2 * n] = 0;
+        }
+    }
+    else
+    {
+        return 0;
+    }
+    buf[0] = 2 + 2 * n;
+    buf[1] = 0x03;
+    return buf[0];
+}
+
+/* ƴ: ݽ׶, Ҫĳ */
+static void myUSB_ctrl_in(PCD_HandleTypeDef *hpcd, const uint8_t *data, uint16_t len, uint16_t w_length)
+{
+    if (len > w_length)
+    {
+        len = w_length;
+    }
+    g_usb_ep0_state = myUSB_EP0_DATA_IN;
+    HAL_PCD_EP_Transmit(hpcd, 0x80, (uint8_t *)data, len); /* ȶǰ, Ҫ㳤Ȱ */
+}
+
+/* ƴ: ûݽ׶, ֱӷ״̬׶ε㳤Ȱ */
+static void myUSB_ctrl_status(PCD_HandleTypeDef *hpcd)
+{
+    g_usb_ep0_state = myUSB_EP0_STATUS;
+    HAL_PCD_EP_Transmit(hpcd, 0x80, NULL, 0);
+}
+
+/* ƴ: ֵ֧ STALL */
+static void myUSB_ctrl_stall(PCD_HandleTypeDef *hpcd)
+{
+    g_usb_ep0_state = myUSB_EP0_IDLE;
+    HAL_PCD_EP_SetStall(hpcd, 0x80);
+    HAL_PCD_EP_SetStall(hpcd, 0x00);
+}
+
+/* SET_CONFIGURATION: 򿪻ر CDC ˵ */
+static void myUSB_set_config(PCD_HandleTypeDef *hpcd, uint8_t config)
+{
+    if (g_usb_config)
+    {
+        HAL_PCD_EP_Close(hpcd, myUSB_EP_IN);
+        HAL_PCD_EP_Close(hpcd, myUSB_EP_OUT);
+        HAL_PCD_EP_Close(hpcd, myUSB_EP_CMD);
+    }
+    g_usb_config = config;
+    g_usb_dtr = 0;
+    myUSB_cdc_reset(&g_usb_cdc, 0);
+    if (config)
+    {
+        HAL_PCD_EP_Open(hpcd, myUSB_EP_IN, myUSB_EP_SIZE, EP_TYPE_BULK);
+        HAL_PCD_EP_Open(hpcd, myUSB_EP_OUT, myUSB_EP_SIZE, EP_TYPE_BULK);
+        HAL_PCD_EP_Open(hpcd, myUSB_EP_CMD, 8, EP_TYPE_INTR);
+        myUSB_rx_start();
+    }
+    myUSB_update_online();
+}
+
+/* ׼ */
+static void myUSB_std_request(PCD_HandleTypeDef *hpcd, const uint8_t *setup, uint16_t value, uint16_t w_length)
+{
+    switch (setup[1])
+    {
+    case 0x00: /* GET_STATUS: ߹, ֧Զ̻, ˵δֹͣ */
+        g_usb_ep0_buf[0] = 0;
+        g_usb_ep0_buf[1] = 0;
+        myUSB_ctrl_in(hpcd, g_usb_ep0_buf, 2, w_length);
+        break;
+
+    case 0x01: /* CLEAR_FEATURE: ֻ֧˵ HALT */
+        if ((setup[0] & 0x1F) == 0x02 && value == 0)
+        {
+            HAL_PCD_EP_ClrStall(hpcd, setup[4]);
+            myUSB_ctrl_status(hpcd);
+        }
+        else
+        {
+            myUSB_ctrl_stall(hpcd);
+        }
+        break;
+
+    case 0x03: /* SET_FEATURE: ֶֻ֧˵ HALT */
+        if ((setup[0] & 0x1F) == 0x02 && value == 0)
+        {
+            HAL_PCD_EP_SetStall(hpcd, setup[4]);
+            myUSB_ctrl_status(hpcd);
+        }
+        else
+        {
+            myUSB_ctrl_stall(hpcd);
+        }
+        break;
+
+    case 0x05: /* SET_ADDRESS: HAL״̬׶ɺдַ */
+        HAL_PCD_SetAddress(hpcd, (uint8_t)(value & 0x7F));
+        myUSB_ctrl_status(hpcd);
+        break;
+
+    case 0x06: /* GET_DESCRIPTOR */
+        switch (value >> 8)
+        {
+        case 0x01:
+            myUSB_ctrl_in(hpcd, g_usb_dev_desc, sizeof(g_usb_dev_desc), w_length);
+            break;
+
+        case 0x02:
+            myUSB_ctrl_in(hpcd, g_usb_cfg_desc, sizeof(g_usb_cfg_desc), w_length);
+            break;
+
+        case 0x03:
+        {
+            uint16_t len = myUSB_string_desc((uint8_t)value, g_usb_ep0_buf);
+
+            if (len)
+            {
+                myUSB_ctrl_in(hpcd, g_usb_ep0_buf, len, w_length);
+            }
+            else
+            {
+                myUSB_ctrl_stall(hpcd);
+            }
+            break;
+        }
+
+        default: /* ȫ豸û DEVICE_QUALIFIER  */
+            myUSB_ctrl_stall(hpcd);
+            break;
+        }
+        break;
+
+    case 0x08: /* GET_CONFIGURATION */
+        g_usb_ep0_buf[0] = g_usb_config;
+        myUSB_ctrl_in(hpcd, g_usb_ep0_buf, 1, w_length);
+        break;
+
+    case 0x09: /* SET_CONFIGURATION */
+        if (value > 1)
+        {
+            myUSB_ctrl_stall(hpcd);
+            break;
+        }
+        myUSB_set_config(hpcd, (uint8_t)value);
+        myUSB_ctrl_status(hpcd);
+        break;
+
+    case 0x0A: /* GET_INTERFACE: ֻб0 */
+        g_usb_ep0_buf[0] = 0;
+        myUSB_ctrl_in(hpcd, g_usb_ep0_buf, 1, w_length);
+        break;
+
+    case 0x0B: /* SET_INTERFACE */
+        myUSB_ctrl_status(hpcd);
+        break;
+
+    default:
+        myUSB_ctrl_stall(hpcd);
+        break;
+    }
+}
+
+/* CDC  */
+static void myUSB_class_request(PCD_HandleTypeDef *hpcd, const uint8_t *setup, uint16_t value, uint16_t w_length)
+{
+    switch (setup[1])
+    {
+    case myUSB_CDC_SET_LINE_CODING: /* ʶ USB û, ¼ */
+        g_usb_ep0_state = myUSB_EP0_DATA_OUT;
+        HAL_PCD_EP_Receive(hpcd, 0x00, g_usb_line_coding, w_length < 7 ? w_length : 7);
+        break;
+
+    case myUSB_CDC_GET_LINE_CODING:
+        myUSB_ctrl_in(hpcd, g_usb_line_coding, sizeof(g_usb_line_coding), w_length);
+        break;
+
+    case myUSB_CDC_SET_CONTROL_LINE_STATE: /* bit0: DTR, ն˳򿪶˿ʱλ */
+        g_usb_dtr = value & 1;
+        myUSB_update_online();
+        myUSB_ctrl_status(hpcd);
+        break;
+
+    case myUSB_CDC_SEND_BREAK:
+        myUSB_ctrl_status(hpcd);
+        break;
+
+    default:
+        myUSB_ctrl_stall(hpcd);
+        break;
+    }
+}
+
+/**
+ * @brief       HAL PCD ص: յ SETUP 
+ * @param       hpcd: USB 
+ * @retval      
+ */
+void HAL_PCD_SetupStageCallback(PCD_HandleTypeDef *hpcd)
+{
+    const uint8_t *setup = (const uint8_t *)hpcd->Setup;
+    uint16_t value = setup[2] | ((uint16_t)setup[3] << 8);
+    uint16_t w_length = setup[6] | ((uint16_t)setup[7] << 8);
+
+    switch (setup[0] & 0x60)
+    {
+    case 0x00:
+        myUSB_std_request(hpcd, setup, value, w_length);
+        break;
+
+    case 0x20:
+        myUSB_class_request(hpcd, setup, value, w_length);
+        break;
+
+    default:
+        myUSB_ctrl_stall(hpcd);
+        break;
+    }
+}
+
+/**
+ * @brief       HAL PCD ص: IN 
+ * @param       hpcd : USB 
+ * @param       epnum: ˵
+ * @retval      
+ */
+void HAL_PCD_DataInStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
+{
+    if (epnum == 0)
+    {
+        if (g_usb_ep0_state == myUSB_EP0_DATA_IN)
+        {
+            g_usb_ep0_state = myUSB_EP0_STATUS;
+            HAL_PCD_EP_Receive(hpcd, 0x00, NULL, 0); /* ״̬׶: 㳤Ȱ */
+        }
+        else
+        {
+            g_usb_ep0_state = myUSB_EP0_IDLE;
+        }
+    }
+    else if (epnum == (myUSB_EP_IN & 0x7F))
+    {
+        myUSB_tx_done(&g_usb_cdc);
+        myUSB_tx_start();
+    }
+}
+
+/**
+ * @brief       HAL PCD ص: OUT 
+ * @param       hpcd : USB 
+ * @param       epnum: ˵
+ * @retval      
+ */
+void HAL_PCD_DataOutStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
+{
+    if (epnum == 0)
+    {
+        if (g_usb_ep0_state == myUSB_EP0_DATA_OUT)
+        {
+            myUSB_ctrl_status(hpcd); /* SET_LINE_CODING յ */
+        }
+        else
+        {
+            g_usb_ep0_state = myUSB_EP0_IDLE;
+        }
+    }
+    else if (epnum == myUSB_EP_OUT)
+    {
+        uint16_t len = (uint16_t)HAL_PCD_EP_GetRxCount(hpcd, myUSB_EP_OUT);
+
+        if (myUSB_rx_push(&g_usb_cdc, g_usb_rx_pkt, len))
+        {
+            myUSB_rx_start();
+        }
+    }
+}
+
+/**
+ * @brief       HAL PCD ص: ߸λ, 򿪿ƶ˵, صδ״̬
+ * @param       hpcd: USB 
+ * @retval      
+ */
+void HAL_PCD_ResetCallback(PCD_HandleTypeDef *hpcd)
+{
+    HAL_PCD_EP_Open(hpcd, 0x00, myUSB_EP_SIZE, EP_TYPE_CTRL);
+    HAL_PCD_EP_Open(hpcd, 0x80, myUSB_EP_SIZE, EP_TYPE_CTRL);
+    g_usb_ep0_state = myUSB_EP0_IDLE;
+    g_usb_config = 0;
+    g_usb_dtr = 0;
+    g_usb_suspended = 0;
+    myUSB_cdc_reset(&g_usb_cdc, 0);
+}
+
+/**
+ * @brief       HAL PCD ص: ߹/ָ, ڼ䷢͵ֱӶ
+ * @param       hpcd: USB 
+ * @retval      
+ */
+void HAL_PCD_SuspendCallback(PCD_HandleTypeDef *hpcd)
+{
+    (void)hpcd;
+    g_usb_suspended = 1;
+    myUSB_update_online();
+}
+
+void HAL_PCD_ResumeCallback(PCD_HandleTypeDef *hpcd)
+{
+    (void)hpcd;
+    g_usb_suspended = 0;
+    myUSB_update_online();
+}
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ ****************************************************************************************************
+ * @file        myUSB.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * USB ȫ CDC-ACM ⴮(myLINK_USB Ϊ 1 ʱ USART1,  myLINK.h):
+ * 1, 豸öٺ CDC ڱļ, ײշ HAL PCD ;
+ *     IN/OUT ˵㶼Ϊ˫, һ(д)ʱӲͬʱʹһ
+ * 2, : д myUSB_TX_RING λ, IN ˵ʱȡһ( myUSB_TX_CHUNK)˵,
+ *    жƶλȡһ; 䳤ǰһѿʱһ㳤Ȱ, Ķȡ
+ * 3, ѹ: ͻʱ myUSB_write() ȴ, myUSB_TX_TIMEOUT_MS ûнչŶ( tx_drop);
+ *    ջŲ myUSB_RX_ARM ֽʱ OUT ˵, յ NAK ط, 
+ * 4, ûд򿪶˿(DTR Ϊ 0)߹ʱ͵ֱӶ, ɼ
+ *
+ * շĹ(㳤Ȱջ NAK ж) HAL:
+ *  myUSB_CORE_ONLY ֻⲿ,  PC  gcc (sim Ŀ¼ make check-usb ӻض˵)
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef _MYUSB_H
+#define _MYUSB_H
+#include <stdint.h>
+
+/******************************************************************************************/
+/*  */
+
+#define myUSB_EP_SIZE 64                  /* ȫ˵ */
+#define myUSB_TX_RING 1024                /* ͻλ, ֽ, 2 */
+#define myUSB_TX_CHUNK (8 * myUSB_EP_SIZE) /*  IN 󳤶 */
+#define myUSB_RX_RING 256                 /* ջλ, ֽ, 2 */
+#define myUSB_RX_ARM (2 * myUSB_EP_SIZE)  /*  OUT ĳ: һ */
+#define myUSB_TX_TIMEOUT_MS 20            /* ͻʱȴȡʱ, ʱ */
+
+#if (myUSB_TX_RING & (myUSB_TX_RING - 1)) || (myUSB_RX_RING & (myUSB_RX_RING - 1))
+#error "myUSB_TX_RING  myUSB_RX_RING 2"
+#endif
+
+/* շ״̬; дλɵ, õ, ʱԻ泤ȡģ */
+typedef struct
+{
+    uint8_t tx_buf[myUSB_TX_RING];
+    uint16_t tx_head;     /* дλ */
+    uint16_t tx_tail;     /* λ, IN ɺƶ */
+    uint16_t tx_len;      /* ڴֽ */
+    uint8_t tx_busy;      /* IN ˵д(㳤Ȱ) */
+    uint8_t tx_zlp;       /* һδǰ, ʱ貹㳤Ȱ */
+    uint8_t rx_buf[myUSB_RX_RING];
+    uint16_t rx_head;
+    uint16_t rx_tail;
+    uint8_t rx_parked;    /* ջ治, OUT ˵δ(յ NAK) */
+    uint8_t online;       /* ˶˿ */
+    uint32_t tx_drop;     /* ķֽ */
+} myUSB_CDC;
+
+/******************************************************************************************/
+/* շ( HAL) */
+
+void myUSB_cdc_reset(myUSB_CDC *cdc, uint8_t online);                     /* շ */
+uint16_t myUSB_tx_space(const myUSB_CDC *cdc);                            /* ͻʣռ */
+uint16_t myUSB_tx_push(myUSB_CDC *cdc, const uint8_t *data, uint16_t len); /* д뷢ͻ, дֽ */
+uint8_t myUSB_tx_next(myUSB_CDC *cdc, const uint8_t **data, uint16_t *len); /* IN ˵ʱȡһδ */
+void myUSB_tx_done(myUSB_CDC *cdc);                                        /* IN  */
+uint8_t myUSB_rx_push(myUSB_CDC *cdc, const uint8_t *data, uint16_t len);  /* OUT , Ƿ OUT */
+uint16_t myUSB_rx_pop(myUSB_CDC *cdc, uint8_t *buf, uint16_t max);          /* ȡ */
+uint8_t myUSB_rx_unpark(myUSB_CDC *cdc);                                   /* ȡݺǷӦ OUT */
+
+#ifndef myUSB_CORE_ONLY
+#include "./SYSTEM/sys/sys.h"
+#include "myCFG.h"
+
+#if myCFG_SYSCLK != 72000000
+#error "USB ʱȡ PLL / 1.5, ϵͳʱӱ 72MHz"
+#endif
+
+/******************************************************************************************/
+/* USB  
+ * ע: ԭ F103  D+ ̶ 3.3V, λ PA12 һʱ, Żö
+ */
+
+#define myUSB_IRQn USB_LP_CAN1_RX0_IRQn
+#define myUSB_IRQHandler USB_LP_CAN1_RX0_IRQHandler
+#define myUSB_DP_GPIO_PORT GPIOA
+#define myUSB_DP_GPIO_PIN GPIO_PIN_12
+#define myUSB_REENUM_MS 20 /*  D+ ʱ */
+
+/* ˵ַ */
+#define myUSB_EP_IN 0x81  /*  IN: 豸 ->  */
+#define myUSB_EP_OUT 0x01 /*  OUT:  -> 豸 */
+#define myUSB_EP_CMD 0x82 /* ж IN: CDC ֪ͨ, ʹõ */
+
+/* ˵ڰ(PMA)еĵַ: ǰ 0x40 ֽǶ˵ */
+#define myUSB_PMA_EP0_OUT 0x40
+#define myUSB_PMA_EP0_IN 0x80
+#define myUSB_PMA_IN_0 0xC0
+#define myUSB_PMA_IN_1 0x100
+#define myUSB_PMA_OUT_0 0x140
+#define myUSB_PMA_OUT_1 0x180
+#define myUSB_PMA_CMD 0x1C0
+
+/******************************************************************************************/
+/* ⲿӿں*/
+
+void myUSB_init(void);                                   /* ʼ USB , ʼö */
+uint8_t myUSB_online(void);                              /* Ѵ򿪶˿ */
+uint16_t myUSB_write(const uint8_t *data, uint16_t len); /* д뷢ͻ, ʱȴ, дֽ */
+uint8_t myUSB_tx_idle(void);                             /* ͻݶѱ */
+uint32_t myUSB_tx_drop(void);                            /* ۼƶķֽ */
+uint16_t myUSB_read(uint8_t *buf, uint16_t max);         /* ȡ,  USB ж */
+void myUSB_rx_kick(void);                                /*  USB жٵһ myUSB_rx_callback */
+void myUSB_rx_callback(void);                            /* OUT ˵յݺ USB ж,  */
+
+#endif
+
+#endif
@@ -0,0 +1,349 @@
+/**
+ ****************************************************************************************************
+ * @file        myVALID.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ ****************************************************************************************************
+ */
+
+#include <math.h>
+#include <string.h>
+#include "myVALID.h"
+
+/* Сд bytes ֽ, һдλ */
+static uint8_t *myvalid_put(uint8_t *p, uint32_t v, uint8_t bytes)
+{
+    while (bytes--)
+    {
+        *p++ = (uint8_t)v;
+        v >>= 8;
+    }
+    return p;
+}
+
+/**
+ * @brief       صʼ״̬
+ * @param       st: У״̬
+ * @retval      
+ */
+void myVALID_reset(myVALID_STATE *st)
+{
+    memset(st, 0, sizeof(*st));
+}
+
+/**
+ * @brief       ڼһ, ʱɾĲ
+ *   @note      /ɾƶ myVALID_WIN Ԫ
+ * @param       st: У״̬
+ * @param       x : һײ, LSB
+ * @retval      
+ */
+static void myvalid_push(myVALID_STATE *st, float x)
+{
+    uint8_t i;
+
+    if (st->n == myVALID_WIN)
+    {
+        float old = st->ring[st->head];
+
+        for (i = 0; i + 1 < st->n && st->sorted[i] != old; i++)
+        {
+        }
+        for (; i + 1 < st->n; i++)
+        {
+            st->sorted[i] = st->sorted[i + 1];
+        }
+        st->n--;
+    }
+    for (i = st->n; i > 0 && st->sorted[i - 1] > x; i--)
+    {
+        st->sorted[i] = st->sorted[i - 1];
+    }
+    st->sorted[i] = x;
+    st->n++;
+    st->ring[st->head] = x;
+    st->head = (st->head + 1) % myVALID_WIN;
+}
+
+/**
+ * @brief       ڲֵֵ MAD(ֵ֮ľֵֵ)
+ *   @note      иֵƫֵҲҵ,
+ *              ֵ鲢õƫ, ȡ n/2 Ϊֹ, Ҫ
+ * @param       st    : У״̬,  2 
+ * @param       median: ֵ
+ * @param       mad   :  MAD
+ * @retval      
+ */
+static void myvalid_stats(const myVALID_STATE *st, float *median, float *mad)
+{
+    const float *s = st->sorted;
+    uint8_t n = st->n, half = n / 2, k, r;
+    int8_t l;
+    float m, d = 0, d_prev = 0;
+
+    m = (n & 1) ? s[half] : (s[half - 1] + s[half]) / 2;
+    for (l = (int8_t)(n - 1); l >= 0 && s[l] > m; l--)
+    {
+    }
+    r = (uint8_t)(l + 1);
+
+    for (k = 0; k <= half; k++)
+    {
+        if (r >= n || (l >= 0 && m - s[l] <= s[r] - m))
+        {
+            d = m - s[l--];
+        }
+        else
+        {
+            d = s[r++] - m;
+        }
+        if (k + 1 == half)
+        {
+            d_prev = d;
+        }
+    }
+    *median = m;
+    *mad = (n & 1) ? d : (d_prev + d) / 2;
+}
+
+/**
+ * @brief       Уһ
+ *   @note      Խ޵ĵ㲻Ⱥͱ仯ʼ; õ(־Ϊ 0)Ÿ±仯ʵĻ׼.
+ *              st->rise / st->fall ³ֺʧı־, Ϊ 0 ʱӦ͹¼
+ * @param       st     : У״̬
+ * @param       t_ms   : ʱ, ms
+ * @param       adc_sum:  ADC ۼӺ
+ * @param       len    : 
+ * @param       r      : ֵ, M
+ * @retval      myVALID_FLAG_* , 0 ʾõ
+ */
+uint8_t myVALID_check(myVALID_STATE *st, uint32_t t_ms, uint32_t adc_sum, uint16_t len, float r)
+{
+    uint16_t adc = len ? (uint16_t)(adc_sum / len) : 0;
+    uint8_t flags = 0, before = st->active, off;
+    float x = len ? (float)adc_sum / len : 0, lr, dt, thr, slope;
+
+    if (st->have_sum && adc_sum == st->last_sum)
+    {
+        if (st->same_cnt < 0xFFFF)
+        {
+            st->same_cnt++;
+        }
+    }
+    else
+    {
+        st->same_cnt = 0;
+    }
+    st->last_sum = adc_sum;
+    st->have_sum = 1;
+
+    if (adc <= myVALID_ADC_MIN)
+    {
+        flags = myVALID_FLAG_OPEN;
+    }
+    else if (adc >= myVALID_ADC_MAX)
+    {
+        flags = myVALID_FLAG_SAT;
+    }
+    else if (!(r >= myVALID_R_MIN && r <= myVALID_R_MAX)) /* NaN ıȽ϶Ϊ */
+    {
+        flags = myVALID_FLAG_RANGE;
+    }
+    if (flags)
+    {
+        st->prev_off = 1; /* Խ޺ĵһ last_x ̫, Ⱥ */
+    }
+    else
+    {
+        if (st->same_cnt + 1 >= myVALID_STUCK_N && (uint32_t)(st->same_cnt + 1) * len >= myVALID_STUCK_SAMPLES)
+        {
+            flags |= myVALID_FLAG_STUCK;
+        }
+
+        thr = myVALID_MAD_K_X10 / 10.0f * 1.4826f * myVALID_MAD_FLOOR; /* 1.4826  MAD: ֲ̬ʱڱ׼ */
+        if (st->n >= myVALID_WIN_MIN)
+        {
+            myvalid_stats(st, &slope, &st->mad);
+            st->pred = st->last_x + slope;
+            if (st->mad > myVALID_MAD_FLOOR)
+            {
+                thr = myVALID_MAD_K_X10 / 10.0f * 1.4826f * st->mad;
+            }
+            off = fabsf(x - st->pred) > thr;
+            if (off && !st->prev_off)
+            {
+                flags |= myVALID_FLAG_OUTLIER;
+            }
+            st->prev_off = off;
+        }
+        else
+        {
+            st->prev_off = 0;
+        }
+        if (st->have_x)
+        {
+            myvalid_push(st, x - st->last_x);
+        }
+        st->last_x = x;
+        st->have_x = 1;
+
+        /* ֵ仯ֵڵĲ㳬: ÿֻм㡢 1ms ʱ dt Ϊ 0 */
+        lr = log10f(r);
+        if (st->have_good && fabsf(x - st->good_code) > thr)
+        {
+            dt = (float)(t_ms - st->good_ms) / 1000;
+            if (fabsf(lr - st->good_x) > myVALID_RATE_X100 / 100.0f * dt)
+            {
+                flags |= myVALID_FLAG_RATE;
+            }
+        }
+        if (!flags)
+        {
+            st->good_x = lr;
+            st->good_code = x;
+            st->good_ms = t_ms;
+            st->have_good = 1;
+        }
+    }
+
+    st->active = flags;
+    st->rise = flags & ~before;
+    st->fall = before & ~flags;
+    st->last_adc = adc;
+    st->last_r = r;
+    st->last_ms = t_ms;
+    st->total++;
+    if (flags)
+    {
+        st->bad++;
+    }
+    if (st->rise | st->fall)
+    {
+        st->events++;
+    }
+    return flags;
+}
+
+/**
+ * @brief       ¼л(С)
+ *   @note      ظʽ:
+ *              汾(u8) ³ֵı־(u8) ʧı־(u8) ǰ־(u8) ʱms(u32) ADCֵ(u16)
+ *              ֵM(float32) Ԥֵ(u16, LSB16) MAD(u16, LSB100)
+ *              У(u32) (u32) ¼(u32)
+ * @param       st : У״̬
+ * @param       buf: ,  myVALID_PAYLOAD_SIZE
+ * @retval      س
+ */
+uint16_t myVALID_serialize(const myVALID_STATE *st, uint8_t *buf)
+{
+    uint8_t *p = buf;
+    uint32_t bits;
+    float pred = (st->pred > 0 ? st->pred : 0) * 16 + 0.5f, mad = st->mad * 100 + 0.5f;
+
+    *p++ = myVALID_VERSION;
+    *p++ = st->rise;
+    *p++ = st->fall;
+    *p++ = st->active;
+    p = myvalid_put(p, st->last_ms, 4);
+    p = myvalid_put(p, st->last_adc, 2);
+    memcpy(&bits, &st->last_r, sizeof(bits)); // float  IEEE754 λģʽ
+    p = myvalid_put(p, bits, 4);
+    p = myvalid_put(p, pred > 65535 ? 65535 : (uint16_t)pred, 2);
+    p = myvalid_put(p, mad > 65535 ? 65535 : (uint16_t)mad, 2);
+    p = myvalid_put(p, st->total, 4);
+    p = myvalid_put(p, st->bad, 4);
+    p = myvalid_put(p, st->events, 4);
+    return (uint16_t)(p - buf);
+}
+
+#ifndef myVALID_CORE_ONLY
+
+/***************************************̼ӿ*****************************************/
+
+#include "myFRAME.h"
+
+static myVALID_STATE g_myvalid;                          /* У״̬, ȫ 0 ʼ״̬ */
+static uint8_t g_myvalid_mode = myVALID_MODE_DEFAULT;    /* ʽ */
+static volatile uint8_t g_myvalid_clear;                 /* һУǰ״̬ */
+
+/**
+ * @brief       Уһ, йϳֻʧʱ myFRAME_TYPE_FAULT ֡
+ *   @note      ÿݻֵ(ѭ myTASK )
+ * @param       t_ms   : ʱ, ms
+ * @param       adc_sum:  ADC ۼӺ
+ * @param       len    : 
+ * @param       r      : ֵ, M
+ * @retval      myVALID_FLAG_* ; ʽΪ OFF ʱ 0
+ */
+uint8_t myVALID_sample(uint32_t t_ms, uint32_t adc_sum, uint16_t len, float r)
+{
+    uint8_t payload[myVALID_PAYLOAD_SIZE];
+    uint8_t flags;
+
+    if (g_myvalid_mode == myVALID_MODE_OFF)
+    {
+        return 0;
+    }
+    if (g_myvalid_clear)
+    {
+        g_myvalid_clear = 0;
+        myVALID_reset(&g_myvalid);
+    }
+    flags = myVALID_check(&g_myvalid, t_ms, adc_sum, len, r);
+    if (g_myvalid.rise | g_myvalid.fall)
+    {
+        myFRAME_send(myFRAME_TYPE_FAULT, payload, myVALID_serialize(&g_myvalid, payload));
+    }
+    return flags;
+}
+
+/**
+ * @brief       ʽжǷ
+ * @param       flags: myVALID_sample ķֵ
+ * @retval      0, ; 1, 
+ */
+uint8_t myVALID_output(uint8_t flags)
+{
+    return flags == 0 || g_myvalid_mode != myVALID_MODE_DROP;
+}
+
+/**
+ * @brief       ʽ
+ *   @note      ͬʱУ״̬, »۴; ƳٵһУ֮ǰ, ɲڵ
+ * @param       mode: myVALID_MODE_OFF / myVALID_MODE_TAG / myVALID_MODE_DROP
+ * @retval      
+ */
+void myVALID_set_mode(uint8_t mode)
+{
+    g_myvalid_mode = mode;
+    g_myvalid_clear = 1;
+}
+
+/**
+ * @brief       ǰʽ
+ * @param       
+ * @retval      myVALID_MODE_OFF / myVALID_MODE_TAG / myVALID_MODE_DROP
+ */
+uint8_t myVALID_get_mode(void)
+{
+    return g_myvalid_mode;
+}
+
+/**
+ * @brief       У״̬
+ *   @note      VALID ݴӦ𻵵У
+ * @param       
+ * @retval      У״̬
+ */
+const myVALID_STATE *myVALID_state(void)
+{
+    return &g_myvalid;
+}
+
+#endif
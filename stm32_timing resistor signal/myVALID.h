@@ -0,0 +1,126 @@
+/**
+ ****************************************************************************************************
+ * @file        myVALID.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * У: ÿݻֵ, 豸Ͼʹǻ, дλ CSV
+ * 1, Խ: ADC ֵӽ 0(·, R = (3.26 - V) * 4.96 / V Ϊ inf/NaN)ӽ 3.26V 
+ *    (, ֵ 0 Ϊ), ֵ [myVALID_R_MIN, myVALID_R_MAX] 
+ * 2, 仯: һõ, ֵ仯 myVALID_RATE_X100 / 100 ʮÿ, ֵ֮
+ *    Ⱥֵ; ı仯ʱ, ʵĽԾֻһ, ֮Զµˮƽ
+ * 3, Ⱥ(Hampel):  ADC ֵ(ۼӺ / , ȡ)ֵж, ADC Ǽֵϵ,
+ *    ֵڵʮ޹. ȡ myVALID_WIN һײ(ڵĵ֮)ֵΪ
+ *    ֲб, һбʼԤֵ, Ԥֵ֮ myVALID_MAD_K_X10 / 10  1.4826  ֵ MAD
+ *    ʱõƫ. òֶǵƽͳ, ջԾеƶŴ MAD 򱻵ɼ.
+ *    ֻǰһûƫ(ҲԽ޺ĵһ)ʱΪȺ: 屻, Ծֻ뿪
+ *    ԭˮƽĵһ, ֮ĵ(Լϵļ)ɱ仯ʼѹ
+ * 4, :  ADC ۼӺ myVALID_STUCK_N 顢ϼ myVALID_STUCK_SAMPLES ȫͬ
+ *    (ʵźƽǰ LSB ; ÿֻһʱֵͬܳ, ԻҪܵ)
+ * ÿ״ֻ̬й̶С myVALID_STATE(Ϊ + λ, ɾ MAD  O()),
+ * ڴ
+ *
+ * ĳϳֻʧʱ myFRAME_TYPE_FAULT ֡(ʽ myVALID_serialize), λº;
+ * ʽ VALID (myCMD.h): TAG ճǻ(ıк " !־", ֡ĩβӱ־ֽ),
+ * DROP , OFF У
+ *
+ *  myVALID_CORE_ONLY ֻУ㷨,  HAL,  PC  gcc 
+ * (sim Ŀ¼ make check-valid, עϵĺϳʺ)
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef _MYVALID_H
+#define _MYVALID_H
+#include <stdint.h>
+
+/******************************************************************************************/
+/*  */
+
+#define myVALID_ADC_MIN 2          /* ADC ֵڴֵΪ·(Լ 5000M ) */
+#define myVALID_ADC_MAX 4040       /* ADC ֵСڴֵΪ(3.26V Ӧ 4046) */
+#define myVALID_R_MIN 0.001f       /* ֵ, M */
+#define myVALID_R_MAX 5000.0f      /* ֵ, M */
+#define myVALID_RATE_X100 200      /* 仯, ʮ/  100 */
+#define myVALID_WIN 15             /* ֵ/MAD ڵ */
+#define myVALID_WIN_MIN 5          /* ôʱȺ */
+#define myVALID_MAD_K_X10 60       /* Ⱥֵ, MAD ׼Ƶı  10 */
+#define myVALID_MAD_FLOOR 1.0f     /* MAD , LSB; ƽСʱ MAD Ϊ 0 */
+#define myVALID_STUCK_N 10         /* ۼӺͬĿ */
+#define myVALID_STUCK_SAMPLES 256  /* ͬʱҪЩϼƵĵ */
+#define myVALID_VERSION 1          /* ϸظʽ汾 */
+
+/* У־, 0 ʾõ */
+#define myVALID_FLAG_OPEN 0x01     /* · */
+#define myVALID_FLAG_SAT 0x02      /*  */
+#define myVALID_FLAG_RANGE 0x04    /* ֵ޻򳬳Χ */
+#define myVALID_FLAG_RATE 0x08     /* 仯ʳ */
+#define myVALID_FLAG_OUTLIER 0x10  /* Ⱥ */
+#define myVALID_FLAG_STUCK 0x20    /*  */
+#define myVALID_FLAG_NUM 6
+
+/* ʽ,  myCMD_VALID_MODE һ */
+#define myVALID_MODE_OFF 0         /* У */
+#define myVALID_MODE_TAG 1         /* ȫ, ־ */
+#define myVALID_MODE_DROP 2        /*  */
+#define myVALID_MODE_DEFAULT myVALID_MODE_DROP
+
+/* ϸس: 汾  ʧ ǰ(4u8) ʱ(u32) ADCֵ(u16) ֵ(f32) Ԥֵ(u16) MAD(u16) (3u32) */
+#define myVALID_PAYLOAD_SIZE 30
+
+/* У״̬, ȫ 0 Ϊʼ״̬ */
+typedef struct
+{
+    float ring[myVALID_WIN];       /* һײ, LSB, ˳ */
+    float sorted[myVALID_WIN];     /* ֵͬ,  */
+    float last_x;                  /* һڵĵ ADC ֵ, LSB */
+    uint8_t n;                     /* ڵ */
+    uint8_t head;                  /* λһдλ */
+    uint8_t have_good;             /* кõ */
+    uint8_t have_x;                /* last_x Ч */
+    uint8_t prev_off;              /* һƫԤֵԽ */
+    uint8_t have_sum;              /* ۼӺ */
+    uint8_t active;                /* ǰı־ */
+    uint8_t rise;                  /* ³ֵı־ */
+    uint8_t fall;                  /* ʧı־ */
+    float good_x;                  /* һõ log10(ֵ) */
+    float good_code;               /* һõ ADC ֵ, LSB */
+    uint32_t good_ms;              /* һõʱ, ms */
+    uint32_t last_sum;             /* һ ADC ۼӺ */
+    uint16_t same_cnt;             /* ۼӺͬĴ */
+    uint16_t last_adc;             /*  ADC ֵ */
+    float last_r;                  /* ֵ */
+    uint32_t last_ms;              /* ʱ */
+    float pred;                    /* һжȺʱԤֵ, LSB */
+    float mad;                     /* һжȺʱֵ MAD, LSB */
+    uint32_t total;                /* Уĵ */
+    uint32_t bad;                  /* еĻ */
+    uint32_t events;               /* ״̬仯 */
+} myVALID_STATE;
+
+/******************************************************************************************/
+/* У㷨( HAL) */
+
+void myVALID_reset(myVALID_STATE *st);                                                  /* صʼ״̬ */
+uint8_t myVALID_check(myVALID_STATE *st, uint32_t t_ms, uint32_t adc_sum, uint16_t len, float r); /* Уһ, ر־ */
+uint16_t myVALID_serialize(const myVALID_STATE *st, uint8_t *buf);                      /* ¼л */
+
+#ifndef myVALID_CORE_ONLY
+
+/******************************************************************************************/
+/* ⲿӿں*/
+
+uint8_t myVALID_sample(uint32_t t_ms, uint32_t adc_sum, uint16_t len, float r); /* У鲢״̬仯ʱ͹֡, ر־ */
+uint8_t myVALID_output(uint8_t flags);                                          /* ʽжǷ */
+void myVALID_set_mode(uint8_t mode);                                            /* ʽ, ͬʱУ״̬ */
+uint8_t myVALID_get_mode(void);                                                 /* ǰʽ */
+const myVALID_STATE *myVALID_state(void);                                       /* У״̬() */
+
+#endif
+
+#endif
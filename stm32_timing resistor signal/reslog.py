@@ -0,0 +1,430 @@
+import os
+import sys
+import csv
+import time
+import zlib
+import struct
+import tempfile
+import numpy as np
+import pandas as pd
+
+# Columnar log for (time, value) acquisition output, replacing the per-row text CSV.
+#
+# File layout, little endian:
+#   file header  'RLOG' | version u16 | flags u16 | tick f64 | resolution f64
+#   block*       'RBLK' | n u32 | t_first i64 | t_last i64 | dt_first i64 | q_first i64 | q_min i64 | q_max i64
+#                | time width u8 | value width u8 | time bytes u32 | value bytes u32 | crc32 u32
+#                | time payload | value payload
+#
+# Times are stored as integer ticks (default 1 us) and values as integers of `resolution` (default
+# 1e-4, the firmware prints "%.4f"); anything finer than half a tick / half a resolution step is
+# rounded away. Per block, times are delta-of-delta coded and values delta coded; the residuals are
+# zigzagged, packed at the narrowest of 1/2/4/8 bytes, byte-shuffled and deflated at level 1.
+#
+# Each block is self-contained and written with one write() call, and the header carries the time
+# and value range of the block, so a reader seeks to a time range by scanning block headers only.
+# A block cut short by a crash or still being written is ignored by readers and dropped when a
+# writer reopens the file, so the log can be read while acquisition runs.
+
+FILE_HEADER = struct.Struct('<4sHHdd')
+BLOCK_HEADER = struct.Struct('<4sIqqqqqqBBIII')
+FILE_MAGIC = b'RLOG'
+BLOCK_MAGIC = b'RBLK'
+VERSION = 1
+
+DEFAULT_TICK = 1e-6            # Time quantum in seconds
+DEFAULT_RESOLUTION = 1e-4      # Value quantum, matches the firmware's "%.4f"
+BLOCK_ROWS = 65536             # Rows per full block
+COMPRESS_LEVEL = 1
+FLUSH_SECONDS = 30             # Live writers flush a short block this often; a crash loses at most this much
+
+# Benchmark configuration
+BENCH_RATE_HZ = 10             # Photodiode preset report rate (myCFG_SENSOR 1)
+BENCH_SECONDS = 7 * 24 * 3600  # One week
+BENCH_PER_ROW_SAMPLE = 20000   # Rows timed through the old open-append-close path, then extrapolated
+BENCH_QUERY_SECONDS = 3600     # Range query length
+
+
+def _zigzag(x):
+    return ((x << 1) ^ (x >> 63)).view(np.uint64)
+
+
+def _unzigzag(z):
+    """In place on a uint64 array; returns it viewed as int64."""
+    sign = z & np.uint64(1)
+    np.negative(sign, out=sign)
+    z >>= np.uint64(1)
+    z ^= sign
+    return z.view(np.int64)
+
+
+def _pack(residuals):
+    """Zigzag, narrowest width, byte shuffle, deflate. Returns (width, payload)."""
+    z = _zigzag(residuals.astype(np.int64))
+    top = int(z.max()) if len(z) else 0
+    width = 1 if top < 1 << 8 else 2 if top < 1 << 16 else 4 if top < 1 << 32 else 8
+    raw = z.astype(f'<u{width}').view(np.uint8).reshape(-1, width).T.tobytes()
+    return width, zlib.compress(raw, COMPRESS_LEVEL)
+
+
+def _unpack(payload, width, count):
+    planes = np.frombuffer(zlib.decompress(payload), np.uint8).reshape(width, count)
+    z = planes[0].astype(np.uint64)
+    for k in range(1, width):
+        z |= planes[k].astype(np.uint64) << np.uint64(8 * k)
+    return _unzigzag(z)
+
+
+def _encode_block(ticks, q):
+    n = len(ticks)
+    dt_first = int(ticks[1] - ticks[0]) if n > 1 else 0
+    tw, tp = _pack(np.diff(ticks, 2))
+    vw, vp = _pack(np.diff(q))
+    crc = zlib.crc32(vp, zlib.crc32(tp))
+    header = BLOCK_HEADER.pack(BLOCK_MAGIC, n, int(ticks[0]), int(ticks[-1]), dt_first, int(q[0]),
+                               int(q.min()), int(q.max()), tw, vw, len(tp), len(vp), crc)
+    return header + tp + vp
+
+
+def _decode_block(header, payload):
+    _, n, t_first, _, dt_first, q_first, _, _, tw, vw, tlen, vlen, crc = header
+    tp, vp = payload[:tlen], payload[tlen:tlen + vlen]
+    if zlib.crc32(vp, zlib.crc32(tp)) != crc:
+        raise ValueError("reslog: block checksum mismatch")
+    deltas = np.empty(max(n - 1, 0), np.int64)
+    if n > 1:
+        deltas[0] = dt_first
+        deltas[1:] = dt_first + np.cumsum(_unpack(tp, tw, n - 2))
+    ticks = np.empty(n, np.int64)
+    ticks[0] = t_first
+    np.cumsum(deltas, out=ticks[1:])
+    ticks[1:] += t_first
+    q = np.empty(n, np.int64)
+    q[0] = q_first
+    np.cumsum(_unpack(vp, vw, n - 1), out=q[1:])
+    q[1:] += q_first
+    return ticks, q
+
+
+class RLogReader:
+    """Random access to a log by time range; `refresh()` picks up blocks appended since opening."""
+
+    def __init__(self, path):
+        self.path = path
+        self.file = open(path, 'rb')
+        magic, version, _, self.tick, self.resolution = FILE_HEADER.unpack(self.file.read(FILE_HEADER.size))
+        if magic != FILE_MAGIC or version != VERSION:
+            raise ValueError(f"reslog: {path} is not a version {VERSION} log")
+        self.headers, self.offsets = [], []
+        self.end = FILE_HEADER.size
+        self.refresh()
+
+    def refresh(self):
+        """Index complete blocks after the last one seen; only block headers are read."""
+        size = os.fstat(self.file.fileno()).st_size
+        if self.headers and self.end + BLOCK_HEADER.size > size:
+            return len(self.headers)  # Nothing new; cheap enough to poll
+        while self.end + BLOCK_HEADER.size <= size:
+            self.file.seek(self.end)
+            header = BLOCK_HEADER.unpack(self.file.read(BLOCK_HEADER.size))
+            block_end = self.end + BLOCK_HEADER.size + header[10] + header[11]
+            if header[0] != BLOCK_MAGIC or block_end > size:
+                break  # Torn or still being written
+            self.headers.append(header)
+            self.offsets.append(self.end)
+            self.end = block_end
+        index = np.array([h[2:4] + h[6:8] + (h[1],) for h in self.headers], np.int64).reshape(-1, 5)
+        self.t_first = index[:, 0] * self.tick
+        self.t_last = index[:, 1] * self.tick
+        self.v_min = index[:, 2] * self.resolution
+        self.v_max = index[:, 3] * self.resolution
+        self.rows = int(index[:, 4].sum())
+        return len(self.headers)
+
+    def replaced(self):
+        """True once the path names a different file, e.g. a logger restarted and recreated it."""
+        try:
+            return os.stat(self.path).st_ino != os.fstat(self.file.fileno()).st_ino
+        except FileNotFoundError:
+            return False
+
+    def __len__(self):
+        return self.rows
+
+    def time_range(self):
+        if not self.headers:
+            return None, None
+        return float(self.t_first[0]), float(self.t_last[-1])
+
+    def block(self, i):
+        """Decode block i into (time, value) float64 arrays."""
+        self.file.seek(self.offsets[i] + BLOCK_HEADER.size)
+        header = self.headers[i]
+        ticks, q = _decode_block(header, self.file.read(header[10] + header[11]))
+        return ticks * self.tick, q * self.resolution
+
+    def blocks_between(self, t0=None, t1=None):
+        """Indices of the blocks overlapping [t0, t1], found by binary search on the header index."""
+        first = 0 if t0 is None else int(np.searchsorted(self.t_last, t0, 'left'))
+        last = len(self.headers) if t1 is None else int(np.searchsorted(self.t_first, t1, 'right'))
+        return range(first, max(first, last))
+
+    def iter_blocks(self, t0=None, t1=None):
+        """Yield (time, value) per block, clipped to [t0, t1]; memory is bounded by one block."""
+        for i in self.blocks_between(t0, t1):
+            t, v = self.block(i)
+            if (t0 is not None and t[0] < t0) or (t1 is not None and t[-1] > t1):
+                keep = (t >= (t[0] if t0 is None else t0)) & (t <= (t[-1] if t1 is None else t1))
+                t, v = t[keep], v[keep]
+            yield t, v
+
+    def read(self, t0=None, t1=None):
+        """All rows in [t0, t1] (inclusive; None means unbounded) as (time, value)."""
+        parts = list(self.iter_blocks(t0, t1))
+        if not parts:
+            return np.empty(0), np.empty(0)
+        return np.concatenate([p[0] for p in parts]), np.concatenate([p[1] for p in parts])
+
+    def to_frame(self, t0=None, t1=None, columns=('time', 'value')):
+        t, v = self.read(t0, t1)
+        return pd.DataFrame({columns[0]: t, columns[1]: v})
+
+    def close(self):
+        self.file.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+class RLogWriter:
+    """Buffer rows and append them to a log in blocks.
+
+    Rows must arrive with non-decreasing times. A block is written when BLOCK_ROWS rows are buffered
+    or when `flush()` is called (e.g. every few seconds during acquisition, so a crash loses at most
+    that much); smaller blocks cost a little compression. Reopening an existing log appends to it
+    with the log's own tick and resolution.
+    """
+
+    def __init__(self, path, tick=DEFAULT_TICK, resolution=DEFAULT_RESOLUTION, block_rows=BLOCK_ROWS,
+                 fsync=False):
+        self.block_rows = block_rows
+        self.fsync = fsync
+        self.last_tick = None
+        if os.path.exists(path) and os.path.getsize(path) >= FILE_HEADER.size:
+            with RLogReader(path) as reader:
+                tick, resolution, end = reader.tick, reader.resolution, reader.end
+                if reader.headers:
+                    self.last_tick = reader.headers[-1][3]
+            self.file = open(path, 'r+b')
+            self.file.truncate(end)  # Drop a block torn by a crash
+            self.file.seek(end)
+        else:
+            self.file = open(path, 'wb')
+            self.file.write(FILE_HEADER.pack(FILE_MAGIC, VERSION, 0, tick, resolution))
+            self.file.flush()
+        self.tick, self.resolution = tick, resolution
+        self.pending_t, self.pending_q = [], []
+        self.pending_rows = 0
+
+    def append(self, t, v):
+        ticks = np.round(np.asarray(t, np.float64) / self.tick).astype(np.int64)
+        q = np.round(np.asarray(v, np.float64) / self.resolution).astype(np.int64)
+        if len(ticks) == 0:
+            return
+        previous = self.last_tick if self.last_tick is not None else ticks[0]
+        if ticks[0] < previous or np.any(np.diff(ticks) < 0):
+            raise ValueError("reslog: times must be non-decreasing")
+        self.last_tick = int(ticks[-1])
+        self.pending_t.append(ticks)
+        self.pending_q.append(q)
+        self.pending_rows += len(ticks)
+        if self.pending_rows >= self.block_rows:
+            self._write_blocks(final=False)
+
+    def _write_blocks(self, final):
+        ticks, q = np.concatenate(self.pending_t), np.concatenate(self.pending_q)
+        full = len(ticks) if final else len(ticks) // self.block_rows * self.block_rows
+        chunks = [_encode_block(ticks[s:s + self.block_rows], q[s:s + self.block_rows])
+                  for s in range(0, full, self.block_rows)]
+        self.file.write(b''.join(chunks))
+        self.file.flush()
+        if self.fsync:
+            os.fsync(self.file.fileno())
+        self.pending_t, self.pending_q = [ticks[full:]], [q[full:]]
+        self.pending_rows = len(ticks) - full
+
+    def flush(self):
+        """Write buffered rows as a (possibly short) block."""
+        if self.pending_rows:
+            self._write_blocks(final=True)
+
+    def close(self):
+        self.flush()
+        self.file.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+def csv_to_rlog(csv_path, rlog_path, tick=DEFAULT_TICK, resolution=DEFAULT_RESOLUTION, chunk_rows=1000000):
+    """Convert a (time, value) CSV, with or without a header row, chunk by chunk."""
+    rows = 0
+    if os.path.exists(rlog_path):
+        os.remove(rlog_path)
+    with RLogWriter(rlog_path, tick, resolution) as writer:
+        for chunk in pd.read_csv(csv_path, header=None, names=['time', 'value'], chunksize=chunk_rows):
+            chunk = chunk.apply(pd.to_numeric, errors='coerce').dropna()
+            writer.append(chunk['time'].values, chunk['value'].values)
+            rows += len(chunk)
+    return rows
+
+
+def rlog_to_csv(rlog_path, csv_path, t0=None, t1=None):
+    rows = 0
+    with RLogReader(rlog_path) as reader, open(csv_path, 'w', newline='') as out:
+        time_digits = max(0, -int(np.floor(np.log10(reader.tick))))
+        digits = max(0, -int(np.floor(np.log10(reader.resolution))))
+        for t, v in reader.iter_blocks(t0, t1):
+            np.savetxt(out, np.column_stack([t, v]), fmt=[f'%.{time_digits}f', f'%.{digits}f'], delimiter=',')
+            rows += len(t)
+    return rows
+
+
+# Benchmark against the CSV path
+def synthetic_recording(rate_hz, seconds, seed=0):
+    """Arrival times with per-read jitter like the live plotter, and a drifting, noisy resistance."""
+    rng = np.random.default_rng(seed)
+    n = int(rate_hz * seconds)
+    t = np.maximum.accumulate(np.arange(n) / rate_hz + rng.uniform(0, 0.004, n))
+    v = 5 + 2 * np.sin(t / 86400 * 2 * np.pi) + rng.normal(0, 0.01, n).cumsum() * 0.01 + rng.normal(0, 0.002, n)
+    return np.round(t, 6), np.round(v, 4)
+
+
+def run_benchmark(rate_hz=BENCH_RATE_HZ, seconds=BENCH_SECONDS):
+    t, v = synthetic_recording(rate_hz, seconds)
+    n = len(t)
+    workdir = tempfile.mkdtemp(prefix='reslog_')
+    csv_path, rlog_path = os.path.join(workdir, 'data.csv'), os.path.join(workdir, 'data.rlog')
+    result = {'rows': n, 'rate_hz': rate_hz, 'hours': round(seconds / 3600, 1)}
+    try:
+        # Old logger: open, append one row, close
+        sample = min(n, BENCH_PER_ROW_SAMPLE)
+        start = time.perf_counter()
+        for i in range(sample):
+            with open(csv_path, mode='a', newline='') as file:
+                csv.writer(file).writerow([t[i], v[i]])
+        result['csv_per_row_write_s_est'] = round((time.perf_counter() - start) * n / sample, 1)
+        os.remove(csv_path)
+
+        start = time.perf_counter()
+        with open(csv_path, 'w', newline='') as file:
+            file.write("Time (s),Resistance (Ohms)\n")
+            np.savetxt(file, np.column_stack([t, v]), fmt=['%.6f', '%.4f'], delimiter=',')
+        result['csv_bulk_write_s'] = round(time.perf_counter() - start, 2)
+
+        # Live-style writer: one append per second of data, a short block every FLUSH_SECONDS
+        start = time.perf_counter()
+        per_second = max(1, int(rate_hz))
+        with RLogWriter(rlog_path) as writer:
+            for second, s in enumerate(range(0, n, per_second)):
+                writer.append(t[s:s + per_second], v[s:s + per_second])
+                if second % FLUSH_SECONDS == FLUSH_SECONDS - 1:
+                    writer.flush()
+        result['rlog_live_write_s'] = round(time.perf_counter() - start, 2)
+        result['rlog_live_mb'] = round(os.path.getsize(rlog_path) / 1e6, 2)
+        os.remove(rlog_path)
+
+        start = time.perf_counter()
+        with RLogWriter(rlog_path) as writer:
+            writer.append(t, v)
+        result['rlog_bulk_write_s'] = round(time.perf_counter() - start, 2)
+
+        result['csv_mb'] = round(os.path.getsize(csv_path) / 1e6, 2)
+        result['rlog_mb'] = round(os.path.getsize(rlog_path) / 1e6, 2)
+        result['size_ratio'] = round(result['csv_mb'] / result['rlog_mb'], 1)
+        result['size_ratio_live'] = round(result['csv_mb'] / result['rlog_live_mb'], 1)
+
+        start = time.perf_counter()
+        df = pd.read_csv(csv_path)
+        result['csv_load_s'] = round(time.perf_counter() - start, 3)
+        start = time.perf_counter()
+        with RLogReader(rlog_path) as reader:
+            rt, rv = reader.read()
+        result['rlog_load_s'] = round(time.perf_counter() - start, 3)
+        result['load_speedup'] = round(result['csv_load_s'] / result['rlog_load_s'], 1)
+        result['max_time_error'] = float(np.max(np.abs(rt - t)))
+        result['max_value_error'] = float(np.max(np.abs(rv - v)))
+        assert len(df) == n == len(rt)
+
+        # One hour from the middle of the recording
+        q0 = t[n // 2] - 0.5 / rate_hz  # Between samples, so both paths agree on the boundary rows
+        q1 = q0 + BENCH_QUERY_SECONDS
+        start = time.perf_counter()
+        df = pd.read_csv(csv_path)
+        column = df.columns[0]
+        selected = df[(df[column] >= q0) & (df[column] <= q1)]
+        result['csv_range_s'] = round(time.perf_counter() - start, 3)
+        start = time.perf_counter()
+        with RLogReader(rlog_path) as reader:
+            rt, _ = reader.read(q0, q1)
+        result['rlog_range_s'] = round(time.perf_counter() - start, 4)
+        assert len(rt) == len(selected)
+        result['range_rows'] = len(rt)
+    finally:
+        for path in (csv_path, rlog_path):
+            if os.path.exists(path):
+                os.remove(path)
+        os.rmdir(workdir)
+    return result
+
+
+def print_benchmark(result):
+    print(f"{result['rows']:,} rows ({result['hours']} h at {result['rate_hz']} Hz)")
+    print(f"  size        CSV {result['csv_mb']:>9.2f} MB   rlog {result['rlog_mb']:>8.2f} MB "
+          f"({result['size_ratio']}x smaller; {result['rlog_live_mb']:.2f} MB / {result['size_ratio_live']}x "
+          f"when flushed every {FLUSH_SECONDS} s)")
+    print(f"  write       CSV per row ~{result['csv_per_row_write_s_est']:.0f}s (est.), bulk "
+          f"{result['csv_bulk_write_s']:.2f}s   rlog live {result['rlog_live_write_s']:.2f}s, bulk "
+          f"{result['rlog_bulk_write_s']:.2f}s")
+    print(f"  full load   pd.read_csv {result['csv_load_s']:.3f}s   rlog {result['rlog_load_s']:.3f}s "
+          f"({result['load_speedup']}x faster)")
+    print(f"  1 h range   pd.read_csv + filter {result['csv_range_s']:.3f}s   rlog {result['rlog_range_s']:.4f}s "
+          f"({result['range_rows']:,} rows)")
+    print(f"  max error   time {result['max_time_error']:.2e} s   value {result['max_value_error']:.2e}")
+
+
+if __name__ == "__main__":
+    # Usage: reslog.py --from-csv data.csv data.rlog [resolution]   -- convert an existing CSV log
+    #        reslog.py --to-csv data.rlog data.csv [t0 t1]           -- export (a time range) as CSV
+    #        reslog.py --info data.rlog                              -- rows, time range, blocks
+    #        reslog.py --benchmark [rate_hz hours]                   -- compare with the CSV path
+    args = sys.argv[1:]
+    if len(args) >= 3 and args[0] == '--from-csv':
+        resolution = float(args[3]) if len(args) > 3 else DEFAULT_RESOLUTION
+        print(f"Rows: {csv_to_rlog(args[1], args[2], resolution=resolution)}")
+        print(f"Size: {os.path.getsize(args[1]) / 1e6:.2f} MB -> {os.path.getsize(args[2]) / 1e6:.2f} MB")
+    elif len(args) >= 3 and args[0] == '--to-csv':
+        bounds = [float(a) for a in args[3:5]] + [None, None]
+        print(f"Rows: {rlog_to_csv(args[1], args[2], bounds[0], bounds[1])}")
+    elif len(args) == 2 and args[0] == '--info':
+        with RLogReader(args[1]) as reader:
+            t0, t1 = reader.time_range()
+            print(f"Rows: {len(reader)}  blocks: {len(reader.headers)}  tick: {reader.tick:g} s  "
+                  f"resolution: {reader.resolution:g}")
+            if reader.headers:
+                print(f"Time: {t0:.6f} .. {t1:.6f} s  value: {reader.v_min.min():g} .. {reader.v_max.max():g}")
+    elif args and args[0] == '--benchmark':
+        rate_hz = float(args[1]) if len(args) > 1 else BENCH_RATE_HZ
+        seconds = float(args[2]) * 3600 if len(args) > 2 else BENCH_SECONDS
+        result = run_benchmark(rate_hz, seconds)
+        print_benchmark(result)
+        pd.DataFrame([result]).to_csv('reslog_benchmark.csv', index=False, encoding='utf-8-sig')
+        print("Benchmark data saved as reslog_benchmark.csv")
+    else:
+        print("Usage: reslog.py --from-csv|--to-csv|--info|--benchmark ...")
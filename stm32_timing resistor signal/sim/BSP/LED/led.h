@@ -0,0 +1,45 @@
+/**
+ ****************************************************************************************************
+ * @file        led.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * PC Ŀ: ԭ BSP/LED 
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef _LED_H
+#define _LED_H
+#include "../../SYSTEM/sys/sys.h"
+
+/* LED0 PB5, LED1 PE5 */
+#define LED0(x)                                                                           \
+    do                                                                                    \
+    {                                                                                     \
+        HAL_GPIO_WritePin(GPIOB, GPIO_PIN_5, (x) ? GPIO_PIN_SET : GPIO_PIN_RESET);        \
+    } while (0)
+#define LED1(x)                                                                           \
+    do                                                                                    \
+    {                                                                                     \
+        HAL_GPIO_WritePin(GPIOE, GPIO_PIN_5, (x) ? GPIO_PIN_SET : GPIO_PIN_RESET);        \
+    } while (0)
+#define LED0_TOGGLE()                           \
+    do                                          \
+    {                                           \
+        HAL_GPIO_TogglePin(GPIOB, GPIO_PIN_5);  \
+    } while (0)
+#define LED1_TOGGLE()                           \
+    do                                          \
+    {                                           \
+        HAL_GPIO_TogglePin(GPIOE, GPIO_PIN_5);  \
+    } while (0)
+
+void led_init(void); /* ʼ */
+
+#endif
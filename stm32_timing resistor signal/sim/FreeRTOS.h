@@ -0,0 +1,67 @@
+/**
+ ****************************************************************************************************
+ * @file        FreeRTOS.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * PC Ŀ: FreeRTOS (myTASK.c ʹ), ʵ sim_rtos.c
+ * ֻṩ̼õĽӿ,  FreeRTOS һ:
+ * 1, ȼռ, ͬȼת(configUSE_TIME_SLICING Ϊ 0)
+ * 2,  ucontext ջ, ̼ṩջֻӿ, ʹ
+ * 3,  SysTick_Handler -> myTASK_tick(), жϻѵжϷ߳ģʽʱл(sim_set_preempt)
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+#include <stdint.h>
+#include "FreeRTOSConfig.h"
+
+/******************************************************************************************/
+/*  */
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+typedef void (*TaskFunction_t)(void *);
+
+typedef struct sim_rtos_task *TaskHandle_t;
+typedef struct sim_rtos_queue *QueueHandle_t;
+
+/* ̬Ŀƿ, ֻ汣ԼĶָ */
+typedef struct
+{
+    void *sim;
+} StaticTask_t;
+
+typedef struct
+{
+    void *sim;
+} StaticQueue_t;
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(((TickType_t)(ms) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+
+/******************************************************************************************/
+/* ˿ */
+
+void vPortEnterCritical(void);
+void vPortExitCritical(void);
+void vPortYieldFromISR(BaseType_t woken);
+
+#define portYIELD_FROM_ISR(x) vPortYieldFromISR(x)
+#define taskENTER_CRITICAL() vPortEnterCritical()
+#define taskEXIT_CRITICAL() vPortExitCritical()
+
+#endif
@@ -0,0 +1,25 @@
+/**
+ ****************************************************************************************************
+ * @file        delay.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * PC Ŀ: ԭ SYSTEM/delay , ʱƽʱ
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __DELAY_H
+#define __DELAY_H
+#include "../sys/sys.h"
+
+void delay_init(uint16_t sysclk); /* ʼӳٺ */
+void delay_ms(uint16_t nms);      /* ʱnms */
+void delay_us(uint32_t nus);      /* ʱnus */
+
+#endif
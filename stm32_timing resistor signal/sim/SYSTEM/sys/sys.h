@@ -0,0 +1,23 @@
+/**
+ ****************************************************************************************************
+ * @file        sys.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * PC Ŀ: ԭ SYSTEM/sys 
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef _SYS_H
+#define _SYS_H
+#include "../../sim_hal.h"
+
+void sys_stm32_clock_init(uint32_t plln); /* ʱú, й̶Ϊ72MHz */
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ ****************************************************************************************************
+ * @file        usart.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * PC Ŀ: ԭ SYSTEM/usart , printf 봮ֽ
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __USART_H
+#define __USART_H
+#include <stdio.h>
+#include "../sys/sys.h"
+
+#define USART_REC_LEN 200 /* ֽ 200 */
+#define USART_EN_RX 0     /* ʹܣ1/ֹ01,  myCMD  DMA ʽӹ */
+
+extern UART_HandleTypeDef g_uart1_handle;    /* UART */
+extern uint8_t g_usart_rx_buf[USART_REC_LEN]; /* ջ,USART_REC_LENֽ.ĩֽΪз */
+extern uint16_t g_usart_rx_sta;               /* ״̬ */
+
+void usart_init(uint32_t baudrate); /* ڳʼ */
+
+/*  printf  fputc ض USART1, ͬ봮ֽͷʱ */
+int sim_uart_printf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+#define printf sim_uart_printf
+
+#endif
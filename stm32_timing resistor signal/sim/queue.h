@@ -0,0 +1,25 @@
+/**
+ ****************************************************************************************************
+ * @file        queue.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * PC Ŀ: FreeRTOS queue.h ,  FreeRTOS.h
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef INC_QUEUE_H
+#define INC_QUEUE_H
+#include "FreeRTOS.h"
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t *storage, StaticQueue_t *qcb);
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks);
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks);
+
+#endif
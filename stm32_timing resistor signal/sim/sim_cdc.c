@@ -0,0 +1,352 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_cdc.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * myUSB շ PC (make check-usb ɲ usbsim)
+ *
+ * ÷: usbsim [-n bytes] [-s seed]
+ *   -n bytes   ÿÿֽ, Ĭ 1000000
+ *   -s seed    , Ĭ 1
+ *
+ * myUSB.c  myUSB_CORE_ONLY , ˵㻻ɻ, ÿһй̼:
+ *   IN   ̼֡д뷢ͻ(myUSB_tx_push), дµĲһ(ѹ, );
+ *        ˵ʱȡһδ(myUSB_tx_next),  NAK ɲȡ,
+ *        ڴʱŴӻ渴, ڼ̼д;  64 ֽڷְ,
+ *        յ̰㳤ȰŽһζȡ
+ *   OUT  ֻڶ˵˴ʱд(ÿβ myUSB_RX_ARM ֽ), յ NAK;
+ *        ̼ջ(myUSB_rx_push), ͣٶȡ(myUSB_rx_pop)ڳռٻָ
+ * : ֡֡(ÿδ䶼 64 , Ҫ㳤Ȱ)ʱ NAK ʹͻһֱ
+ * : յֽ뷢ֽͬ˳һ, ûж; 䲻Խĩβ, 滹ʱ,
+ *       㳤Ȱֻ֮; ʱûͣδɵĶȡ; дͷӲض
+ * ȫͨʱ 0, ӡʧܵļ
+ *
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "myUSB.h"
+
+#define SIM_CDC_STALL 100000 /* ôಽûнչΪ */
+
+static int g_checks, g_failed;
+
+#define CHECK(cond, ...)                                           \
+    do                                                             \
+    {                                                              \
+        g_checks++;                                                \
+        if (!(cond))                                               \
+        {                                                          \
+            g_failed++;                                            \
+            printf("FAIL %s:%d: %s: ", __FILE__, __LINE__, #cond); \
+            printf(__VA_ARGS__);                                   \
+            printf("\n");                                          \
+        }                                                          \
+    } while (0)
+
+/* ֡ */
+enum
+{
+    SIM_CDC_FRAME_RANDOM = 0, /* 1 ~ 300 ֽ */
+    SIM_CDC_FRAME_PACKET,     /* 64 ~ 1024 ֽ, 64  */
+};
+
+typedef struct
+{
+    const char *name;
+    int frame;     /* ֡, SIM_CDC_FRAME_xxx */
+    int idle_pct;  /* ̼ÿдĸ(%), ÷ͻл */
+    int nak_pct;   /*  NAK һδĸ(%) */
+    int nak_max;   /* ÿ NAK ಽ */
+    int pop_pct;   /* ̼ÿȡջĸ(%) */
+} SIM_CDC_CASE;
+
+static const SIM_CDC_CASE g_cases[] = {
+    {"random frames", SIM_CDC_FRAME_RANDOM, 50, 20, 8, 50},
+    {"packet frames, ZLP", SIM_CDC_FRAME_PACKET, 70, 20, 8, 50},
+    {"forced NAK, back-pressure", SIM_CDC_FRAME_RANDOM, 0, 90, 200, 5},
+    {"packet frames, forced NAK", SIM_CDC_FRAME_PACKET, 0, 90, 200, 5},
+};
+
+static uint64_t g_rng = 1;
+static uint8_t *g_src; /*  */
+static uint8_t *g_dst; /* յ */
+
+/**
+ * @brief       0 ~ n-1 (xorshift64)
+ * @param       n: 
+ * @retval      
+ */
+static uint32_t sim_cdc_rand(uint32_t n)
+{
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return (uint32_t)((g_rng >> 11) % n);
+}
+
+
+/**
+ * @brief       ׼һ
+ * @param       total: ֽ
+ * @retval      
+ */
+static void sim_cdc_fill(uint32_t total)
+{
+    uint32_t i;
+
+    for (i = 0; i < total; i++)
+    {
+        g_src[i] = (uint8_t)sim_cdc_rand(256);
+    }
+    memset(g_dst, 0, total);
+}
+
+/**
+ * @brief       Ƚյ
+ * @param       recv : յֽ
+ * @param       total: ֽ
+ * @retval      һͬλ, ȫͬʱ -1
+ */
+static long sim_cdc_diff(uint32_t recv, uint32_t total)
+{
+    uint32_t i;
+
+    for (i = 0; i < recv && i < total; i++)
+    {
+        if (g_src[i] != g_dst[i])
+        {
+            return (long)i;
+        }
+    }
+    return (recv == total) ? -1 : (long)i;
+}
+
+/**
+ * @brief       ̼,  IN ˵
+ * @param       c    : 
+ * @param       total: ֽ
+ * @retval      
+ */
+static void sim_cdc_in(const SIM_CDC_CASE *c, uint32_t total)
+{
+    static myUSB_CDC cdc;
+    const uint8_t *data = NULL;
+    uint16_t len = 0;
+    uint32_t sent = 0, frame_end = 0, recv = 0, pending = 0, stall = 0;
+    uint32_t transfers = 0, zlps = 0, reads = 0, naks = 0, short_push = 0;
+    int armed = 0, nak = 0;
+    long diff;
+
+    sim_cdc_fill(total);
+    memset(&cdc, 0, sizeof(cdc));
+    myUSB_cdc_reset(&cdc, 1);
+
+    while (stall < SIM_CDC_STALL)
+    {
+        uint32_t before = sent + recv + transfers;
+
+        /* ̼: ֡д, дµĲһ */
+        if (sent == frame_end && sent < total)
+        {
+            uint32_t n = (c->frame == SIM_CDC_FRAME_PACKET) ? (1 + sim_cdc_rand(16)) * myUSB_EP_SIZE : 1 + sim_cdc_rand(300);
+
+            frame_end = (total - sent > n) ? sent + n : total;
+        }
+        if (sent < frame_end && (int)sim_cdc_rand(100) >= c->idle_pct)
+        {
+            uint16_t want = (uint16_t)(frame_end - sent);
+            uint16_t space = myUSB_tx_space(&cdc);
+            uint16_t n = myUSB_tx_push(&cdc, &g_src[sent], want);
+
+            CHECK(n == (want < space ? want : space), "pushed %u of %u bytes with %u free", n, want, space);
+            short_push += n < want;
+            sent += n;
+        }
+
+        /* ̼: IN ˵ʱһδ */
+        if (!armed)
+        {
+            uint16_t used = cdc.tx_head - cdc.tx_tail;
+            uint16_t pos = cdc.tx_tail & (myUSB_TX_RING - 1);
+
+            if (myUSB_tx_next(&cdc, &data, &len))
+            {
+                CHECK(data == &cdc.tx_buf[pos], "transfer at %ld, tail at %u", (long)(data - cdc.tx_buf), pos);
+                CHECK(pos + len <= myUSB_TX_RING && len <= myUSB_TX_CHUNK, "%u bytes at %u", len, pos);
+                CHECK(len == used || len <= myUSB_EP_SIZE || len % myUSB_EP_SIZE == 0,
+                      "%u of %u queued bytes, not whole packets", len, used);
+                CHECK(len > 0 || (used == 0 && pending > 0), "ZLP with %u bytes queued, host read at %u bytes", used, pending);
+                armed = 1;
+                nak = ((int)sim_cdc_rand(100) < c->nak_pct) ? 1 + (int)sim_cdc_rand(c->nak_max) : 0;
+                transfers++;
+                zlps += len == 0;
+            }
+        }
+        else
+        {
+            const uint8_t *d = NULL;
+            uint16_t l = 0;
+
+            CHECK(!myUSB_tx_next(&cdc, &d, &l), "second transfer started while the endpoint is busy");
+        }
+
+        /* : NAK Ŵӻ渴, ̰㳤Ȱһζȡ */
+        if (armed && nak > 0)
+        {
+            nak--;
+            naks++;
+        }
+        else if (armed)
+        {
+            CHECK(recv + len <= sent, "host got %u bytes, %u sent", recv + len, sent);
+            if (recv + len <= sent)
+            {
+                memcpy(&g_dst[recv], data, len);
+                recv += len;
+            }
+            pending += len;
+            if (len % myUSB_EP_SIZE != 0 || len == 0)
+            {
+                pending = 0;
+                reads++;
+            }
+            myUSB_tx_done(&cdc);
+            armed = 0;
+        }
+
+        if (sent == total && !armed && !cdc.tx_zlp && cdc.tx_head == cdc.tx_tail)
+        {
+            break;
+        }
+        stall = (sent + recv + transfers != before) ? 0 : stall + 1;
+    }
+
+    diff = sim_cdc_diff(recv, total);
+    CHECK(stall < SIM_CDC_STALL, "IN stalled: %u sent, %u received", sent, recv);
+    CHECK(diff < 0, "%u of %u bytes received, first difference at %ld", recv, total, diff);
+    CHECK(pending == 0, "host read still waiting after %u bytes, no short packet or ZLP", pending);
+    CHECK(cdc.tx_drop == 0, "%lu bytes dropped", (unsigned long)cdc.tx_drop);
+    if (c->frame == SIM_CDC_FRAME_PACKET)
+    {
+        CHECK(zlps > 0, "whole-packet frames never needed a ZLP");
+    }
+    if (c->nak_pct >= 50)
+    {
+        CHECK(short_push > 0, "forced NAK never filled the ring");
+    }
+    printf("  IN : %u transfers, %u ZLP, %u host reads, %u NAK steps, %u partial pushes\n", transfers, zlps, reads, naks,
+           short_push);
+}
+
+/**
+ * @brief        OUT ˵㷢, ̼
+ * @param       c    : 
+ * @param       total: ֽ
+ * @retval      
+ */
+static void sim_cdc_out(const SIM_CDC_CASE *c, uint32_t total)
+{
+    static myUSB_CDC cdc;
+    uint32_t sent = 0, recv = 0, stall = 0;
+    uint32_t transfers = 0, naks = 0, parks = 0;
+    int armed = 1; /* úһ OUT  */
+    long diff;
+
+    sim_cdc_fill(total);
+    memset(&cdc, 0, sizeof(cdc));
+    myUSB_cdc_reset(&cdc, 1);
+
+    while (stall < SIM_CDC_STALL && recv < total)
+    {
+        uint32_t before = sent + recv;
+
+        /* : ˵˴д,  NAK */
+        if (sent < total && !armed)
+        {
+            naks++;
+        }
+        else if (sent < total)
+        {
+            uint16_t len = (uint16_t)(1 + sim_cdc_rand(myUSB_RX_ARM));
+            uint16_t head = cdc.rx_head;
+
+            if (len > total - sent)
+            {
+                len = (uint16_t)(total - sent);
+            }
+            armed = myUSB_rx_push(&cdc, &g_src[sent], len);
+            CHECK((uint16_t)(cdc.rx_head - head) == len, "stored %u of %u bytes", (uint16_t)(cdc.rx_head - head), len);
+            CHECK((uint16_t)(cdc.rx_head - cdc.rx_tail) <= myUSB_RX_RING, "%u bytes in the receive ring",
+                  (uint16_t)(cdc.rx_head - cdc.rx_tail));
+            CHECK(armed == !cdc.rx_parked, "endpoint %s, parked %u", armed ? "armed" : "idle", cdc.rx_parked);
+            sent += len;
+            transfers++;
+            parks += !armed;
+        }
+
+        /* ̼: ٶȡ, ռ㹻ָ */
+        if ((int)sim_cdc_rand(100) < c->pop_pct)
+        {
+            uint8_t was_parked = cdc.rx_parked;
+
+            recv += myUSB_rx_pop(&cdc, &g_dst[recv], (uint16_t)(1 + sim_cdc_rand(64)));
+            if (myUSB_rx_unpark(&cdc))
+            {
+                CHECK(was_parked && !armed, "unpark without a parked endpoint");
+                armed = 1;
+            }
+        }
+        stall = (sent + recv != before) ? 0 : stall + 1;
+    }
+
+    diff = sim_cdc_diff(recv, total);
+    CHECK(stall < SIM_CDC_STALL, "OUT stalled: %u sent, %u received", sent, recv);
+    CHECK(diff < 0, "%u of %u bytes received, first difference at %ld", recv, total, diff);
+    printf("  OUT: %u transfers, %u parked, %u NAK steps\n", transfers, parks, naks);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t total = 1000000;
+    size_t k;
+    int i;
+
+    for (i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "-n") == 0)
+        {
+            total = (uint32_t)atol(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "-s") == 0)
+        {
+            g_rng = (uint64_t)atoll(argv[i + 1]) * 2654435761u + 1;
+        }
+    }
+    g_src = malloc(total + 1);
+    g_dst = malloc(total + 1);
+    if (g_src == NULL || g_dst == NULL)
+    {
+        printf("out of memory\n");
+        return 1;
+    }
+
+    for (k = 0; k < sizeof(g_cases) / sizeof(g_cases[0]); k++)
+    {
+        printf("%s:\n", g_cases[k].name);
+        sim_cdc_in(&g_cases[k], total);
+        sim_cdc_out(&g_cases[k], total);
+    }
+    printf("myUSB: %d checks, %d failed\n", g_checks, g_failed);
+    free(g_src);
+    free(g_dst);
+    return g_failed != 0;
+}
@@ -0,0 +1,117 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_cfg.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * myCFG.h Ƶ PC (make check-config ÿԤɲ cfgsim-cfg<N>)
+ *
+ *  -DmyCFG_SENSOR=N , ѺƵĳֵȽ:
+ *   ʱ        SYSCLK / PCLK1 / PCLK2 / ʱʱ
+ *   PWM         ϵƵʺƵʵԤƵװֵ, ʵƵ
+ *   ADC         ƵϵADC ʱӡʡת CPU (ʻӡ֤)
+ *   ʱ      myTIME 1s ͰʱԤƵ
+ *           USART1  BRR
+ *           DMA 泤ȡɼһݵʱ
+ * ȫͨʱ 0, ӡʧܵļ
+ *
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include "stm32f1xx_hal.h"
+#include "myCFG.h"
+
+static int g_checks, g_failed;
+
+#define CHECK_EQ(expr, expect)                                                                  \
+    do                                                                                          \
+    {                                                                                           \
+        long long v_ = (long long)(expr), e_ = (long long)(expect);                             \
+        g_checks++;                                                                             \
+        if (v_ != e_)                                                                           \
+        {                                                                                       \
+            g_failed++;                                                                         \
+            printf("FAIL %s:%d: %s = %lld, expected %lld\n", __FILE__, __LINE__, #expr, v_, e_); \
+        }                                                                                       \
+    } while (0)
+
+/* ÿԤֵ */
+typedef struct
+{
+    uint32_t pwm_freq, pwm_psc, pwm_arr; /* 72MHz / (psc + 1) / (arr + 1) = pwm_freq */
+    uint8_t adc_smp;
+    uint32_t adc_rate;    /* 12MHz  2 / ( + 25) */
+    uint32_t conv_cycles; /* ( + 25)  6 / 2 */
+    uint32_t adc_avg, dma_size;
+    uint32_t block_us; /* ceil(adc_avg  10^6 / adc_rate) */
+    uint32_t report_ms;
+} SIM_CFG_PRESET;
+
+static const SIM_CFG_PRESET g_presets[] = {
+    /* 0, : 239.5 ,  479 */
+    {10000, 0, 7199, 7, 47619, 1512, 100, 100, 2101, 1000},
+    /* 1, : 13.5 ,  27 */
+    {100000, 0, 719, 2, 461538, 156, 256, 256, 555, 100},
+};
+
+static void sim_cfg_clocks(void)
+{
+    CHECK_EQ(myCFG_SYSCLK, 72000000);
+    CHECK_EQ(myCFG_PCLK1, 36000000);
+    CHECK_EQ(myCFG_PCLK2, 72000000);
+    CHECK_EQ(myCFG_TIM_CLK, 72000000);
+    CHECK_EQ(myCFG_TIM1_CLK, 72000000);
+}
+
+static void sim_cfg_preset(const SIM_CFG_PRESET *p)
+{
+    /* PWM */
+    CHECK_EQ(myCFG_PWM_FREQ, p->pwm_freq);
+    CHECK_EQ(myCFG_PWM_PSC, p->pwm_psc);
+    CHECK_EQ(myCFG_PWM_ARR, p->pwm_arr);
+    CHECK_EQ(myCFG_PWM_REAL_OF(myCFG_PWM_FREQ), p->pwm_freq);
+    CHECK_EQ(myCFG_PWM_PSC_OF(myCFG_KEY1_PWM_FREQ), 0); /* 10kHz */
+    CHECK_EQ(myCFG_PWM_ARR_OF(myCFG_KEY1_PWM_FREQ), 7199);
+    CHECK_EQ(myCFG_PWM_PSC_OF(myCFG_WKUP_PWM_FREQ), 0); /* 5kHz */
+    CHECK_EQ(myCFG_PWM_ARR_OF(myCFG_WKUP_PWM_FREQ), 14399);
+    CHECK_EQ(myCFG_PWM_PSC_OF(1000), 1); /* 72000  16 λ, 2 Ƶ */
+    CHECK_EQ(myCFG_PWM_ARR_OF(1000), 35999);
+
+    /* ADC: 72MHz / 6 = 12MHz ǲ 14MHz СƵ */
+    CHECK_EQ(myCFG_ADC_DIV, 6);
+    CHECK_EQ(myCFG_ADC_CLK, 12000000);
+    CHECK_EQ(myCFG_ADC_PRESC, RCC_ADCPCLK2_DIV6);
+    CHECK_EQ(myCFG_ADC_SMP, p->adc_smp);
+    CHECK_EQ(myCFG_ADC_RATE, p->adc_rate);
+    CHECK_EQ(myCFG_ADC_CONV_CYCLES, p->conv_cycles);
+    CHECK_EQ(myCFG_SYSCLK / myCFG_ADC_CONV_CYCLES, myCFG_ADC_RATE); /* תʱһ */
+
+    /* ʱ */
+    CHECK_EQ(myCFG_TIME_PSC, 71);
+    CHECK_EQ(myCFG_TIME_ARR, 999);
+    CHECK_EQ(myCFG_DEBOUNCE_PSC, 7199);
+
+    /* : 72MHz / 115200 = 625 */
+    CHECK_EQ(myCFG_UART_BAUD, 115200);
+    CHECK_EQ(myCFG_UART_BRR, 625);
+
+    /*  */
+    CHECK_EQ(myCFG_ADC_AVG, p->adc_avg);
+    CHECK_EQ(myCFG_ADC_DMA_SIZE, p->dma_size);
+    CHECK_EQ(myCFG_BLOCK_US, p->block_us);
+    CHECK_EQ(myCFG_REPORT_MS, p->report_ms);
+}
+
+int main(void)
+{
+    sim_cfg_clocks();
+    sim_cfg_preset(&g_presets[myCFG_SENSOR]);
+    printf("myCFG preset %d: %d checks, %d failed\n", myCFG_SENSOR, g_checks, g_failed);
+    return g_failed != 0;
+}
@@ -0,0 +1,240 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_cmd.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * myCMD ƴӺ PC (make check-cmd ɲ cmdsim)
+ *
+ * myCMD.c  myCMD_PARSER_ONLY ,  HAL. :
+ *           ÿÿֲʽСдոƱ͸ʽ
+ *               32 λʡδ֪
+ *   ƴ      '\r' / '\n' / "\r\n" ССǡ myCMD_LINE_MAX Сжָ
+ *   Ӧı    ( ERR RANGE)ԽĴ
+ * ֵΧӲй, ִʱ; check-cmd  fwsim Խ,  ERR RANGE Ӧ
+ * ȫͨʱ 0, ӡʧܵļ
+ *
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "myCMD.h"
+
+static int g_checks, g_failed;
+
+#define CHECK(cond)                                                    \
+    do                                                                 \
+    {                                                                  \
+        g_checks++;                                                    \
+        if (!(cond))                                                   \
+        {                                                              \
+            g_failed++;                                                \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);     \
+        }                                                              \
+    } while (0)
+
+/* : ı, Ĵ, ɹʱͲ */
+typedef struct
+{
+    const char *text;
+    myCMD_ERR err;
+    myCMD_ID id;
+    uint8_t argc;
+    uint32_t arg[3];
+} SIM_CMD_CASE;
+
+static const SIM_CMD_CASE g_cases[] = {
+    /* PWM */
+    {"PWM 5000", myCMD_OK, myCMD_ID_PWM, 1, {5000}},
+    {"PWM 5000 250", myCMD_OK, myCMD_ID_PWM, 2, {5000, 250}},
+    {"pwm 2 0", myCMD_OK, myCMD_ID_PWM, 2, {2, 0}},
+    {"PWM OFF", myCMD_OK, myCMD_ID_PWM_OFF, 0, {0}},
+    {"Pwm oFF", myCMD_OK, myCMD_ID_PWM_OFF, 0, {0}},
+    {"PWM OFF 5", myCMD_ERR_ARG, myCMD_ID_PWM_OFF, 0, {0}},
+    {"PWM 5000 OFF", myCMD_ERR_ARG, myCMD_ID_PWM, 0, {0}},
+    {"PWM", myCMD_ERR_ARG, myCMD_ID_PWM, 0, {0}},
+    {"PWM 1 2 3", myCMD_ERR_ARG, myCMD_ID_PWM, 0, {0}},
+    {"PWM abc", myCMD_ERR_ARG, myCMD_ID_PWM, 0, {0}},
+    {"PWM -5", myCMD_ERR_ARG, myCMD_ID_PWM, 0, {0}},
+    {"PWM 5k", myCMD_ERR_ARG, myCMD_ID_PWM, 0, {0}},
+    {"PWM 4294967295", myCMD_OK, myCMD_ID_PWM, 1, {4294967295UL}},
+    {"PWM 4294967296", myCMD_ERR_ARG, myCMD_ID_PWM, 0, {0}},
+    {"PWM 99999999999", myCMD_ERR_ARG, myCMD_ID_PWM, 0, {0}},
+    {"PWM 00000000001", myCMD_OK, myCMD_ID_PWM, 1, {1}},
+    {"PWM 000000000001", myCMD_ERR_ARG, myCMD_ID_PWM, 0, {0}}, /* ʳ */
+    /* RATE / AVG / PERIOD */
+    {"RATE 20000", myCMD_OK, myCMD_ID_RATE, 1, {20000}},
+    {"rate 0", myCMD_OK, myCMD_ID_RATE, 1, {0}}, /* Χִʱ */
+    {"RATE", myCMD_ERR_ARG, myCMD_ID_RATE, 0, {0}},
+    {"RATE 1 2", myCMD_ERR_ARG, myCMD_ID_RATE, 0, {0}},
+    {"AVG 64", myCMD_OK, myCMD_ID_AVG, 1, {64}},
+    {"avg", myCMD_ERR_ARG, myCMD_ID_AVG, 0, {0}},
+    {"AVG 1.5", myCMD_ERR_ARG, myCMD_ID_AVG, 0, {0}},
+    {"PERIOD 0", myCMD_OK, myCMD_ID_PERIOD, 1, {0}},
+    {"Period 60000", myCMD_OK, myCMD_ID_PERIOD, 1, {60000}},
+    {"PERIOD 1 2", myCMD_ERR_ARG, myCMD_ID_PERIOD, 0, {0}},
+    /* MODE */
+    {"MODE TEXT", myCMD_OK, myCMD_ID_MODE, 1, {myCMD_STREAM_TEXT}},
+    {"mode frame", myCMD_OK, myCMD_ID_MODE, 1, {myCMD_STREAM_FRAME}},
+    {"MODE Off", myCMD_OK, myCMD_ID_MODE, 1, {myCMD_STREAM_OFF}},
+    {"MODE RAW", myCMD_OK, myCMD_ID_MODE, 1, {myCMD_STREAM_RAW}},
+    {"MODE", myCMD_ERR_ARG, myCMD_ID_MODE, 0, {0}},
+    {"MODE BIN", myCMD_ERR_ARG, myCMD_ID_MODE, 0, {0}},
+    {"MODE 1", myCMD_ERR_ARG, myCMD_ID_MODE, 0, {0}},
+    {"MODE TEXT FRAME", myCMD_ERR_ARG, myCMD_ID_MODE, 0, {0}},
+    /* STATUS */
+    {"STATUS", myCMD_OK, myCMD_ID_STATUS, 0, {0}},
+    {"status", myCMD_OK, myCMD_ID_STATUS, 0, {0}},
+    {"STATUS 1", myCMD_ERR_ARG, myCMD_ID_STATUS, 0, {0}},
+    /* SWEEP */
+    {"SWEEP", myCMD_OK, myCMD_ID_SWEEP, 0, {0}},
+    {"SWEEP 1000 100000", myCMD_OK, myCMD_ID_SWEEP, 2, {1000, 100000}},
+    {"sweep 1000 100000 16", myCMD_OK, myCMD_ID_SWEEP, 3, {1000, 100000, 16}},
+    {"SWEEP 1000", myCMD_ERR_ARG, myCMD_ID_SWEEP, 0, {0}}, /* ֹƵɶԸ */
+    {"SWEEP 1 2 3 4", myCMD_ERR_ARG, myCMD_ID_SWEEP, 0, {0}},
+    /* TUNE */
+    {"TUNE", myCMD_OK, myCMD_ID_TUNE, 0, {0}},
+    {"TUNE AUTO", myCMD_OK, myCMD_ID_TUNE, 1, {myCMD_TUNE_AUTO}},
+    {"tune off", myCMD_OK, myCMD_ID_TUNE, 1, {myCMD_TUNE_OFF}},
+    {"TUNE ON", myCMD_ERR_ARG, myCMD_ID_TUNE, 0, {0}},
+    {"TUNE AUTO OFF", myCMD_ERR_ARG, myCMD_ID_TUNE, 0, {0}},
+    /* VALID */
+    {"VALID", myCMD_OK, myCMD_ID_VALID, 0, {0}},
+    {"VALID TAG", myCMD_OK, myCMD_ID_VALID, 1, {myCMD_VALID_TAG}},
+    {"valid drop", myCMD_OK, myCMD_ID_VALID, 1, {myCMD_VALID_DROP}},
+    {"Valid Off", myCMD_OK, myCMD_ID_VALID, 1, {myCMD_VALID_OFF}},
+    {"VALID 1", myCMD_ERR_ARG, myCMD_ID_VALID, 0, {0}},
+    {"VALID TAG DROP", myCMD_ERR_ARG, myCMD_ID_VALID, 0, {0}},
+    /* հ */
+    {"  PWM\t5000   250\t", myCMD_OK, myCMD_ID_PWM, 2, {5000, 250}},
+    {"\tSTATUS ", myCMD_OK, myCMD_ID_STATUS, 0, {0}},
+    /* δ֪ */
+    {"", myCMD_ERR_UNKNOWN, myCMD_ID_NONE, 0, {0}},
+    {"   ", myCMD_ERR_UNKNOWN, myCMD_ID_NONE, 0, {0}},
+    {"FOO 1", myCMD_ERR_UNKNOWN, myCMD_ID_NONE, 0, {0}},
+    {"PWMX 1", myCMD_ERR_UNKNOWN, myCMD_ID_NONE, 0, {0}},
+    {"STATUSSTATUS", myCMD_ERR_UNKNOWN, myCMD_ID_NONE, 0, {0}}, /* ʳ */
+};
+
+static void sim_cmd_parse(void)
+{
+    uint32_t i;
+    uint8_t k;
+
+    for (i = 0; i < sizeof(g_cases) / sizeof(g_cases[0]); i++)
+    {
+        const SIM_CMD_CASE *c = &g_cases[i];
+        myCMD_REQ req;
+        myCMD_ERR err;
+        int ok;
+
+        memset(&req, 0x5A, sizeof(req));
+        err = myCMD_parse(c->text, &req);
+        ok = err == c->err;
+        if (ok && err == myCMD_OK)
+        {
+            ok = req.id == c->id && req.argc == c->argc;
+            for (k = 0; k < 3; k++)
+            {
+                ok = ok && req.arg[k] == (k < c->argc ? c->arg[k] : 0); /* δĲ */
+            }
+        }
+        g_checks++;
+        if (!ok)
+        {
+            g_failed++;
+            printf("FAIL parse \"%s\": %s id %d argc %u, expected %s id %d argc %u\n", c->text, myCMD_err_str(err),
+                   (int)req.id, req.argc, myCMD_err_str(c->err), (int)c->id, c->argc);
+        }
+    }
+}
+
+/* ֽ text, ÿֵд ret( n , ֻ¼ PENDING ), ؼ¼ĸ */
+static int sim_cmd_feed(myCMD_LINE *line, const char *text, uint8_t *ret, char lines[][myCMD_LINE_MAX + 1], int n)
+{
+    int got = 0;
+
+    while (*text)
+    {
+        uint8_t r = myCMD_line_push(line, (uint8_t)*text++);
+
+        if (r != myCMD_LINE_PENDING && got < n)
+        {
+            ret[got] = r;
+            strcpy(lines[got], r == myCMD_LINE_READY ? line->buf : "");
+            got++;
+        }
+    }
+    return got;
+}
+
+static void sim_cmd_lines(void)
+{
+    myCMD_LINE line;
+    uint8_t ret[8];
+    char lines[8][myCMD_LINE_MAX + 1];
+    char text[3 * myCMD_LINE_MAX];
+    int n;
+
+    memset(&line, 0, sizeof(line));
+
+    /* CRLFCRLF һ, Ŀк */
+    n = sim_cmd_feed(&line, "STATUS\r\nPWM 5000\nTUNE\r\r\n\nAVG 4\r", ret, lines, 8);
+    CHECK(n == 4);
+    CHECK(ret[0] == myCMD_LINE_READY && strcmp(lines[0], "STATUS") == 0);
+    CHECK(ret[1] == myCMD_LINE_READY && strcmp(lines[1], "PWM 5000") == 0);
+    CHECK(ret[2] == myCMD_LINE_READY && strcmp(lines[2], "TUNE") == 0);
+    CHECK(ret[3] == myCMD_LINE_READY && strcmp(lines[3], "AVG 4") == 0);
+
+    /* һзּε */
+    n = sim_cmd_feed(&line, "MODE FR", ret, lines, 8);
+    CHECK(n == 0);
+    n = sim_cmd_feed(&line, "AME\n", ret, lines, 8);
+    CHECK(n == 1 && strcmp(lines[0], "MODE FRAME") == 0);
+
+    /* ǡ myCMD_LINE_MAX ַȻ */
+    memset(text, 'A', myCMD_LINE_MAX);
+    strcpy(text + myCMD_LINE_MAX, "\n");
+    n = sim_cmd_feed(&line, text, ret, lines, 8);
+    CHECK(n == 1 && ret[0] == myCMD_LINE_READY && strlen(lines[0]) == myCMD_LINE_MAX);
+
+    /* ж, ֻһ, һ */
+    memset(text, 'B', 2 * myCMD_LINE_MAX);
+    strcpy(text + 2 * myCMD_LINE_MAX, "\r\nSTATUS\n");
+    n = sim_cmd_feed(&line, text, ret, lines, 8);
+    CHECK(n == 2);
+    CHECK(ret[0] == myCMD_LINE_TOO_LONG);
+    CHECK(ret[1] == myCMD_LINE_READY && strcmp(lines[1], "STATUS") == 0);
+
+    memset(text, 'C', myCMD_LINE_MAX + 1);
+    strcpy(text + myCMD_LINE_MAX + 1, "\n");
+    n = sim_cmd_feed(&line, text, ret, lines, 8);
+    CHECK(n == 1 && ret[0] == myCMD_LINE_TOO_LONG);
+    CHECK(line.len == 0 && line.overflow == 0);
+}
+
+static void sim_cmd_replies(void)
+{
+    CHECK(strcmp(myCMD_err_str(myCMD_OK), "OK") == 0);
+    CHECK(strcmp(myCMD_err_str(myCMD_ERR_UNKNOWN), "ERR UNKNOWN") == 0);
+    CHECK(strcmp(myCMD_err_str(myCMD_ERR_ARG), "ERR ARG") == 0);
+    CHECK(strcmp(myCMD_err_str(myCMD_ERR_RANGE), "ERR RANGE") == 0);
+    CHECK(strcmp(myCMD_err_str(myCMD_ERR_LONG), "ERR LONG") == 0);
+    CHECK(strcmp(myCMD_err_str(myCMD_ERR_BUSY), "ERR BUSY") == 0);
+    CHECK(strcmp(myCMD_err_str((myCMD_ERR)(myCMD_ERR_BUSY + 1)), "ERR") == 0);
+}
+
+int main(void)
+{
+    sim_cmd_parse();
+    sim_cmd_lines();
+    sim_cmd_replies();
+    printf("myCMD: %d checks, %d failed\n", g_checks, g_failed);
+    return g_failed != 0;
+}
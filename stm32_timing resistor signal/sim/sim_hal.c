@@ -0,0 +1,1426 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_hal.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * PC Ŀ: HAL/Ĵʱµ ADCDMAʱڡNVIC ģ
+ *
+ ****************************************************************************************************
+ */
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim_hal.h"
+#include "./SYSTEM/delay/delay.h"
+#include "./SYSTEM/usart/usart.h"
+#include "./BSP/LED/led.h"
+
+#undef printf
+
+/******************************************************************************************/
+/* Ĵ */
+
+GPIO_TypeDef sim_gpio[7];
+EXTI_TypeDef sim_exti;
+ADC_TypeDef sim_adc[2];
+DMA_TypeDef sim_dma[2];
+DMA_Channel_TypeDef sim_dma_ch[12];
+TIM_TypeDef sim_tim[8];
+USART_TypeDef sim_usart[4];
+USB_TypeDef sim_usb;
+CoreDebug_Type sim_coredebug;
+static DWT_Type g_sim_dwt;
+
+UART_HandleTypeDef g_uart1_handle;
+uint8_t g_usart_rx_buf[USART_REC_LEN];
+uint16_t g_usart_rx_sta = 0;
+
+sim_config_t g_sim_config;
+sim_stats_t g_sim_stats;
+
+/* ̼пܶжϷ, δʱΪ NULL */
+void SysTick_Handler(void) __attribute__((weak));
+void EXTI0_IRQHandler(void) __attribute__((weak));
+void EXTI1_IRQHandler(void) __attribute__((weak));
+void EXTI2_IRQHandler(void) __attribute__((weak));
+void EXTI3_IRQHandler(void) __attribute__((weak));
+void EXTI4_IRQHandler(void) __attribute__((weak));
+void EXTI9_5_IRQHandler(void) __attribute__((weak));
+void EXTI15_10_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel1_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel2_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel3_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel4_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel5_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel6_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel7_IRQHandler(void) __attribute__((weak));
+void USB_LP_CAN1_RX0_IRQHandler(void) __attribute__((weak));
+void TIM1_UP_IRQHandler(void) __attribute__((weak));
+void TIM2_IRQHandler(void) __attribute__((weak));
+void TIM3_IRQHandler(void) __attribute__((weak));
+void TIM4_IRQHandler(void) __attribute__((weak));
+void TIM5_IRQHandler(void) __attribute__((weak));
+void USART1_IRQHandler(void) __attribute__((weak));
+
+/******************************************************************************************/
+/* ״̬ */
+
+#define SIM_CPU_HZ 72000000ULL
+#define SIM_THREAD_PRIO 256 /* ߳ģʽ"ȼ", κж϶ */
+#define SIM_KEY_EVENTS 32
+#define SIM_RX_BYTES 1024 /* 봮ڽյֽ */
+
+static volatile uint32_t g_sim_tick = 0; /* HAL  */
+static uint32_t g_sim_adc_div = 6; /* ADC ʱӷƵ */
+
+static uint8_t g_sim_adc_running = 0;   /* ADC ()ת */
+static uint64_t g_sim_adc_start_ns = 0; /* תʱ */
+static uint64_t g_sim_adc_k = 0;        /* ɵת */
+static double g_sim_adc_period = 0;     /* ʱת, ns */
+
+static uint32_t g_sim_dma_len[12];    /* ǰ */
+static uint32_t g_sim_dma_remain[12]; /* ϴµ CNDTR, ڷֹ̼װ */
+
+static uint8_t g_sim_irq_enabled[SIM_IRQ_NUM];
+static uint8_t g_sim_irq_prio[SIM_IRQ_NUM];
+static uint8_t g_sim_irq_pending[SIM_IRQ_NUM];
+static int g_sim_active_prio = SIM_THREAD_PRIO;
+static uint8_t g_sim_primask = 0;
+static volatile uint8_t g_sim_woken = 0; /* жִй, sim_idle ģʽݴǰ */
+
+static uint64_t g_sim_next_tick_ns = 1000000;
+static int g_sim_advancing = 0;
+static uint8_t g_sim_stopped = 0;
+static struct timespec g_sim_host_last;
+
+typedef struct
+{
+    uint64_t t_ns;
+    GPIO_TypeDef *port;
+    uint16_t pin;
+    uint8_t level;
+    uint32_t hold_ms;
+} sim_key_event_t;
+
+static sim_key_event_t g_sim_keys[SIM_KEY_EVENTS];
+static int g_sim_key_num = 0;
+
+static uint8_t g_sim_tim_running[8];  /* ʱ¼ */
+static uint64_t g_sim_tim_next_ns[8]; /* һθ¼ʱ */
+static double g_sim_tim_period_ns[8]; /* ʱ */
+
+static uint64_t g_sim_rx_t[SIM_RX_BYTES]; /* ڽֽڵĵʱ,  */
+static uint8_t g_sim_rx_data[SIM_RX_BYTES];
+static uint8_t g_sim_rx_cont[SIM_RX_BYTES]; /* һֽ, ʱ̰ʱĲ¼ */
+static int g_sim_rx_num = 0;
+static uint64_t g_sim_rx_idle_ns = 0; /*  IDLE ʱ, 0 ʾ */
+static uint64_t g_sim_tx_done_ns = 0; /* DMA ͵ĵǰֽڷʱ, 0 ʾ DMA  */
+
+static sim_sample_fn g_sim_source = NULL;
+static sim_uart_fn g_sim_uart_sink = NULL;
+static void (*g_sim_finish)(void) = NULL;
+static void (*g_sim_preempt)(void) = NULL;
+
+void sim_set_sample_source(sim_sample_fn fn) { g_sim_source = fn; }
+void sim_set_uart_sink(sim_uart_fn fn) { g_sim_uart_sink = fn; }
+void sim_set_finish(void (*fn)(void)) { g_sim_finish = fn; }
+void sim_stop(void) { g_sim_stopped = 1; }
+void sim_set_preempt(void (*fn)(void)) { g_sim_preempt = fn; }
+uint8_t sim_in_isr(void) { return g_sim_active_prio != SIM_THREAD_PRIO; }
+
+/******************************************************************************************/
+/* NVIC */
+
+typedef void (*sim_isr_fn)(void);
+
+static sim_isr_fn sim_isr_handler(int irq)
+{
+    switch (irq)
+    {
+    case EXTI0_IRQn: return EXTI0_IRQHandler;
+    case EXTI1_IRQn: return EXTI1_IRQHandler;
+    case EXTI2_IRQn: return EXTI2_IRQHandler;
+    case EXTI3_IRQn: return EXTI3_IRQHandler;
+    case EXTI4_IRQn: return EXTI4_IRQHandler;
+    case EXTI9_5_IRQn: return EXTI9_5_IRQHandler;
+    case EXTI15_10_IRQn: return EXTI15_10_IRQHandler;
+    case DMA1_Channel1_IRQn: return DMA1_Channel1_IRQHandler;
+    case DMA1_Channel2_IRQn: return DMA1_Channel2_IRQHandler;
+    case DMA1_Channel3_IRQn: return DMA1_Channel3_IRQHandler;
+    case DMA1_Channel4_IRQn: return DMA1_Channel4_IRQHandler;
+    case DMA1_Channel5_IRQn: return DMA1_Channel5_IRQHandler;
+    case DMA1_Channel6_IRQn: return DMA1_Channel6_IRQHandler;
+    case DMA1_Channel7_IRQn: return DMA1_Channel7_IRQHandler;
+    case USB_LP_CAN1_RX0_IRQn: return USB_LP_CAN1_RX0_IRQHandler;
+    case TIM1_UP_IRQn: return TIM1_UP_IRQHandler;
+    case TIM2_IRQn: return TIM2_IRQHandler;
+    case TIM3_IRQn: return TIM3_IRQHandler;
+    case TIM4_IRQn: return TIM4_IRQHandler;
+    case TIM5_IRQn: return TIM5_IRQHandler;
+    case USART1_IRQn: return USART1_IRQHandler;
+    default: return NULL;
+    }
+}
+
+/* DMA ־Ĵд1, жϷغͳһЧ */
+static void sim_dma_apply_ifcr(void)
+{
+    int i;
+
+    for (i = 0; i < 2; i++)
+    {
+        sim_dma[i].ISR &= ~sim_dma[i].IFCR;
+        sim_dma[i].IFCR = 0;
+    }
+}
+
+/* ִпռǰȼĹж(ֻȽռȼ) */
+static void sim_irq_dispatch(void)
+{
+    sim_dma_apply_ifcr(); /* ߳ı־жϷ֮ǰЧ */
+    while (!g_sim_primask)
+    {
+        int irq, best = -1;
+
+        for (irq = 0; irq < SIM_IRQ_NUM; irq++)
+        {
+            if (g_sim_irq_pending[irq] && g_sim_irq_enabled[irq] && g_sim_irq_prio[irq] < g_sim_active_prio &&
+                (best < 0 || g_sim_irq_prio[irq] < g_sim_irq_prio[best]))
+            {
+                best = irq;
+            }
+        }
+        if (best < 0)
+        {
+            return;
+        }
+
+        g_sim_irq_pending[best] = 0;
+        if (sim_isr_handler(best))
+        {
+            int saved = g_sim_active_prio;
+
+            g_sim_active_prio = g_sim_irq_prio[best];
+            g_sim_stats.irq_count++;
+            g_sim_woken = 1;
+            sim_isr_handler(best)();
+            g_sim_active_prio = saved;
+        }
+        sim_dma_apply_ifcr();
+    }
+}
+
+static void sim_irq_raise(int irq)
+{
+    g_sim_irq_pending[irq] = 1;
+    sim_irq_dispatch();
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+    (void)SubPriority;
+    if (IRQn >= 0)
+    {
+        g_sim_irq_prio[IRQn] = (uint8_t)PreemptPriority;
+    }
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    if (IRQn >= 0)
+    {
+        g_sim_irq_enabled[IRQn] = 1;
+        sim_irq_dispatch();
+    }
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    if (IRQn >= 0)
+    {
+        g_sim_irq_enabled[IRQn] = 0;
+    }
+}
+
+void HAL_NVIC_SetPendingIRQ(IRQn_Type IRQn)
+{
+    if (IRQn >= 0)
+    {
+        sim_irq_raise(IRQn);
+    }
+}
+
+void __disable_irq(void)
+{
+    g_sim_primask = 1;
+}
+
+void __enable_irq(void)
+{
+    g_sim_primask = 0;
+    sim_irq_dispatch();
+}
+
+/******************************************************************************************/
+/* ADC / DMA ģ */
+
+static const double g_sim_smp_cycles[8] = {1.5, 7.5, 13.5, 28.5, 41.5, 55.5, 71.5, 239.5};
+
+/* ǰµתʱ, ns */
+static double sim_adc_period_ns(void)
+{
+    uint32_t ch = ADC1->SQR3 & 0x1F;
+    uint32_t smp = ch < 10 ? (ADC1->SMPR2 >> (3 * ch)) & 7 : (ADC1->SMPR1 >> (3 * (ch - 10))) & 7;
+
+    if (g_sim_config.sample_rate > 0)
+    {
+        return 1e9 / g_sim_config.sample_rate;
+    }
+    return (g_sim_smp_cycles[smp] + 12.5) * g_sim_adc_div * 1e9 / SIM_CPU_HZ;
+}
+
+/* ǰµĲʱ, ns;  -r ǲʵӰ, ԴģźԴ */
+double sim_adc_sample_ns(void)
+{
+    uint32_t ch = ADC1->SQR3 & 0x1F;
+    uint32_t smp = ch < 10 ? (ADC1->SMPR2 >> (3 * ch)) & 7 : (ADC1->SMPR1 >> (3 * (ch - 10))) & 7;
+
+    return g_sim_smp_cycles[smp] * g_sim_adc_div * 1e9 / SIM_CPU_HZ;
+}
+
+/* ̼д SWSTART ʼת, ADON ֹͣ */
+static void sim_adc_poll(void)
+{
+    if (!(ADC1->CR2 & (1 << 0)))
+    {
+        g_sim_adc_running = 0;
+        ADC1->CR2 &= ~(1UL << 22);
+        return;
+    }
+    if (ADC1->CR2 & (1UL << 22))
+    {
+        ADC1->CR2 &= ~(1UL << 22); /* Ӳתʼ SWSTART */
+        g_sim_adc_running = 1;
+        g_sim_adc_start_ns = g_sim_stats.now_ns;
+        g_sim_adc_k = 0;
+        g_sim_adc_period = sim_adc_period_ns();
+    }
+}
+
+static uint64_t sim_adc_next_ns(void)
+{
+    return g_sim_adc_start_ns + (uint64_t)((g_sim_adc_k + 1) * g_sim_adc_period);
+}
+
+/* ⲿ: ADONEXTTRIG λ EXTSEL ѡи¼ʱʼһת, תʱ */
+static void sim_adc_ext_trigger(uint32_t extsel)
+{
+    if (!(ADC1->CR2 & (1 << 0)) || !(ADC1->CR2 & (1UL << 20)) || ((ADC1->CR2 >> 17) & 7) != extsel ||
+        g_sim_adc_running)
+    {
+        return;
+    }
+    g_sim_adc_running = 1;
+    g_sim_adc_start_ns = g_sim_stats.now_ns;
+    g_sim_adc_k = 0;
+    g_sim_adc_period = sim_adc_period_ns();
+}
+
+/* 赽洢 DMA дһͨ(洢)δķΧ: ݻûͱ */
+static void sim_dma_check_conflict(int ch, uintptr_t addr, uint32_t size)
+{
+    int k;
+
+    for (k = 0; k < 12; k++)
+    {
+        DMA_Channel_TypeDef *o = &sim_dma_ch[k];
+        uint32_t msize, len, pos;
+        uintptr_t lo, hi;
+
+        if (k == ch || !(o->CCR & DMA_CCR_EN) || !(o->CCR & DMA_CCR_DIR) || o->CNDTR == 0)
+        {
+            continue;
+        }
+        msize = 1U << ((o->CCR >> 10) & 3);
+        len = o->CNDTR != g_sim_dma_remain[k] ? o->CNDTR : g_sim_dma_len[k]; /* װػû */
+        pos = (o->CCR & DMA_MINC_ENABLE) ? len - o->CNDTR : 0;
+        lo = (uintptr_t)o->CMAR + (uintptr_t)pos * msize;
+        hi = (o->CCR & DMA_MINC_ENABLE) ? (uintptr_t)o->CMAR + (uintptr_t)len * msize : lo + msize;
+        if (addr < hi && addr + size > lo)
+        {
+            g_sim_stats.dma_conflicts++;
+        }
+    }
+}
+
+/**
+ * @brief       һ DMA : 赽洢ʱд *value, 洢(DIR=1)ʱ *value
+ * @param       ch   : ͨ±(0~6 Ϊ DMA1 ͨ1~7, 7~11 Ϊ DMA2 ͨ1~5)
+ * @param       value: 
+ * @retval      1, һδ; 0, ͨδʹܻѴ
+ */
+static int sim_dma_transfer(int ch, uint32_t *value)
+{
+    DMA_Channel_TypeDef *c = &sim_dma_ch[ch];
+    DMA_TypeDef *dma = ch < 7 ? DMA1 : DMA2;
+    uint32_t shift = 4 * (ch < 7 ? ch : ch - 7);
+    uint32_t msize, pos;
+    uintptr_t addr;
+
+    if (!(c->CCR & DMA_CCR_EN) || c->CNDTR == 0)
+    {
+        return 0;
+    }
+    if (c->CNDTR != g_sim_dma_remain[ch])
+    {
+        g_sim_dma_len[ch] = c->CNDTR; /* ̼װ˴ */
+    }
+
+    msize = 1U << ((c->CCR >> 10) & 3);
+    pos = (c->CCR & DMA_MINC_ENABLE) ? g_sim_dma_len[ch] - c->CNDTR : 0;
+    addr = (uintptr_t)c->CMAR + (uintptr_t)pos * msize;
+    if (c->CCR & DMA_CCR_DIR)
+    {
+        *value = msize == 1 ? *(uint8_t *)addr : msize == 2 ? *(uint16_t *)addr : *(uint32_t *)addr;
+    }
+    else
+    {
+        sim_dma_check_conflict(ch, addr, msize);
+        if (msize == 1)
+        {
+            *(uint8_t *)addr = (uint8_t)*value;
+        }
+        else if (msize == 2)
+        {
+            *(uint16_t *)addr = (uint16_t)*value;
+        }
+        else
+        {
+            *(uint32_t *)addr = *value;
+        }
+    }
+    c->CNDTR--;
+    if (ch == 0)
+    {
+        g_sim_stats.samples_captured++;
+    }
+
+    if (c->CNDTR == g_sim_dma_len[ch] / 2)
+    {
+        dma->ISR |= (1UL << (shift + 2)) | (1UL << shift); /* HTIF, GIF */
+        if ((c->CCR & DMA_CCR_HTIE) && ch < 7)
+        {
+            g_sim_irq_pending[DMA1_Channel1_IRQn + ch] = 1;
+        }
+    }
+    if (c->CNDTR == 0)
+    {
+        dma->ISR |= (1UL << (shift + 1)) | (1UL << shift); /* TCIF, GIF */
+        g_sim_stats.dma_blocks += (ch == 0);
+        if (c->CCR & DMA_CCR_CIRC)
+        {
+            c->CNDTR = g_sim_dma_len[ch];
+        }
+        if ((c->CCR & DMA_CCR_TCIE) && ch < 7)
+        {
+            g_sim_irq_pending[DMA1_Channel1_IRQn + ch] = 1;
+        }
+    }
+    g_sim_dma_remain[ch] = c->CNDTR;
+    return 1;
+}
+
+/* 赽洢һ DMA  */
+static void sim_dma_request(int ch, uint32_t value)
+{
+    sim_dma_transfer(ch, &value);
+    sim_irq_dispatch();
+}
+
+static void sim_adc_convert(void)
+{
+    uint16_t value = g_sim_source ? g_sim_source(g_sim_stats.samples_produced, g_sim_stats.now_ns) : 0;
+
+    if (g_sim_stopped)
+    {
+        return; /* ԴѾ */
+    }
+    ADC1->DR = value & 0x0FFF;
+    ADC1->SR |= 1 << 1; /* EOC */
+    g_sim_stats.samples_produced++;
+    g_sim_adc_k++;
+    if (!(ADC1->CR2 & (1 << 1)))
+    {
+        g_sim_adc_running = 0; /* תģʽ */
+    }
+    if (ADC1->CR2 & (1 << 8))
+    {
+        sim_dma_request(0, ADC1->DR); /* ADC1 ̶ʹ DMA1 ͨ1 */
+    }
+}
+
+/******************************************************************************************/
+/*  */
+
+static int sim_exti_irqn(uint16_t pin)
+{
+    int line = 0;
+
+    while (line < 15 && !(pin & (1U << line)))
+    {
+        line++;
+    }
+    if (line <= 4)
+    {
+        return EXTI0_IRQn + line;
+    }
+    return line <= 9 ? EXTI9_5_IRQn : EXTI15_10_IRQn;
+}
+
+void sim_schedule_key(uint64_t t_ns, GPIO_TypeDef *port, uint16_t pin, uint8_t level, uint32_t hold_ms)
+{
+    int i;
+
+    if (g_sim_key_num >= SIM_KEY_EVENTS)
+    {
+        return;
+    }
+    for (i = g_sim_key_num; i > 0 && g_sim_keys[i - 1].t_ns > t_ns; i--)
+    {
+        g_sim_keys[i] = g_sim_keys[i - 1];
+    }
+    g_sim_keys[i].t_ns = t_ns;
+    g_sim_keys[i].port = port;
+    g_sim_keys[i].pin = pin;
+    g_sim_keys[i].level = level;
+    g_sim_keys[i].hold_ms = hold_ms;
+    g_sim_key_num++;
+}
+
+static void sim_key_fire(void)
+{
+    sim_key_event_t ev = g_sim_keys[0];
+    uint8_t old = (ev.port->IDR & ev.pin) ? 1 : 0;
+
+    memmove(&g_sim_keys[0], &g_sim_keys[1], (size_t)(g_sim_key_num - 1) * sizeof(sim_key_event_t));
+    g_sim_key_num--;
+
+    if (ev.level)
+    {
+        ev.port->IDR |= ev.pin;
+    }
+    else
+    {
+        ev.port->IDR &= ~(uint32_t)ev.pin;
+    }
+    if (ev.hold_ms)
+    {
+        sim_schedule_key(ev.t_ns + ev.hold_ms * 1000000ULL, ev.port, ev.pin, !ev.level, 0);
+    }
+
+    if ((EXTI->IMR & ev.pin) && old != ev.level &&
+        ((ev.level && (EXTI->RTSR & ev.pin)) || (!ev.level && (EXTI->FTSR & ev.pin))))
+    {
+        EXTI->PR |= ev.pin;
+        sim_irq_raise(sim_exti_irqn(ev.pin));
+    }
+}
+
+/******************************************************************************************/
+/* ʱ¼, ֻԿ˸жϡԸ¼ TRGO (TIM1) CC1  TIM1~TIM5 ;
+ * TIM1_CC1 ¼¼ͬƵ, λӰ, ¼ʱ̴ ADC */
+
+#define SIM_TIM_FIRST 1
+#define SIM_TIM_LAST 5
+
+static int sim_tim_irqn(int i)
+{
+    return i == 1 ? TIM1_UP_IRQn : i == 5 ? TIM5_IRQn : TIM2_IRQn + (i - 2);
+}
+
+/* ģʽڲ ITR0~3 ӵʱ(RM0008  86), 0 ʾ֧ */
+static int sim_tim_itr_master(int slave, uint32_t ts)
+{
+    static const int8_t itr[6][4] = {{0}, {0}, {1, 8, 3, 4}, {1, 2, 5, 4}, {1, 2, 3, 8}, {2, 3, 4, 8}};
+
+    return ts < 4 && slave >= SIM_TIM_FIRST && slave <= SIM_TIM_LAST ? itr[slave][ts] : 0;
+}
+
+/* ʱ DMA ͻ:  DCR  DBA/DBL  DMA дĴ */
+static void sim_tim_dma_burst(TIM_TypeDef *tim, int ch)
+{
+    uint32_t dba = tim->DCR & 0x1F, dbl = (tim->DCR >> 8) & 0x1F, k, value;
+    volatile uint32_t *reg = (volatile uint32_t *)tim;
+
+    for (k = 0; k <= dbl && dba + k <= 19; k++)
+    {
+        if (!sim_dma_transfer(ch, &value))
+        {
+            break;
+        }
+        reg[dba + k] = value;
+    }
+    sim_irq_dispatch();
+}
+
+/* ʱ¼ TRGO ͵Ӷʱ: λģʽ, TDE ʱ DMA(ֻ TIM3_TRIG  DMA1 ͨ6) */
+static void sim_tim_trgo(int master)
+{
+    int i;
+
+    if ((sim_tim[master].CR2 & 0x70) != TIM_TRGO_UPDATE)
+    {
+        return;
+    }
+    for (i = SIM_TIM_FIRST; i <= SIM_TIM_LAST; i++)
+    {
+        TIM_TypeDef *tim = &sim_tim[i];
+
+        if (i == master || (tim->SMCR & 7) == 0 || sim_tim_itr_master(i, (tim->SMCR >> 4) & 7) != master)
+        {
+            continue;
+        }
+        if ((tim->SMCR & 7) == 4)
+        {
+            tim->CNT = 0; /* λģʽ */
+        }
+        tim->SR |= 1UL << 6; /* TIF */
+        if ((tim->DIER & (1UL << 14)) && i == 3)
+        {
+            sim_tim_dma_burst(tim, 5);
+        }
+    }
+}
+
+/* ʹܺ PSC/ARR ͵ǰ CNT һθ¼, رȡ */
+static void sim_tim_poll(void)
+{
+    int i;
+
+    for (i = SIM_TIM_FIRST; i <= SIM_TIM_LAST; i++)
+    {
+        TIM_TypeDef *tim = &sim_tim[i];
+
+        if (!(tim->CR1 & TIM_CR1_CEN) || (!(tim->DIER & TIM_IT_UPDATE) && (tim->CR2 & 0x70) != TIM_TRGO_UPDATE &&
+                                            !(i == 1 && (tim->CCER & 1))))
+        {
+            g_sim_tim_running[i] = 0;
+            continue;
+        }
+        if (!g_sim_tim_running[i])
+        {
+            uint32_t cnt = tim->CNT <= tim->ARR ? tim->CNT : 0;
+
+            g_sim_tim_running[i] = 1;
+            g_sim_tim_period_ns[i] = ((double)tim->PSC + 1) * ((double)tim->ARR + 1) * 1e9 / SIM_CPU_HZ;
+            g_sim_tim_next_ns[i] = g_sim_stats.now_ns +
+                                   (uint64_t)(g_sim_tim_period_ns[i] * (tim->ARR + 1 - cnt) / (tim->ARR + 1));
+        }
+    }
+}
+
+static uint64_t sim_tim_next_ns(void)
+{
+    uint64_t next = UINT64_MAX;
+    int i;
+
+    for (i = SIM_TIM_FIRST; i <= SIM_TIM_LAST; i++)
+    {
+        if (g_sim_tim_running[i] && g_sim_tim_next_ns[i] < next)
+        {
+            next = g_sim_tim_next_ns[i];
+        }
+    }
+    return next;
+}
+
+static uint8_t sim_tim_fire(void)
+{
+    uint8_t fired = 0;
+    int i;
+
+    for (i = SIM_TIM_FIRST; i <= SIM_TIM_LAST; i++)
+    {
+        TIM_TypeDef *tim = &sim_tim[i];
+
+        if (!g_sim_tim_running[i] || g_sim_stats.now_ns < g_sim_tim_next_ns[i])
+        {
+            continue;
+        }
+        fired = 1;
+        tim->SR |= TIM_FLAG_UPDATE;
+        tim->CNT = 0;
+        if (tim->CR1 & TIM_CR1_OPM)
+        {
+            tim->CR1 &= ~TIM_CR1_CEN; /* ģʽ: ¼ֹͣ */
+            g_sim_tim_running[i] = 0;
+        }
+        else
+        {
+            g_sim_tim_next_ns[i] += (uint64_t)g_sim_tim_period_ns[i];
+        }
+        sim_tim_trgo(i);
+        if (i == 1 && (tim->CCER & 1))
+        {
+            sim_adc_ext_trigger(0); /* EXTSEL=000: TIM1_CC1 */
+        }
+        if (tim->DIER & TIM_IT_UPDATE)
+        {
+            sim_irq_raise(sim_tim_irqn(i));
+        }
+    }
+    return fired;
+}
+
+/* д: ڵĶʱ¼ֵ */
+void sim_tim_set_counter(TIM_TypeDef *tim, uint32_t cnt)
+{
+    tim->CNT = cnt;
+    g_sim_tim_running[tim - sim_tim] = 0;
+    sim_tim_poll();
+}
+
+/******************************************************************************************/
+/*  */
+
+/* ǰ BRR  n ֽ(ÿֽ10λ)ʱ, ns; usart_init ֮ǰ 115200  */
+static uint64_t sim_uart_bytes_ns(uint32_t n)
+{
+    uint32_t brr = USART1->BRR ? USART1->BRR : SIM_CPU_HZ / 115200;
+
+    return (uint64_t)n * 10ULL * 1000000000ULL * brr / SIM_CPU_HZ;
+}
+
+void sim_uart_inject(uint64_t t_ns, const uint8_t *data, uint16_t len)
+{
+    uint64_t byte_ns = sim_uart_bytes_ns(1);
+    uint16_t k;
+
+    for (k = 0; k < len && g_sim_rx_num < SIM_RX_BYTES; k++)
+    {
+        uint64_t t = t_ns + k * byte_ns;
+        int i;
+
+        for (i = g_sim_rx_num; i > 0 && g_sim_rx_t[i - 1] > t; i--)
+        {
+            g_sim_rx_t[i] = g_sim_rx_t[i - 1];
+            g_sim_rx_data[i] = g_sim_rx_data[i - 1];
+            g_sim_rx_cont[i] = g_sim_rx_cont[i - 1];
+        }
+        g_sim_rx_t[i] = t;
+        g_sim_rx_data[i] = data[k];
+        g_sim_rx_cont[i] = k > 0;
+        g_sim_rx_num++;
+    }
+}
+
+/* һֽڵ:  DMAR ʱ DMA1 ͨ5 ȡ,  RXNE */
+static void sim_rx_byte(void)
+{
+    uint8_t b = g_sim_rx_data[0];
+
+    g_sim_rx_num--;
+    memmove(&g_sim_rx_t[0], &g_sim_rx_t[1], (size_t)g_sim_rx_num * sizeof(g_sim_rx_t[0]));
+    memmove(&g_sim_rx_data[0], &g_sim_rx_data[1], (size_t)g_sim_rx_num);
+    memmove(&g_sim_rx_cont[0], &g_sim_rx_cont[1], (size_t)g_sim_rx_num);
+    if (g_sim_rx_num && g_sim_rx_cont[0])
+    {
+        g_sim_rx_t[0] = g_sim_stats.now_ns + sim_uart_bytes_ns(1); /* ̼Ѿ˲ */
+    }
+
+    USART1->DR = b;
+    USART1->SR |= USART_SR_RXNE;
+    g_sim_rx_idle_ns = g_sim_stats.now_ns + sim_uart_bytes_ns(1);
+    if (USART1->CR3 & USART_CR3_DMAR)
+    {
+        USART1->SR &= ~USART_SR_RXNE;
+        sim_dma_request(4, b); /* USART1_RX ̶ʹ DMA1 ͨ5 */
+    }
+    else if (USART1->CR1 & USART_CR1_RXNEIE)
+    {
+        sim_irq_raise(USART1_IRQn);
+    }
+}
+
+static void sim_rx_idle(void)
+{
+    g_sim_rx_idle_ns = 0;
+    USART1->SR |= USART_SR_IDLE;
+    if (USART1->CR1 & USART_CR1_IDLEIE)
+    {
+        sim_irq_raise(USART1_IRQn);
+    }
+}
+
+/*  DMA:  DMAT  DMA1 ͨ4 ʱȡһֽڿʼ, һֽʱ */
+static void sim_uart_tx_poll(void)
+{
+    uint32_t b;
+
+    if (g_sim_tx_done_ns || !(USART1->CR3 & USART_CR3_DMAT) || !sim_dma_transfer(3, &b)) /* USART1_TX ̶ʹ DMA1 ͨ4 */
+    {
+        return;
+    }
+    if (g_sim_uart_sink)
+    {
+        uint8_t c = (uint8_t)b;
+
+        g_sim_uart_sink(&c, 1);
+    }
+    g_sim_stats.uart_bytes++;
+    USART1->SR &= ~USART_SR_TC;
+    g_sim_tx_done_ns = g_sim_stats.now_ns + sim_uart_bytes_ns(1);
+    sim_irq_dispatch(); /* һֽȡʱ DMA  */
+}
+
+/* һֽڷ: ŷһ, û TC */
+static void sim_uart_tx_done(void)
+{
+    g_sim_tx_done_ns = 0;
+    sim_uart_tx_poll();
+    if (!g_sim_tx_done_ns)
+    {
+        USART1->SR |= USART_SR_TC | USART_SR_TXE;
+    }
+}
+
+/* ѯ TC ʱʱճ: DMA ڷƽǰֽڷ */
+uint8_t sim_uart_get_flag(USART_TypeDef *usart, uint32_t flag)
+{
+    if ((usart->SR & flag) != flag && flag == USART_SR_TC && g_sim_tx_done_ns > g_sim_stats.now_ns)
+    {
+        sim_advance(g_sim_tx_done_ns - g_sim_stats.now_ns);
+    }
+    return (usart->SR & flag) == flag;
+}
+
+/******************************************************************************************/
+/* ʱ */
+
+static uint64_t sim_host_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t sim_next_event_ns(uint64_t limit)
+{
+    uint64_t next = limit;
+
+    if (g_sim_next_tick_ns < next)
+    {
+        next = g_sim_next_tick_ns;
+    }
+    if (g_sim_adc_running && sim_adc_next_ns() < next)
+    {
+        next = sim_adc_next_ns();
+    }
+    if (g_sim_key_num && g_sim_keys[0].t_ns < next)
+    {
+        next = g_sim_keys[0].t_ns;
+    }
+    if (sim_tim_next_ns() < next)
+    {
+        next = sim_tim_next_ns();
+    }
+    if (g_sim_rx_num && g_sim_rx_t[0] < next)
+    {
+        next = g_sim_rx_t[0];
+    }
+    if (g_sim_rx_idle_ns && g_sim_rx_idle_ns < next)
+    {
+        next = g_sim_rx_idle_ns;
+    }
+    if (g_sim_tx_done_ns && g_sim_tx_done_ns < next)
+    {
+        next = g_sim_tx_done_ns;
+    }
+    if (sim_usb_next_ns() < next)
+    {
+        next = sim_usb_next_ns();
+    }
+    if (g_sim_config.end_ns && g_sim_config.end_ns < next)
+    {
+        next = g_sim_config.end_ns;
+    }
+    return next;
+}
+
+static void sim_end(void)
+{
+    if (g_sim_finish)
+    {
+        g_sim_finish();
+    }
+    exit(0);
+}
+
+/**
+ * @brief       ƽʱ, ڼADCתDMA䡢SysTickʱ¡շͰ¼
+ *   @note       cpu_scale ʱ, ϴηִй̼ʱ  cpu_scale һ
+ * @param       ns: ƽʱ
+ * @retval      
+ */
+void sim_advance(uint64_t ns)
+{
+    uint64_t target;
+
+    if (g_sim_advancing == 0 && g_sim_config.cpu_scale > 0)
+    {
+        uint64_t host = sim_host_ns();
+
+        if (g_sim_host_last.tv_sec || g_sim_host_last.tv_nsec)
+        {
+            uint64_t last = (uint64_t)g_sim_host_last.tv_sec * 1000000000ULL + (uint64_t)g_sim_host_last.tv_nsec;
+            ns += (uint64_t)((double)(host - last) * g_sim_config.cpu_scale);
+        }
+    }
+
+    target = g_sim_stats.now_ns + ns;
+    g_sim_advancing++;
+    sim_adc_poll();
+    sim_tim_poll();
+    sim_uart_tx_poll();
+
+    while (1)
+    {
+        uint64_t next;
+        uint8_t handled = 0;
+
+        if (g_sim_stopped || (g_sim_config.end_ns && g_sim_stats.now_ns >= g_sim_config.end_ns))
+        {
+            sim_end();
+        }
+        next = sim_next_event_ns(target);
+        if (next > g_sim_stats.now_ns)
+        {
+            g_sim_stats.now_ns = next;
+        }
+        if (g_sim_stats.now_ns >= g_sim_next_tick_ns)
+        {
+            handled = 1;
+            g_sim_next_tick_ns += 1000000;
+            if (SysTick_Handler)
+            {
+                SysTick_Handler();
+            }
+            else
+            {
+                HAL_IncTick();
+            }
+        }
+        if (g_sim_adc_running && g_sim_stats.now_ns >= sim_adc_next_ns())
+        {
+            handled = 1;
+            sim_adc_convert();
+        }
+        if (g_sim_key_num && g_sim_stats.now_ns >= g_sim_keys[0].t_ns)
+        {
+            handled = 1;
+            sim_key_fire();
+        }
+        if (sim_tim_fire())
+        {
+            handled = 1;
+        }
+        if (g_sim_rx_num && g_sim_stats.now_ns >= g_sim_rx_t[0])
+        {
+            handled = 1;
+            sim_rx_byte();
+        }
+        else if (g_sim_rx_idle_ns && g_sim_stats.now_ns >= g_sim_rx_idle_ns)
+        {
+            handled = 1;
+            sim_rx_idle();
+        }
+        if (g_sim_tx_done_ns && g_sim_stats.now_ns >= g_sim_tx_done_ns)
+        {
+            handled = 1;
+            sim_uart_tx_done();
+        }
+        if (sim_usb_fire())
+        {
+            handled = 1;
+        }
+        sim_dma_apply_ifcr();
+        sim_adc_poll();     /* жϷת */
+        sim_tim_poll();     /* ͣ˶ʱ */
+        sim_uart_tx_poll(); /* ˴ڷ DMA */
+        if (g_sim_preempt && g_sim_advancing == 1 && g_sim_active_prio == SIM_THREAD_PRIO && !g_sim_primask)
+        {
+            /* жϻ˸ȼʱл; Լ sim_advance , Ƕ׼񱣴 */
+            int saved = g_sim_advancing;
+
+            g_sim_advancing = 0;
+            g_sim_preempt();
+            g_sim_advancing = saved;
+        }
+        if (!handled && g_sim_stats.now_ns >= target)
+        {
+            break;
+        }
+    }
+
+    g_sim_advancing--;
+    if (g_sim_advancing == 0 && g_sim_config.cpu_scale > 0)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &g_sim_host_last); /* ĺʱ */
+    }
+}
+
+/**
+ * @brief       еȴ
+ *   @note      ģʽж(SysTick)ǰ, ൱ȥѭʱ
+ * @param       ns: ȴʱ
+ * @retval      
+ */
+void sim_idle(uint64_t ns)
+{
+    uint64_t end = g_sim_stats.now_ns + ns;
+
+    if (!g_sim_config.fast)
+    {
+        sim_advance(ns);
+        return;
+    }
+
+    g_sim_woken = 0;
+    while (!g_sim_woken && g_sim_stats.now_ns < end)
+    {
+        uint64_t next = sim_next_event_ns(end);
+
+        sim_advance(next > g_sim_stats.now_ns ? next - g_sim_stats.now_ns : 0);
+    }
+}
+
+/* ˯ߵһ¼, ڼ䵽ڵжճִ */
+void __WFI(void)
+{
+    uint64_t next = sim_next_event_ns(UINT64_MAX);
+
+    sim_advance(next > g_sim_stats.now_ns ? next - g_sim_stats.now_ns : 0);
+}
+
+DWT_Type *sim_dwt(void)
+{
+    sim_advance(0);
+    if ((CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk) && (g_sim_dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        g_sim_dwt.CYCCNT = (uint32_t)(g_sim_stats.now_ns * SIM_CPU_HZ / 1000000000ULL);
+    }
+    return &g_sim_dwt;
+}
+
+/******************************************************************************************/
+/* HAL  */
+
+HAL_StatusTypeDef HAL_Init(void)
+{
+    g_sim_tick = 0;
+    return HAL_OK;
+}
+
+/* 96λоƬΨһID, Ϊ̶ֵ */
+uint32_t HAL_GetUIDw0(void) { return 0x0657FF31; }
+uint32_t HAL_GetUIDw1(void) { return 0x3331524E; }
+uint32_t HAL_GetUIDw2(void) { return 0x43086713; }
+
+void HAL_IncTick(void)
+{
+    g_sim_tick++;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    sim_advance(0);
+    return g_sim_tick;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    sim_idle((uint64_t)Delay * 1000000ULL);
+}
+
+void sys_stm32_clock_init(uint32_t plln)
+{
+    (void)plln;
+}
+
+void delay_init(uint16_t sysclk)
+{
+    (void)sysclk;
+}
+
+void delay_ms(uint16_t nms)
+{
+    sim_idle((uint64_t)nms * 1000000ULL);
+}
+
+void delay_us(uint32_t nus)
+{
+    sim_advance((uint64_t)nus * 1000ULL); /* ΢ʱæ, ǰ */
+}
+
+void led_init(void)
+{
+    LED0(1);
+    LED1(1);
+}
+
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *PeriphClkInit)
+{
+    if (PeriphClkInit->PeriphClockSelection & RCC_PERIPHCLK_ADC)
+    {
+        g_sim_adc_div = 2 + 2 * ((PeriphClkInit->AdcClockSelection >> 14) & 3);
+    }
+    return HAL_OK;
+}
+
+/******************************************************************************************/
+/* GPIO */
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+    uint32_t pin = GPIO_Init->Pin;
+
+    if ((GPIO_Init->Mode & 0x10000000U) && GPIOx)
+    {
+        EXTI->IMR |= pin;
+        EXTI->RTSR = (GPIO_Init->Mode & 0x00100000U) ? EXTI->RTSR | pin : EXTI->RTSR & ~pin;
+        EXTI->FTSR = (GPIO_Init->Mode & 0x00200000U) ? EXTI->FTSR | pin : EXTI->FTSR & ~pin;
+    }
+    if (GPIO_Init->Pull == GPIO_PULLUP)
+    {
+        GPIOx->IDR |= pin;
+    }
+    else if (GPIO_Init->Pull == GPIO_PULLDOWN)
+    {
+        GPIOx->IDR &= ~pin;
+    }
+}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin)
+{
+    (void)GPIOx;
+    EXTI->IMR &= ~GPIO_Pin;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (PinState)
+    {
+        GPIOx->ODR |= GPIO_Pin;
+    }
+    else
+    {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    GPIOx->ODR ^= GPIO_Pin;
+}
+
+void HAL_GPIO_EXTI_IRQHandler(uint16_t GPIO_Pin)
+{
+    if (EXTI->PR & GPIO_Pin)
+    {
+        EXTI->PR &= ~(uint32_t)GPIO_Pin;
+        HAL_GPIO_EXTI_Callback(GPIO_Pin);
+    }
+}
+
+__weak void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    (void)GPIO_Pin;
+}
+
+/******************************************************************************************/
+/* DMA */
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma)
+{
+    hdma->Instance->CCR = hdma->Init.Direction | hdma->Init.PeriphInc | hdma->Init.MemInc |
+                          hdma->Init.PeriphDataAlignment | hdma->Init.MemDataAlignment | hdma->Init.Mode |
+                          hdma->Init.Priority;
+    hdma->State = HAL_DMA_STATE_READY;
+    return HAL_OK;
+}
+
+/*  HAL һ: ͨæʱ HAL_BUSY, ޸ļĴ */
+static HAL_StatusTypeDef sim_dma_start(DMA_HandleTypeDef *hdma, uint32_t src, uint32_t dst, uint32_t len, uint32_t it)
+{
+    DMA_Channel_TypeDef *c = hdma->Instance;
+
+    if (hdma->State != HAL_DMA_STATE_READY)
+    {
+        return HAL_BUSY;
+    }
+    hdma->State = HAL_DMA_STATE_BUSY;
+
+    c->CCR &= ~DMA_CCR_EN;
+    c->CNDTR = len;
+    if (c->CCR & DMA_CCR_DIR)
+    {
+        c->CPAR = dst;
+        c->CMAR = src;
+    }
+    else
+    {
+        c->CPAR = src;
+        c->CMAR = dst;
+    }
+    c->CCR = (c->CCR & ~(DMA_CCR_TCIE | DMA_CCR_HTIE | DMA_CCR_TEIE)) | it;
+    c->CCR |= DMA_CCR_EN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength)
+{
+    return sim_dma_start(hdma, SrcAddress, DstAddress, DataLength, 0);
+}
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength)
+{
+    return sim_dma_start(hdma, SrcAddress, DstAddress, DataLength, DMA_CCR_TCIE | DMA_CCR_TEIE);
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma)
+{
+    hdma->Instance->CCR &= ~(DMA_CCR_EN | DMA_CCR_TCIE | DMA_CCR_HTIE | DMA_CCR_TEIE);
+    hdma->State = HAL_DMA_STATE_READY;
+    return HAL_OK;
+}
+
+/******************************************************************************************/
+/* ADC */
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc)
+{
+    hadc->Instance->CR2 = (hadc->Instance->CR2 & ~((1UL << 1) | (7UL << 17))) |
+                          (hadc->Init.ContinuousConvMode ? (1UL << 1) : 0) | hadc->Init.ExternalTrigConv; /* CONT, EXTSEL */
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc)
+{
+    hadc->Instance->CR2 |= 1 << 0; /* У׼ǰ HAL ʹ ADC */
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig)
+{
+    ADC_TypeDef *adc = hadc->Instance;
+    uint32_t ch = sConfig->Channel;
+
+    if (sConfig->Rank == ADC_REGULAR_RANK_1)
+    {
+        adc->SQR3 = (adc->SQR3 & ~0x1FUL) | ch;
+    }
+    if (ch < 10)
+    {
+        adc->SMPR2 = (adc->SMPR2 & ~(7UL << (3 * ch))) | (sConfig->SamplingTime << (3 * ch));
+    }
+    else
+    {
+        adc->SMPR1 = (adc->SMPR1 & ~(7UL << (3 * (ch - 10)))) | (sConfig->SamplingTime << (3 * (ch - 10)));
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length)
+{
+    hadc->Instance->CR2 |= (1 << 0) | (1 << 8) | (1UL << 20); /* ADON, DMA,  HAL һͬʱλ EXTTRIG */
+    HAL_DMA_Start_IT(hadc->DMA_Handle, (uint32_t)(uintptr_t)&hadc->Instance->DR, (uint32_t)(uintptr_t)pData, Length);
+    hadc->Instance->CR2 |= 1UL << 22; /*  */
+    sim_adc_poll();
+    return HAL_OK;
+}
+
+/******************************************************************************************/
+/* TIM */
+
+uint32_t sim_tim_counter(TIM_TypeDef *tim)
+{
+    sim_advance(0);
+    if (tim->CR1 & TIM_CR1_CEN)
+    {
+        uint64_t ticks = g_sim_stats.now_ns * SIM_CPU_HZ / 1000000000ULL / (tim->PSC + 1);
+        tim->CNT = (uint32_t)(ticks % ((uint64_t)tim->ARR + 1));
+    }
+    return tim->CNT;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim)
+{
+    htim->Instance->PSC = htim->Init.Prescaler;
+    htim->Instance->ARR = htim->Init.Period;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim)
+{
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim)
+{
+    htim->Instance->DIER |= 1 << 0;
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim)
+{
+    htim->Instance->DIER &= ~(1UL << 0);
+    htim->Instance->CR1 &= ~TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_ConfigClockSource(TIM_HandleTypeDef *htim, TIM_ClockConfigTypeDef *sClockSourceConfig)
+{
+    (void)htim;
+    (void)sClockSourceConfig;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim, TIM_MasterConfigTypeDef *sMasterConfig)
+{
+    htim->Instance->CR2 = sMasterConfig->MasterOutputTrigger;
+    return HAL_OK;
+}
+
+__weak void HAL_TIM_PWM_MspInit(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef *htim)
+{
+    HAL_TIM_PWM_MspInit(htim);
+    return HAL_TIM_Base_Init(htim);
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim, TIM_OC_InitTypeDef *sConfig, uint32_t Channel)
+{
+    __HAL_TIM_SET_COMPARE(htim, Channel, sConfig->Pulse);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    htim->Instance->CCER |= 1UL << Channel;
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    htim->Instance->CCER &= ~(1UL << Channel);
+    if ((htim->Instance->CCER & 0x1111) == 0)
+    {
+        htim->Instance->CR1 &= ~TIM_CR1_CEN;
+    }
+    return HAL_OK;
+}
+
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
+{
+    if ((htim->Instance->SR & 1) && (htim->Instance->DIER & 1))
+    {
+        htim->Instance->SR &= ~1UL;
+        HAL_TIM_PeriodElapsedCallback(htim);
+    }
+}
+
+__weak void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+}
+
+/******************************************************************************************/
+/* UART */
+
+void usart_init(uint32_t baudrate)
+{
+    g_uart1_handle.Instance = USART1;
+    g_uart1_handle.Init.BaudRate = baudrate;
+    USART1->BRR = (uint32_t)(SIM_CPU_HZ / baudrate); /* USART1  APB2(72MHz)  */
+    USART1->SR = USART_SR_TC | USART_SR_TXE;
+}
+
+/**
+ * @brief       ,  10 λ/ֽ  BRR Ĳƽʱ, ڼճӦж
+ * @param       data: 
+ * @param       len : 
+ * @retval      
+ */
+void sim_uart_write(const uint8_t *data, uint16_t len)
+{
+    if (len == 0)
+    {
+        return;
+    }
+    if (g_sim_uart_sink)
+    {
+        g_sim_uart_sink(data, len);
+    }
+    g_sim_stats.uart_bytes += len;
+
+    USART1->SR &= ~USART_SR_TC;
+    sim_advance(sim_uart_bytes_ns(len));
+    USART1->SR |= USART_SR_TC | USART_SR_TXE;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)huart;
+    (void)Timeout;
+    sim_uart_write(pData, Size);
+    return HAL_OK;
+}
+
+void sim_usb_sink(const uint8_t *data, uint16_t len)
+{
+    if (g_sim_uart_sink)
+    {
+        g_sim_uart_sink(data, len);
+    }
+}
+
+int sim_uart_printf(const char *fmt, ...)
+{
+    char buf[512];
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n > (int)sizeof(buf) - 1)
+    {
+        n = sizeof(buf) - 1;
+    }
+    if (n > 0)
+    {
+        sim_uart_write((const uint8_t *)buf, (uint16_t)n);
+    }
+    return n;
+}
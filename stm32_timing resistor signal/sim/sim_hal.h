@@ -0,0 +1,696 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_hal.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * PC Ŀõ HAL/Ĵ, ֻʵֹ̼õĲ:
+ * 1, Ĵͨṹ, ̼ļĴ(myADC_DMA_enable )ԭ
+ * 2, ʱʱ, ֻʱ__WFIڷ͡ DWT->CYCCNT λƽ;
+ *    ƽаʲADC, DMA д CMAR ָĻ, ʱжϷ;
+ *    ˸жϵĶʱ PSC/ARR ¼(ֵ֧ģʽ), TIM1_CC1 Ϊ ADC ⲿ;
+ *    ڰ BRR Ĳֽշ: վ DMA  RXNE жȡ, ֮һֽʱʱ IDLE,
+ *    Ϳ(HAL_UART_Transmit)Ҳ DMA1 ͨ4(DMAT)ֽڰ;
+ *    USB 豸(PCD)ͶԶ sim_usb.c: ȫߵİʱö١ IN ˵㡢д OUT ˵
+ * 3, ̼ѵַת uint32_t ( (uint32_t)&g_adc_dma_buf), ˱ -no-pie ,
+ *    ֤ȫֱַڵ4G
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef _SIM_HAL_H
+#define _SIM_HAL_H
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************************/
+/*  */
+
+typedef enum
+{
+    HAL_OK = 0,
+    HAL_ERROR,
+    HAL_BUSY,
+    HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+    RESET = 0,
+    SET = !RESET
+} FlagStatus;
+
+typedef enum
+{
+    DISABLE = 0,
+    ENABLE = !DISABLE
+} FunctionalState;
+
+#define __weak __attribute__((weak))
+#define __IO volatile
+
+/* жϺ,  stm32f103xe.h һ */
+typedef enum
+{
+    SysTick_IRQn = -1,
+    EXTI0_IRQn = 6,
+    EXTI1_IRQn = 7,
+    EXTI2_IRQn = 8,
+    EXTI3_IRQn = 9,
+    EXTI4_IRQn = 10,
+    DMA1_Channel1_IRQn = 11,
+    DMA1_Channel2_IRQn = 12,
+    DMA1_Channel3_IRQn = 13,
+    DMA1_Channel4_IRQn = 14,
+    DMA1_Channel5_IRQn = 15,
+    DMA1_Channel6_IRQn = 16,
+    DMA1_Channel7_IRQn = 17,
+    USB_LP_CAN1_RX0_IRQn = 20,
+    EXTI9_5_IRQn = 23,
+    TIM1_UP_IRQn = 25,
+    TIM2_IRQn = 28,
+    TIM3_IRQn = 29,
+    TIM4_IRQn = 30,
+    USART1_IRQn = 37,
+    EXTI15_10_IRQn = 40,
+    TIM5_IRQn = 50,
+    SIM_IRQ_NUM = 60
+} IRQn_Type;
+
+/******************************************************************************************/
+/* Ĵ */
+
+typedef struct
+{
+    __IO uint32_t CRL, CRH, IDR, ODR, BSRR, BRR, LCKR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t IMR, EMR, RTSR, FTSR, SWIER, PR;
+} EXTI_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t SR, CR1, CR2, SMPR1, SMPR2, JOFR1, JOFR2, JOFR3, JOFR4, HTR, LTR;
+    __IO uint32_t SQR1, SQR2, SQR3, JSQR, JDR1, JDR2, JDR3, JDR4, DR;
+} ADC_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t CCR, CNDTR, CPAR, CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t ISR, IFCR;
+} DMA_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t CR1, CR2, SMCR, DIER, SR, EGR, CCMR1, CCMR2, CCER, CNT, PSC, ARR, RCR;
+    __IO uint32_t CCR1, CCR2, CCR3, CCR4, BDTR, DCR, DMAR;
+} TIM_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t SR, DR, BRR, CR1, CR2, CR3, GTPR;
+} USART_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t EP0R, EP1R, EP2R, EP3R, EP4R, EP5R, EP6R, EP7R;
+    __IO uint32_t CNTR, ISTR, FNR, DADDR, BTABLR;
+} USB_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t CTRL, CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    __IO uint32_t DHCSR, DCRSR, DCRDR, DEMCR;
+} CoreDebug_Type;
+
+extern GPIO_TypeDef sim_gpio[7];
+extern EXTI_TypeDef sim_exti;
+extern ADC_TypeDef sim_adc[2];
+extern DMA_TypeDef sim_dma[2];
+extern DMA_Channel_TypeDef sim_dma_ch[12]; /* DMA1 ͨ1~7, DMA2 ͨ1~5 */
+extern TIM_TypeDef sim_tim[8];             /* ±꼴ʱ */
+extern USART_TypeDef sim_usart[4];
+extern USB_TypeDef sim_usb;
+extern CoreDebug_Type sim_coredebug;
+
+#define GPIOA (&sim_gpio[0])
+#define GPIOB (&sim_gpio[1])
+#define GPIOC (&sim_gpio[2])
+#define GPIOD (&sim_gpio[3])
+#define GPIOE (&sim_gpio[4])
+#define EXTI (&sim_exti)
+#define ADC1 (&sim_adc[0])
+#define ADC2 (&sim_adc[1])
+#define DMA1 (&sim_dma[0])
+#define DMA2 (&sim_dma[1])
+#define DMA1_Channel1 (&sim_dma_ch[0])
+#define DMA1_Channel2 (&sim_dma_ch[1])
+#define DMA1_Channel3 (&sim_dma_ch[2])
+#define DMA1_Channel4 (&sim_dma_ch[3])
+#define DMA1_Channel5 (&sim_dma_ch[4])
+#define DMA1_Channel6 (&sim_dma_ch[5])
+#define DMA1_Channel7 (&sim_dma_ch[6])
+#define TIM1 (&sim_tim[1])
+#define TIM2 (&sim_tim[2])
+#define TIM3 (&sim_tim[3])
+#define TIM4 (&sim_tim[4])
+#define TIM5 (&sim_tim[5])
+#define USART1 (&sim_usart[1])
+#define USB (&sim_usb)
+#define CoreDebug (&sim_coredebug)
+#define DWT (sim_dwt()) /* ÿηʶʱˢ CYCCNT */
+
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk (1UL << 0)
+
+/* DMA CCR λ */
+#define DMA_CCR_EN (1UL << 0)
+#define DMA_CCR_TCIE (1UL << 1)
+#define DMA_CCR_HTIE (1UL << 2)
+#define DMA_CCR_TEIE (1UL << 3)
+#define DMA_CCR_DIR (1UL << 4)
+#define DMA_CCR_CIRC (1UL << 5)
+
+/* USART SR/CR1/CR3 λ */
+#define USART_SR_IDLE (1UL << 4)
+#define USART_SR_RXNE (1UL << 5)
+#define USART_SR_TC (1UL << 6)
+#define USART_SR_TXE (1UL << 7)
+#define USART_CR1_IDLEIE (1UL << 4)
+#define USART_CR1_RXNEIE (1UL << 5)
+#define USART_CR3_DMAR (1UL << 6)
+#define USART_CR3_DMAT (1UL << 7)
+
+/******************************************************************************************/
+/* RCC */
+
+#define __SIM_NOP() \
+    do              \
+    {               \
+    } while (0)
+#define __HAL_RCC_GPIOA_CLK_ENABLE() __SIM_NOP()
+#define __HAL_RCC_GPIOB_CLK_ENABLE() __SIM_NOP()
+#define __HAL_RCC_GPIOC_CLK_ENABLE() __SIM_NOP()
+#define __HAL_RCC_GPIOD_CLK_ENABLE() __SIM_NOP()
+#define __HAL_RCC_GPIOE_CLK_ENABLE() __SIM_NOP()
+#define __HAL_RCC_ADC1_CLK_ENABLE() __SIM_NOP()
+#define __HAL_RCC_DMA1_CLK_ENABLE() __SIM_NOP()
+#define __HAL_RCC_DMA2_CLK_ENABLE() __SIM_NOP()
+#define __HAL_RCC_TIM1_CLK_ENABLE() __SIM_NOP()
+#define __HAL_RCC_TIM2_CLK_ENABLE() __SIM_NOP()
+#define __HAL_RCC_TIM3_CLK_ENABLE() __SIM_NOP()
+#define __HAL_RCC_TIM4_CLK_ENABLE() __SIM_NOP()
+#define __HAL_RCC_TIM5_CLK_ENABLE() __SIM_NOP()
+#define __HAL_RCC_USART1_CLK_ENABLE() __SIM_NOP()
+#define __HAL_RCC_USB_CLK_ENABLE() __SIM_NOP()
+
+#define RCC_PERIPHCLK_ADC 0x00000002U
+#define RCC_PERIPHCLK_USB 0x00000010U
+#define RCC_USBCLKSOURCE_PLL 0x00400000U
+#define RCC_USBCLKSOURCE_PLL_DIV1_5 0x00000000U
+#define RCC_ADCPCLK2_DIV2 0x00000000U
+#define RCC_ADCPCLK2_DIV4 0x00004000U
+#define RCC_ADCPCLK2_DIV6 0x00008000U
+#define RCC_ADCPCLK2_DIV8 0x0000C000U
+#define RCC_PLL_MUL9 0x001C0000U
+
+typedef struct
+{
+    uint32_t PeriphClockSelection;
+    uint32_t RTCClockSelection;
+    uint32_t AdcClockSelection;
+    uint32_t UsbClockSelection;
+} RCC_PeriphCLKInitTypeDef;
+
+/******************************************************************************************/
+/* GPIO / EXTI */
+
+#define GPIO_PIN_0 ((uint16_t)0x0001)
+#define GPIO_PIN_1 ((uint16_t)0x0002)
+#define GPIO_PIN_2 ((uint16_t)0x0004)
+#define GPIO_PIN_3 ((uint16_t)0x0008)
+#define GPIO_PIN_4 ((uint16_t)0x0010)
+#define GPIO_PIN_5 ((uint16_t)0x0020)
+#define GPIO_PIN_6 ((uint16_t)0x0040)
+#define GPIO_PIN_7 ((uint16_t)0x0080)
+#define GPIO_PIN_8 ((uint16_t)0x0100)
+#define GPIO_PIN_9 ((uint16_t)0x0200)
+#define GPIO_PIN_10 ((uint16_t)0x0400)
+#define GPIO_PIN_11 ((uint16_t)0x0800)
+#define GPIO_PIN_12 ((uint16_t)0x1000)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+#define GPIO_PIN_15 ((uint16_t)0x8000)
+
+#define GPIO_MODE_INPUT 0x00000000U
+#define GPIO_MODE_OUTPUT_PP 0x00000001U
+#define GPIO_MODE_OUTPUT_OD 0x00000011U
+#define GPIO_MODE_AF_PP 0x00000002U
+#define GPIO_MODE_AF_OD 0x00000012U
+#define GPIO_MODE_AF_INPUT GPIO_MODE_INPUT
+#define GPIO_MODE_ANALOG 0x00000003U
+#define GPIO_MODE_IT_RISING 0x10110000U
+#define GPIO_MODE_IT_FALLING 0x10210000U
+#define GPIO_MODE_IT_RISING_FALLING 0x10310000U
+
+#define GPIO_NOPULL 0x00000000U
+#define GPIO_PULLUP 0x00000001U
+#define GPIO_PULLDOWN 0x00000002U
+
+#define GPIO_SPEED_FREQ_LOW 0x00000002U
+#define GPIO_SPEED_FREQ_MEDIUM 0x00000001U
+#define GPIO_SPEED_FREQ_HIGH 0x00000003U
+
+typedef enum
+{
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct
+{
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+} GPIO_InitTypeDef;
+
+#define __HAL_GPIO_EXTI_CLEAR_IT(pin) (EXTI->PR &= ~(uint32_t)(pin)) /* ӲΪд1, ͨڴֻܰλ */
+#define __HAL_GPIO_EXTI_GET_IT(pin) (EXTI->PR & (pin))
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_EXTI_IRQHandler(uint16_t GPIO_Pin);
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+/******************************************************************************************/
+/* NVIC / ں */
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_SetPendingIRQ(IRQn_Type IRQn);
+void __disable_irq(void);
+void __enable_irq(void);
+void __WFI(void); /* ƽһ¼(SysTick  1ms) */
+DWT_Type *sim_dwt(void);
+
+HAL_StatusTypeDef HAL_Init(void);
+uint32_t HAL_GetUIDw0(void);
+uint32_t HAL_GetUIDw1(void);
+uint32_t HAL_GetUIDw2(void);
+uint32_t HAL_GetTick(void);
+void HAL_IncTick(void);
+void HAL_Delay(uint32_t Delay);
+
+/******************************************************************************************/
+/* DMA */
+
+#define DMA_PERIPH_TO_MEMORY 0x00000000U
+#define DMA_MEMORY_TO_PERIPH 0x00000010U
+#define DMA_MEMORY_TO_MEMORY 0x00004000U
+#define DMA_PINC_ENABLE 0x00000040U
+#define DMA_PINC_DISABLE 0x00000000U
+#define DMA_MINC_ENABLE 0x00000080U
+#define DMA_MINC_DISABLE 0x00000000U
+#define DMA_PDATAALIGN_BYTE 0x00000000U
+#define DMA_PDATAALIGN_HALFWORD 0x00000100U
+#define DMA_PDATAALIGN_WORD 0x00000200U
+#define DMA_MDATAALIGN_BYTE 0x00000000U
+#define DMA_MDATAALIGN_HALFWORD 0x00000400U
+#define DMA_MDATAALIGN_WORD 0x00000800U
+#define DMA_NORMAL 0x00000000U
+#define DMA_CIRCULAR 0x00000020U
+#define DMA_PRIORITY_LOW 0x00000000U
+#define DMA_PRIORITY_MEDIUM 0x00001000U
+#define DMA_PRIORITY_HIGH 0x00002000U
+#define DMA_PRIORITY_VERY_HIGH 0x00003000U
+
+typedef struct
+{
+    uint32_t Direction;
+    uint32_t PeriphInc;
+    uint32_t MemInc;
+    uint32_t PeriphDataAlignment;
+    uint32_t MemDataAlignment;
+    uint32_t Mode;
+    uint32_t Priority;
+} DMA_InitTypeDef;
+
+typedef enum
+{
+    HAL_DMA_STATE_RESET = 0,
+    HAL_DMA_STATE_READY,
+    HAL_DMA_STATE_BUSY
+} HAL_DMA_StateTypeDef;
+
+typedef struct
+{
+    DMA_Channel_TypeDef *Instance;
+    DMA_InitTypeDef Init;
+    HAL_DMA_StateTypeDef State;
+    void *Parent;
+} DMA_HandleTypeDef;
+
+#define DMA_IT_TC DMA_CCR_TCIE
+#define DMA_IT_HT DMA_CCR_HTIE
+#define DMA_IT_TE DMA_CCR_TEIE
+#define __HAL_DMA_ENABLE_IT(h, it) ((h)->Instance->CCR |= (it))
+#define __HAL_DMA_DISABLE_IT(h, it) ((h)->Instance->CCR &= ~(it))
+#define __HAL_DMA_GET_COUNTER(h) ((h)->Instance->CNDTR)
+
+#define __HAL_LINKDMA(__HANDLE__, __PPP_DMA_FIELD__, __DMA_HANDLE__) \
+    do                                                               \
+    {                                                                \
+        (__HANDLE__)->__PPP_DMA_FIELD__ = &(__DMA_HANDLE__);         \
+        (__DMA_HANDLE__).Parent = (__HANDLE__);                      \
+    } while (0)
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength);
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength);
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma);
+
+/******************************************************************************************/
+/* ADC */
+
+#define ADC_DATAALIGN_RIGHT 0x00000000U
+#define ADC_SCAN_DISABLE 0x00000000U
+#define ADC_SCAN_ENABLE 0x00000100U
+#define ADC_SOFTWARE_START 0x000E0000U
+#define ADC_REGULAR_RANK_1 0x00000001U
+#define ADC_CHANNEL_0 0x00000000U
+#define ADC_CHANNEL_1 0x00000001U
+#define ADC_CHANNEL_5 0x00000005U
+#define ADC_SAMPLETIME_1CYCLE_5 0x00000000U
+#define ADC_SAMPLETIME_7CYCLES_5 0x00000001U
+#define ADC_SAMPLETIME_13CYCLES_5 0x00000002U
+#define ADC_SAMPLETIME_28CYCLES_5 0x00000003U
+#define ADC_SAMPLETIME_41CYCLES_5 0x00000004U
+#define ADC_SAMPLETIME_55CYCLES_5 0x00000005U
+#define ADC_SAMPLETIME_71CYCLES_5 0x00000006U
+#define ADC_SAMPLETIME_239CYCLES_5 0x00000007U
+
+typedef struct
+{
+    uint32_t DataAlign;
+    uint32_t ScanConvMode;
+    FunctionalState ContinuousConvMode;
+    uint32_t NbrOfConversion;
+    FunctionalState DiscontinuousConvMode;
+    uint32_t NbrOfDiscConversion;
+    uint32_t ExternalTrigConv;
+} ADC_InitTypeDef;
+
+typedef struct
+{
+    ADC_TypeDef *Instance;
+    ADC_InitTypeDef Init;
+    DMA_HandleTypeDef *DMA_Handle;
+} ADC_HandleTypeDef;
+
+typedef struct
+{
+    uint32_t Channel;
+    uint32_t Rank;
+    uint32_t SamplingTime;
+} ADC_ChannelConfTypeDef;
+
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *PeriphClkInit);
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig);
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length);
+
+/******************************************************************************************/
+/* TIM */
+
+#define TIM_COUNTERMODE_UP 0x00000000U
+#define TIM_CLOCKDIVISION_DIV1 0x00000000U
+#define TIM_CLOCKSOURCE_INTERNAL 0x00001000U
+#define TIM_TRGO_RESET 0x00000000U
+#define TIM_TRGO_UPDATE 0x00000020U
+#define TIM_MASTERSLAVEMODE_DISABLE 0x00000000U
+#define TIM_OCMODE_PWM1 0x00000060U
+#define TIM_OCMODE_PWM2 0x00000070U
+#define TIM_OCPOLARITY_HIGH 0x00000000U
+#define TIM_OCNPOLARITY_HIGH 0x00000000U
+#define TIM_CHANNEL_1 0x00000000U
+#define TIM_CHANNEL_2 0x00000004U
+#define TIM_CHANNEL_3 0x00000008U
+#define TIM_CHANNEL_4 0x0000000CU
+#define TIM_CR1_CEN (1UL << 0)
+#define TIM_CR1_OPM (1UL << 3)
+#define TIM_IT_UPDATE (1UL << 0)
+#define TIM_FLAG_UPDATE (1UL << 0)
+
+typedef struct
+{
+    uint32_t Prescaler;
+    uint32_t CounterMode;
+    uint32_t Period;
+    uint32_t ClockDivision;
+    uint32_t RepetitionCounter;
+    uint32_t AutoReloadPreload;
+} TIM_Base_InitTypeDef;
+
+typedef struct
+{
+    TIM_TypeDef *Instance;
+    TIM_Base_InitTypeDef Init;
+} TIM_HandleTypeDef;
+
+typedef struct
+{
+    uint32_t OCMode;
+    uint32_t Pulse;
+    uint32_t OCPolarity;
+    uint32_t OCNPolarity;
+    uint32_t OCFastMode;
+    uint32_t OCIdleState;
+    uint32_t OCNIdleState;
+} TIM_OC_InitTypeDef;
+
+typedef struct
+{
+    uint32_t ClockSource;
+    uint32_t ClockPolarity;
+    uint32_t ClockPrescaler;
+    uint32_t ClockFilter;
+} TIM_ClockConfigTypeDef;
+
+typedef struct
+{
+    uint32_t MasterOutputTrigger;
+    uint32_t MasterSlaveMode;
+} TIM_MasterConfigTypeDef;
+
+#define __HAL_TIM_ENABLE(h) ((h)->Instance->CR1 |= TIM_CR1_CEN)
+#define __HAL_TIM_DISABLE(h) ((h)->Instance->CR1 &= ~TIM_CR1_CEN)
+#define __HAL_TIM_SET_PRESCALER(h, v) ((h)->Instance->PSC = (v))
+#define __HAL_TIM_SET_AUTORELOAD(h, v) \
+    do                                 \
+    {                                  \
+        (h)->Instance->ARR = (v);      \
+        (h)->Init.Period = (v);        \
+    } while (0)
+#define __HAL_TIM_SET_COMPARE(h, ch, v) (*(&(h)->Instance->CCR1 + ((ch) >> 2)) = (v))
+#define __HAL_TIM_GET_COMPARE(h, ch) (*(&(h)->Instance->CCR1 + ((ch) >> 2)))
+#define __HAL_TIM_GET_AUTORELOAD(h) ((h)->Instance->ARR)
+#define __HAL_TIM_GET_COUNTER(h) (sim_tim_counter((h)->Instance))
+#define __HAL_TIM_SET_COUNTER(h, v) (sim_tim_set_counter((h)->Instance, (v)))
+#define __HAL_TIM_ENABLE_IT(h, it) ((h)->Instance->DIER |= (it))
+#define __HAL_TIM_DISABLE_IT(h, it) ((h)->Instance->DIER &= ~(it))
+#define __HAL_TIM_GET_FLAG(h, f) (((h)->Instance->SR & (f)) == (f))
+#define __HAL_TIM_CLEAR_IT(h, it) ((h)->Instance->SR &= ~(it)) /* ӲΪд0 */
+
+uint32_t sim_tim_counter(TIM_TypeDef *tim);
+void sim_tim_set_counter(TIM_TypeDef *tim, uint32_t cnt);
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_ConfigClockSource(TIM_HandleTypeDef *htim, TIM_ClockConfigTypeDef *sClockSourceConfig);
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim, TIM_MasterConfigTypeDef *sMasterConfig);
+HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim, TIM_OC_InitTypeDef *sConfig, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t Channel);
+void HAL_TIM_PWM_MspInit(TIM_HandleTypeDef *htim);
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim);
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim);
+
+/******************************************************************************************/
+/* UART */
+
+#define UART_FLAG_TC USART_SR_TC
+#define UART_FLAG_TXE USART_SR_TXE
+#define UART_FLAG_IDLE USART_SR_IDLE
+#define UART_FLAG_RXNE USART_SR_RXNE
+#define UART_IT_IDLE USART_CR1_IDLEIE
+#define UART_IT_RXNE USART_CR1_RXNEIE
+
+typedef struct
+{
+    uint32_t BaudRate;
+    uint32_t WordLength;
+    uint32_t StopBits;
+    uint32_t Parity;
+    uint32_t Mode;
+    uint32_t HwFlowCtl;
+} UART_InitTypeDef;
+
+typedef struct
+{
+    USART_TypeDef *Instance;
+    UART_InitTypeDef Init;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+} UART_HandleTypeDef;
+
+#define __HAL_UART_GET_FLAG(h, f) (sim_uart_get_flag((h)->Instance, (f)))
+#define __HAL_UART_CLEAR_FLAG(h, f) ((h)->Instance->SR &= ~(f))
+#define __HAL_UART_CLEAR_IDLEFLAG(h) ((h)->Instance->SR &= ~USART_SR_IDLE) /* ӲΪȶSRٶDR */
+#define __HAL_UART_ENABLE_IT(h, it) ((h)->Instance->CR1 |= (it))
+#define __HAL_UART_DISABLE_IT(h, it) ((h)->Instance->CR1 &= ~(it))
+
+uint8_t sim_uart_get_flag(USART_TypeDef *usart, uint32_t flag);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+
+/******************************************************************************************/
+/* USB 豸(PCD), ʵ sim_usb.c */
+
+#define PCD_SPEED_FULL 2U
+#define PCD_PHY_EMBEDDED 2U
+#define PCD_SNG_BUF 0U
+#define PCD_DBL_BUF 1U
+#define EP_TYPE_CTRL 0U
+#define EP_TYPE_ISOC 1U
+#define EP_TYPE_BULK 2U
+#define EP_TYPE_INTR 3U
+
+typedef struct
+{
+    uint32_t dev_endpoints;
+    uint32_t speed;
+    uint32_t ep0_mps;
+    uint32_t phy_itface;
+    uint32_t Sof_enable;
+    uint32_t low_power_enable;
+    uint32_t lpm_enable;
+    uint32_t battery_charging_enable;
+} PCD_InitTypeDef;
+
+typedef struct
+{
+    uint8_t num;
+    uint8_t is_in;
+    uint8_t is_stall;
+    uint8_t type;
+    uint8_t doublebuffer;
+    uint16_t pmaadress;
+    uint16_t pmaaddr0;
+    uint16_t pmaaddr1;
+    uint32_t maxpacket;
+    uint8_t *xfer_buff;
+    uint32_t xfer_len;
+    uint32_t xfer_count;
+} PCD_EPTypeDef;
+
+typedef struct
+{
+    USB_TypeDef *Instance;
+    PCD_InitTypeDef Init;
+    __IO uint8_t USB_Address;
+    PCD_EPTypeDef IN_ep[8];
+    PCD_EPTypeDef OUT_ep[8];
+    uint32_t Setup[12];
+    void *pData;
+} PCD_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_PCD_Init(PCD_HandleTypeDef *hpcd);
+HAL_StatusTypeDef HAL_PCD_Start(PCD_HandleTypeDef *hpcd);
+HAL_StatusTypeDef HAL_PCDEx_PMAConfig(PCD_HandleTypeDef *hpcd, uint16_t ep_addr, uint16_t ep_kind, uint32_t pmaadress);
+HAL_StatusTypeDef HAL_PCD_SetAddress(PCD_HandleTypeDef *hpcd, uint8_t address);
+HAL_StatusTypeDef HAL_PCD_EP_Open(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint16_t ep_mps, uint8_t ep_type);
+HAL_StatusTypeDef HAL_PCD_EP_Close(PCD_HandleTypeDef *hpcd, uint8_t ep_addr);
+HAL_StatusTypeDef HAL_PCD_EP_Transmit(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint8_t *pBuf, uint32_t len);
+HAL_StatusTypeDef HAL_PCD_EP_Receive(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint8_t *pBuf, uint32_t len);
+uint32_t HAL_PCD_EP_GetRxCount(PCD_HandleTypeDef *hpcd, uint8_t ep_addr);
+HAL_StatusTypeDef HAL_PCD_EP_SetStall(PCD_HandleTypeDef *hpcd, uint8_t ep_addr);
+HAL_StatusTypeDef HAL_PCD_EP_ClrStall(PCD_HandleTypeDef *hpcd, uint8_t ep_addr);
+void HAL_PCD_IRQHandler(PCD_HandleTypeDef *hpcd);
+void HAL_PCD_SetupStageCallback(PCD_HandleTypeDef *hpcd);
+void HAL_PCD_DataOutStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum);
+void HAL_PCD_DataInStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum);
+void HAL_PCD_ResetCallback(PCD_HandleTypeDef *hpcd);
+void HAL_PCD_SuspendCallback(PCD_HandleTypeDef *hpcd);
+void HAL_PCD_ResumeCallback(PCD_HandleTypeDef *hpcd);
+
+/******************************************************************************************/
+/* ƽӿ(sim_main.c ʹ) */
+
+typedef struct
+{
+    double sample_rate;  /* ADC, 0 ʾ ADC ʱӺͲʱ */
+    double cpu_scale;    /* CPUʱ  cpu_scale ʱ, 0 ʾ̼벻ʱ */
+    uint8_t fast;        /* 1: ʱһжϴǰ,  */
+    uint32_t usb_in_per_frame; /* USB ÿ֡(1ms)ȡ IN , 0 ʾ(˿δȡ) */
+    uint64_t end_ns;     /* ʱ */
+} sim_config_t;
+
+typedef struct
+{
+    uint64_t now_ns;           /* ǰʱ */
+    uint64_t samples_produced; /* ADC ɵת */
+    uint64_t samples_captured; /*  DMA ˵ڴĴ */
+    uint64_t dma_blocks;       /* DMA ɴ */
+    uint64_t uart_bytes;       /* ڷֽ */
+    uint64_t irq_count;        /* жϴ( SysTick) */
+    uint64_t dma_conflicts;    /* DMA дһͨδ()Ĵ洢, Ȩӳ */
+    uint64_t usb_bytes;        /* USB  IN ˵ֽ */
+    uint64_t usb_naks;         /* Ҫ,  OUT ˵δն NAK Ĵ */
+} sim_stats_t;
+
+extern sim_config_t g_sim_config;
+extern sim_stats_t g_sim_stats;
+
+typedef uint16_t (*sim_sample_fn)(uint64_t index, uint64_t t_ns); /* ص index ת ADC ֵ */
+typedef void (*sim_uart_fn)(const uint8_t *data, uint16_t len);   /* ڷݵȥ */
+
+void sim_set_sample_source(sim_sample_fn fn);
+void sim_set_uart_sink(sim_uart_fn fn);
+void sim_set_finish(void (*fn)(void));
+void sim_schedule_key(uint64_t t_ns, GPIO_TypeDef *port, uint16_t pin, uint8_t level, uint32_t hold_ms);
+void sim_stop(void);
+void sim_advance(uint64_t ns);
+void sim_idle(uint64_t ns);
+void sim_uart_write(const uint8_t *data, uint16_t len);
+void sim_uart_inject(uint64_t t_ns, const uint8_t *data, uint16_t len); /*  t_ns ʼֽ봮ڽ */
+double sim_adc_sample_ns(void); /* ǰ SMPR µĲ(ݳ)ʱ, ns */
+void sim_set_preempt(void (*fn)(void)); /* ߳ģʽÿһ¼һ, ൱ PendSV(sim_rtos.c ) */
+uint8_t sim_in_isr(void);               /* ִжϷ */
+void sim_usb_inject(uint64_t t_ns, const uint8_t *data, uint16_t len); /*  t_ns ʱ OUT ˵д */
+uint64_t sim_usb_next_ns(void);         /* sim_usb.c һ¼ʱ(sim_hal.c ) */
+uint8_t sim_usb_fire(void);             /* ڵ¼, Ƿ */
+void sim_usb_sink(const uint8_t *data, uint16_t len); /*  IN 봮ֽȥͬ */
+
+#endif
@@ -0,0 +1,550 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_main.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * PC Ŀ: ̼ main.c  -Dmain=fw_main , Դ
+ *
+ * ÷: fwsim [ѡ]
+ *   -c file   طŵ CSV(ʱ,ֵ M), ʱֵ;  -p ÿжӦһADCת
+ *   -d sec    ʱ(ʱ, ), δ CSV ʱʹúϳ, Ĭ 10
+ *   -r rate   ADC (/), Ĭϰ ADC ʱӺͲʱ
+ *   -N lsb    Ӹ˹ı׼, λ LSB
+ *   -E fc:lsb  PWM Ӧ: һ׵ͨ(ֹƵ fc Hz), ֵ lsb;  TIM3 ǰ
+ *             PSC/ARR/CCR1 , ֻӽ, ڼɨƵ
+ *   -Z k      źԴ: ѹ·ĴάϵЧ(M)  k ŷķ(k Ϊ弶Ļϵ); ÿβ
+ *              0 ʼ(), ʱֻ䵽 1 - exp(-ʱ / ), ڼʱ
+ *   -n        ģʽ: ʱ PERIOD 0 ɼ, ʱһжϴǰ, 
+ *   -s scale  CPUʱ  scale ʱ(̼ʱ), Ĭ 0
+ *   -o file   洮ֽ(ı + ֡),  telemetry ű
+ *   -k ms:key  ms ʱ̰° key0/key1/wkup(ס 100ms)
+ *   -u ms:cmd  ms ʱ̴Ӵڷһ(Զӻ),  -u "500:PWM 5000 250", Ӧڴֽ;
+ *             USB 汾(make USB=1)д OUT ˵, öǰڵöٺ
+ *   -U n      USB 汾: ÿ֡(1ms)ȡ IN , Ĭ 19(ȫߵ), 0 ʾȡ
+ *   -B        ²: ģʽɨ, ʺɳ
+ *   -R list   ²ԵĲб, ŷָ
+ *   -t ratio  жɳ͸( DMA ɵת / ȫת), Ĭ 0.95
+ *
+ ****************************************************************************************************
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "sim_hal.h"
+#include "myTUNE.h"
+#include "myLINK.h"
+
+int fw_main(void); /* ̼ main.c е main */
+
+/*  main.c Ļһ: R = (3.26 - V) * 4.96 / V, V = code * 3.3 / 4096 */
+#define SIM_VREF 3.3
+#define SIM_VSUP 3.26
+#define SIM_RREF 4.96
+
+/* ADC صͲ, STM32F103 ֲ: R_ADC <= 1k, C_ADC <= 8pF */
+#define SIM_R_ADC 1000.0
+#define SIM_C_ADC 8e-12
+
+static double *g_csv_t = NULL;     /* CSV ʱ, (Եһ) */
+static double *g_csv_r = NULL;     /* CSV ֵ, M */
+static size_t g_csv_n = 0;
+static size_t g_csv_cursor = 0;
+static int g_per_sample = 0;       /* CSV ÿжӦһת */
+static double g_noise_lsb = 0;
+static double g_excite_fc = 0;     /* ӦĽֹƵ, Hz, 0 ʾ */
+static double g_excite_lsb = 0;    /* ֵ, LSB */
+static double g_source_k = 0;      /* źԴ = άϵЧ(M)  k ŷķ, 0 ʾźԴ */
+static FILE *g_capture = NULL;
+static uint64_t g_rng = 0x9E3779B97F4A7C15ULL;
+static uint64_t g_wall_start = 0;
+static int g_report_fd = -1;       /* ²ӽ̰ѽд */
+
+typedef struct
+{
+    double rate;
+    double virtual_s;
+    double wall_s;
+    uint64_t blocks;
+    uint64_t produced;
+    uint64_t captured;
+    uint64_t uart_bytes;
+    uint64_t dma_conflicts;
+    uint64_t usb_bytes;
+    uint64_t usb_naks;
+} sim_result_t;
+
+static uint64_t host_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static double gauss(void)
+{
+    double u1, u2;
+
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    u1 = ((g_rng >> 11) + 1.0) / 9007199254740993.0;
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    u2 = (g_rng >> 11) / 9007199254740992.0;
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/* PWM һ׵ͨĽ, LSB; PWM رʱΪ 0 */
+static double excitation_lsb(uint64_t t_ns)
+{
+    TIM_TypeDef *tim = TIM3;
+    double f, duty, a1, x;
+
+    if (g_excite_lsb <= 0 || !(tim->CR1 & TIM_CR1_CEN) || !(tim->CCER & 1))
+    {
+        return 0;
+    }
+    f = 72e6 / (((double)tim->PSC + 1) * ((double)tim->ARR + 1));
+    duty = (double)tim->CCR1 / ((double)tim->ARR + 1);
+    a1 = g_excite_lsb * sin(M_PI * (duty > 1 ? 1 : duty)); /* ֵռձȱ仯 */
+    x = f / g_excite_fc;
+    return a1 / sqrt(1 + x * x) * sin(2 * M_PI * f * t_ns * 1e-9 - atan(x));
+}
+
+/* ֵ(M) -> ADC ֵ, main.c , ӲݽӦ */
+static uint16_t resistance_to_code(double r, uint64_t t_ns)
+{
+    double v = SIM_VSUP * SIM_RREF / (r + SIM_RREF);
+    double code;
+
+    if (g_source_k > 0)
+    {
+        double tau = (g_source_k * r * SIM_RREF / (r + SIM_RREF) + SIM_R_ADC) * SIM_C_ADC;
+
+        v *= 1 - exp(-sim_adc_sample_ns() * 1e-9 / tau);
+    }
+    code = v * 4096.0 / SIM_VREF + excitation_lsb(t_ns);
+
+    if (g_noise_lsb > 0)
+    {
+        code += g_noise_lsb * gauss();
+    }
+    if (code < 0)
+    {
+        code = 0;
+    }
+    if (code > 4095)
+    {
+        code = 4095;
+    }
+    return (uint16_t)(code + 0.5);
+}
+
+static uint16_t synthetic_sample(uint64_t index, uint64_t t_ns)
+{
+    double t = t_ns * 1e-9;
+
+    (void)index;
+    return resistance_to_code(2.0 + 0.5 * sin(2 * M_PI * 0.05 * t) + 0.1 * sin(2 * M_PI * 1.3 * t), t_ns);
+}
+
+static uint16_t csv_sample(uint64_t index, uint64_t t_ns)
+{
+    double t = t_ns * 1e-9;
+
+    if (g_per_sample)
+    {
+        if (index >= g_csv_n)
+        {
+            sim_stop();
+            return resistance_to_code(g_csv_r[g_csv_n - 1], t_ns);
+        }
+        return resistance_to_code(g_csv_r[index], t_ns);
+    }
+
+    /* ʱ䵥, αֻǰƶ */
+    while (g_csv_cursor + 1 < g_csv_n && g_csv_t[g_csv_cursor + 1] <= t)
+    {
+        g_csv_cursor++;
+    }
+    if (g_csv_cursor + 1 >= g_csv_n)
+    {
+        return resistance_to_code(g_csv_r[g_csv_n - 1], t_ns);
+    }
+    {
+        double t0 = g_csv_t[g_csv_cursor], t1 = g_csv_t[g_csv_cursor + 1];
+        double w = t1 > t0 ? (t - t0) / (t1 - t0) : 0;
+        return resistance_to_code(g_csv_r[g_csv_cursor] + w * (g_csv_r[g_csv_cursor + 1] - g_csv_r[g_csv_cursor]), t_ns);
+    }
+}
+
+/* ȡ "ʱ,ֵ"  "ֵ"  CSV, ͷȷ */
+static int load_csv(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char line[256];
+    size_t cap = 0;
+
+    if (!f)
+    {
+        perror(path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f))
+    {
+        char *end1, *end2;
+        double a = strtod(line, &end1), b;
+
+        if (end1 == line)
+        {
+            continue;
+        }
+        while (*end1 == ',' || *end1 == ' ' || *end1 == '\t')
+        {
+            end1++;
+        }
+        b = strtod(end1, &end2);
+        if (g_csv_n == cap)
+        {
+            cap = cap ? cap * 2 : 4096;
+            g_csv_t = realloc(g_csv_t, cap * sizeof(double));
+            g_csv_r = realloc(g_csv_r, cap * sizeof(double));
+        }
+        if (end2 == end1)
+        {
+            g_csv_t[g_csv_n] = (double)g_csv_n; /* : ֵֻ */
+            g_csv_r[g_csv_n] = a;
+            g_per_sample = 1;
+        }
+        else
+        {
+            g_csv_t[g_csv_n] = a;
+            g_csv_r[g_csv_n] = b;
+        }
+        g_csv_n++;
+    }
+    fclose(f);
+
+    if (g_csv_n == 0)
+    {
+        fprintf(stderr, "%s: no numeric rows\n", path);
+        return -1;
+    }
+    {
+        size_t i;
+        double t0 = g_csv_t[0];
+
+        for (i = 0; i < g_csv_n; i++)
+        {
+            g_csv_t[i] -= t0;
+        }
+    }
+    return 0;
+}
+
+static void capture_uart(const uint8_t *data, uint16_t len)
+{
+    if (g_capture)
+    {
+        fwrite(data, 1, len, g_capture);
+    }
+}
+
+static sim_result_t collect_result(void)
+{
+    sim_result_t r;
+
+    r.rate = g_sim_stats.samples_produced && g_sim_stats.now_ns
+                 ? g_sim_stats.samples_produced / (g_sim_stats.now_ns * 1e-9)
+                 : 0;
+    if (g_sim_config.sample_rate > 0)
+    {
+        r.rate = g_sim_config.sample_rate;
+    }
+    r.virtual_s = g_sim_stats.now_ns * 1e-9;
+    r.wall_s = (host_ns() - g_wall_start) * 1e-9;
+    r.blocks = g_sim_stats.dma_blocks;
+    r.produced = g_sim_stats.samples_produced;
+    r.captured = g_sim_stats.samples_captured;
+    r.uart_bytes = g_sim_stats.uart_bytes;
+    r.dma_conflicts = g_sim_stats.dma_conflicts;
+    r.usb_bytes = g_sim_stats.usb_bytes;
+    r.usb_naks = g_sim_stats.usb_naks;
+    return r;
+}
+
+static void print_result(const sim_result_t *r)
+{
+    printf("rate=%.0f virtual_s=%.3f wall_s=%.3f blocks=%llu produced=%llu captured=%llu coverage=%.4f "
+           "captured_per_s=%.0f uart_bytes=%llu host_us_per_block=%.2f dma_conflicts=%llu\n",
+           r->rate, r->virtual_s, r->wall_s, (unsigned long long)r->blocks, (unsigned long long)r->produced,
+           (unsigned long long)r->captured, r->produced ? (double)r->captured / r->produced : 0,
+           r->virtual_s > 0 ? r->captured / r->virtual_s : 0, (unsigned long long)r->uart_bytes,
+           r->blocks ? r->wall_s * 1e6 / r->blocks : 0, (unsigned long long)r->dma_conflicts);
+#if myLINK_USB
+    printf("usb_bytes=%llu usb_naks=%llu\n", (unsigned long long)r->usb_bytes, (unsigned long long)r->usb_naks);
+#endif
+}
+
+/* ̼ѭ᷵, 浽ʱ̺˳ */
+static void finish(void)
+{
+    sim_result_t r = collect_result();
+
+    if (g_capture)
+    {
+        fclose(g_capture);
+        g_capture = NULL;
+    }
+    if (g_report_fd >= 0)
+    {
+        if (write(g_report_fd, &r, sizeof(r)) != (ssize_t)sizeof(r))
+        {
+            _exit(1);
+        }
+        _exit(0);
+    }
+    print_result(&r);
+    fflush(stdout);
+}
+
+static int parse_key(const char *arg)
+{
+    char name[16];
+    double t_ms;
+
+    if (sscanf(arg, "%lf:%15s", &t_ms, name) != 2)
+    {
+        return -1;
+    }
+    if (strcmp(name, "key0") == 0)
+    {
+        sim_schedule_key((uint64_t)(t_ms * 1e6), GPIOE, GPIO_PIN_4, 0, 100);
+    }
+    else if (strcmp(name, "key1") == 0)
+    {
+        sim_schedule_key((uint64_t)(t_ms * 1e6), GPIOE, GPIO_PIN_3, 0, 100);
+    }
+    else if (strcmp(name, "wkup") == 0)
+    {
+        sim_schedule_key((uint64_t)(t_ms * 1e6), GPIOA, GPIO_PIN_0, 1, 100);
+    }
+    else
+    {
+        return -1;
+    }
+    return 0;
+}
+
+static int parse_cmd(const char *arg)
+{
+    char *end;
+    double t_ms = strtod(arg, &end);
+    char line[128];
+    int n;
+
+    if (end == arg || *end != ':')
+    {
+        return -1;
+    }
+    n = snprintf(line, sizeof(line), "%s\n", end + 1);
+    if (n <= 1 || n >= (int)sizeof(line))
+    {
+        return -1;
+    }
+#if myLINK_USB
+    sim_usb_inject((uint64_t)(t_ms * 1e6), (const uint8_t *)line, (uint16_t)n);
+#else
+    sim_uart_inject((uint64_t)(t_ms * 1e6), (const uint8_t *)line, (uint16_t)n);
+#endif
+    return 0;
+}
+
+/* ģʽ: ̼ PERIOD 0 ɼ, ʱҲǰ */
+static void enable_fast(void)
+{
+    g_sim_config.fast = 1;
+    parse_cmd("1:PERIOD 0");
+}
+
+/* ²: ÿڶӽдͷй̼ */
+static int run_benchmark(const char *rates, double threshold)
+{
+    char list[512];
+    char *tok;
+    double best = 0;
+
+    snprintf(list, sizeof(list), "%s", rates);
+    printf("%12s %10s %10s %14s %10s %16s\n", "rate", "blocks", "coverage", "captured/s", myLINK_USB ? "usb B/s" : "uart B/s",
+           "host us/block");
+    for (tok = strtok(list, ","); tok; tok = strtok(NULL, ","))
+    {
+        int fds[2];
+        pid_t pid;
+        sim_result_t r;
+        double rate = atof(tok);
+
+        if (rate <= 0 || pipe(fds) != 0)
+        {
+            continue;
+        }
+        fflush(stdout);
+        pid = fork();
+        if (pid == 0)
+        {
+            close(fds[0]);
+            g_report_fd = fds[1];
+            g_sim_config.sample_rate = rate;
+            myTUNE_set_auto(0); /* Ĭϵƽ, ʵĸͬ */
+            enable_fast();
+            g_wall_start = host_ns();
+            fw_main();
+            _exit(1);
+        }
+        close(fds[1]);
+        if (read(fds[0], &r, sizeof(r)) != (ssize_t)sizeof(r))
+        {
+            fprintf(stderr, "rate %.0f: simulation failed\n", rate);
+            close(fds[0]);
+            waitpid(pid, NULL, 0);
+            continue;
+        }
+        close(fds[0]);
+        waitpid(pid, NULL, 0);
+
+        printf("%12.0f %10llu %10.4f %14.0f %10.0f %16.2f\n", r.rate, (unsigned long long)r.blocks,
+               r.produced ? (double)r.captured / r.produced : 0, r.captured / r.virtual_s,
+               (r.uart_bytes + r.usb_bytes) / r.virtual_s, r.blocks ? r.wall_s * 1e6 / r.blocks : 0);
+        if (r.produced && (double)r.captured / r.produced >= threshold && rate > best)
+        {
+            best = rate;
+        }
+    }
+    if (best > 0)
+    {
+        printf("max sustainable sample rate (coverage >= %.2f): %.0f S/s\n", threshold, best);
+    }
+    else
+    {
+        printf("no tested rate reaches coverage %.2f\n", threshold);
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *csv = NULL, *capture = NULL, *rates = "1000,2000,5000,10000,20000,47619,100000,200000,500000,1000000";
+    double duration = -1, threshold = 0.95;
+    int bench = 0, opt, per_sample = 0;
+
+    /* ̼ȫֱַΪ uint32_t, Ҫ -no-pie  */
+    if ((uintptr_t)(uint32_t)(uintptr_t)&g_sim_stats != (uintptr_t)&g_sim_stats)
+    {
+        fprintf(stderr, "globals above 4 GiB: link the simulator with -no-pie\n");
+        return 1;
+    }
+
+    memset(&g_sim_config, 0, sizeof(g_sim_config));
+    g_sim_config.usb_in_per_frame = 19;
+    while ((opt = getopt(argc, argv, "c:pd:r:N:E:Z:ns:o:k:u:U:BR:t:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'c': csv = optarg; break;
+        case 'p': per_sample = 1; break;
+        case 'd': duration = atof(optarg); break;
+        case 'r': g_sim_config.sample_rate = atof(optarg); break;
+        case 'N': g_noise_lsb = atof(optarg); break;
+        case 'E':
+            if (sscanf(optarg, "%lf:%lf", &g_excite_fc, &g_excite_lsb) != 2 || g_excite_fc <= 0)
+            {
+                fprintf(stderr, "bad excitation '%s', expected fc:lsb\n", optarg);
+                return 1;
+            }
+            break;
+        case 'Z': g_source_k = atof(optarg); break;
+        case 'n': enable_fast(); break;
+        case 's': g_sim_config.cpu_scale = atof(optarg); break;
+        case 'o': capture = optarg; break;
+        case 'k':
+            if (parse_key(optarg) != 0)
+            {
+                fprintf(stderr, "bad key event '%s', expected ms:key0|key1|wkup\n", optarg);
+                return 1;
+            }
+            break;
+        case 'u':
+            if (parse_cmd(optarg) != 0)
+            {
+                fprintf(stderr, "bad command '%s', expected ms:text\n", optarg);
+                return 1;
+            }
+            break;
+        case 'U': g_sim_config.usb_in_per_frame = (uint32_t)atoi(optarg); break;
+        case 'B': bench = 1; break;
+        case 'R': rates = optarg; break;
+        case 't': threshold = atof(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-c csv [-p]] [-d sec] [-r rate] [-N lsb] [-E fc:lsb] [-Z k] [-n] [-s scale] [-o capture] "
+                            "[-k ms:key] [-u ms:cmd] [-U n] [-B [-R rates] [-t ratio]]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    if (csv)
+    {
+        if (load_csv(csv) != 0)
+        {
+            return 1;
+        }
+        g_per_sample |= per_sample;
+        sim_set_sample_source(csv_sample);
+        if (!g_per_sample && duration < 0)
+        {
+            duration = g_csv_t[g_csv_n - 1];
+        }
+    }
+    else
+    {
+        sim_set_sample_source(synthetic_sample);
+    }
+    if (duration < 0)
+    {
+        duration = g_per_sample ? 0 : 10;
+    }
+    g_sim_config.end_ns = (uint64_t)(duration * 1e9);
+
+    if (capture && !bench)
+    {
+        g_capture = fopen(capture, "wb");
+        if (!g_capture)
+        {
+            perror(capture);
+            return 1;
+        }
+        sim_set_uart_sink(capture_uart);
+    }
+    sim_set_finish(finish);
+
+    if (bench)
+    {
+        return run_benchmark(rates, threshold);
+    }
+
+    g_wall_start = host_ns();
+    return fw_main();
+}
@@ -0,0 +1,225 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_mlp.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * myMLP ˵ PC ˶Ժܲ(make mlpsim  mlpsim)
+ *
+ * ÷: mlpsim model.bin vectors.bin [-n repeat]
+ *   model.bin   "MLP int8 export" űд, ʽűе IntMLP.pack
+ *   vectors.bin ͽűοʵֵ, λȽ
+ *   -n repeat   ʱظ, Ĭ 200
+ *
+ * : һµĸϵĺʱ, Լ˼Ӵ Cortex-M3 ʱ
+ * (72MHz,  FPU, Ȩ 2 ȴڵ Flash ); ȫһʱ 0
+ *
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "myMLP.h"
+
+#define SIM_MLP_CPU_HZ 72000000.0
+#define SIM_MLP_CYC_MAC 5       /* ldrsb 2 + mla, չ4κƽ */
+#define SIM_MLP_CYC_NEURON 24   /* ƫásmull ͡, ѭ */
+#define SIM_MLP_CYC_INPUT 180   /*  fsub + fmul + fadd + floorf + f2iz */
+#define SIM_MLP_CYC_OUTPUT 90   /*  i2f + fmul + Ƚ */
+
+static unsigned char *g_blob;
+static size_t g_blob_len, g_pos;
+
+/**
+ * @brief       ļ
+ * @param       path: ļ
+ * @param       len : س
+ * @retval      , ʧܷ NULL
+ */
+static unsigned char *sim_mlp_read(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    unsigned char *data;
+
+    if (!f)
+    {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    *len = (size_t)ftell(f);
+    fseek(f, 0, SEEK_SET);
+    data = malloc(*len ? *len : 1);
+    if (fread(data, 1, *len, f) != *len)
+    {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    return data;
+}
+
+/**
+ * @brief       Ӳļȡ n ֽ, Ƶ·Ķڴ
+ * @param       n: ֽ
+ * @retval      
+ */
+static void *sim_mlp_take(size_t n)
+{
+    void *p;
+
+    if (g_pos + n > g_blob_len)
+    {
+        fprintf(stderr, "model file truncated\n");
+        exit(2);
+    }
+    p = malloc(n ? n : 1);
+    memcpy(p, g_blob + g_pos, n);
+    g_pos += n;
+    return p;
+}
+
+/**
+ * @brief       ļ
+ * @param       model: 
+ * @retval      
+ */
+static void sim_mlp_load(myMLP_MODEL *model)
+{
+    unsigned char *head = sim_mlp_take(10);
+    myMLP_LAYER *layers;
+    uint16_t in, out;
+    uint8_t k, has_lut;
+
+    if (memcmp(head, "MLP8", 4) != 0)
+    {
+        fprintf(stderr, "not a myMLP model file\n");
+        exit(2);
+    }
+    model->task = head[4];
+    model->n_layers = head[5];
+    memcpy(&model->n_in, head + 6, 2);
+    memcpy(&model->n_out, head + 8, 2);
+    model->in_center = sim_mlp_take(4u * model->n_in);
+    model->in_inv_step = sim_mlp_take(4u * model->n_in);
+    layers = calloc(model->n_layers, sizeof(myMLP_LAYER));
+    for (k = 0; k < model->n_layers; k++)
+    {
+        head = sim_mlp_take(5);
+        memcpy(&in, head, 2);
+        memcpy(&out, head + 2, 2);
+        has_lut = head[4];
+        if (in > myMLP_MAX_WIDTH || out > myMLP_MAX_WIDTH)
+        {
+            fprintf(stderr, "layer %u wider than myMLP_MAX_WIDTH\n", k);
+            exit(2);
+        }
+        layers[k].in = in;
+        layers[k].out = out;
+        layers[k].weight = sim_mlp_take((size_t)in * out);
+        layers[k].bias = sim_mlp_take(4u * out);
+        layers[k].mult = sim_mlp_take(4u * out);
+        layers[k].shift = sim_mlp_take(out);
+        if (has_lut)
+        {
+            layers[k].lut = sim_mlp_take(myMLP_LUT_SIZE);
+        }
+        else
+        {
+            layers[k].out_scale = sim_mlp_take(4u * out);
+        }
+    }
+    model->layers = layers;
+}
+
+static double sim_mlp_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+    myMLP_MODEL model;
+    unsigned char *vec;
+    size_t vec_len;
+    uint32_t rows, n_in, r, macs, neurons = 0, cycles;
+    const float *inputs, *expected;
+    float out[myMLP_MAX_WIDTH];
+    int repeat = 200, i, mismatch = 0, k;
+    volatile int sink = 0;
+    double t0, elapsed;
+
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s model.bin vectors.bin [-n repeat]\n", argv[0]);
+        return 2;
+    }
+    if (argc >= 5 && strcmp(argv[3], "-n") == 0)
+    {
+        repeat = atoi(argv[4]);
+    }
+
+    g_blob = sim_mlp_read(argv[1], &g_blob_len);
+    vec = sim_mlp_read(argv[2], &vec_len);
+    if (!g_blob || !vec)
+    {
+        fprintf(stderr, "cannot read %s or %s\n", argv[1], argv[2]);
+        return 2;
+    }
+    sim_mlp_load(&model);
+
+    /* vectors.bin: "MLPV" | rows u32 | n_in u32 | rows  n_in  float | rows  n_out  float */
+    memcpy(&rows, vec + 4, 4);
+    memcpy(&n_in, vec + 8, 4);
+    if (memcmp(vec, "MLPV", 4) != 0 || n_in != model.n_in ||
+        vec_len != 12 + 4ull * rows * (n_in + model.n_out))
+    {
+        fprintf(stderr, "vectors do not match the model\n");
+        return 2;
+    }
+    inputs = (const float *)(vec + 12);
+    expected = inputs + (size_t)rows * n_in;
+
+    for (r = 0; r < rows; r++)
+    {
+        myMLP_run(&model, inputs + (size_t)r * n_in, out);
+        if (memcmp(out, expected + (size_t)r * model.n_out, 4u * model.n_out) != 0)
+        {
+            if (mismatch < 5)
+            {
+                fprintf(stderr, "row %u: kernel %.9g, reference %.9g\n", r, out[0], expected[(size_t)r * model.n_out]);
+            }
+            mismatch++;
+        }
+    }
+
+    t0 = sim_mlp_now();
+    for (i = 0; i < repeat; i++)
+    {
+        for (r = 0; r < rows; r++)
+        {
+            sink += myMLP_run(&model, inputs + (size_t)r * n_in, NULL);
+        }
+    }
+    elapsed = sim_mlp_now() - t0;
+
+    macs = myMLP_macs(&model);
+    for (k = 0; k < model.n_layers; k++)
+    {
+        neurons += model.layers[k].out;
+    }
+    cycles = macs * SIM_MLP_CYC_MAC + neurons * SIM_MLP_CYC_NEURON + model.n_in * SIM_MLP_CYC_INPUT +
+             model.n_out * SIM_MLP_CYC_OUTPUT;
+
+    printf("rows %u  mismatches %d  macs %u  host %.3f us/inference  cortex-m3 ~%u cycles (%.1f us at 72MHz)\n",
+           rows, mismatch, macs, elapsed / ((double)repeat * rows) * 1e6, cycles, cycles / SIM_MLP_CPU_HZ * 1e6);
+    return mismatch != 0;
+}
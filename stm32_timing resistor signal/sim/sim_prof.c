@@ -0,0 +1,218 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_prof.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * myPROF ͳƵ PC (make check-prof ɲ profsim)
+ *
+ * myPROF.c  myPROF_MOCK_CYCCNT , ڼ g_myprof_mock_cyccnt , Դֱƽ;
+ * myFRAME.c ԭ, myLINK_write ػ֡. :
+ *   ׶μʱ    myPROF_BEGIN/END Ĵ/С//ۼ, , ۼƳ 32 λ
+ *   жӳ    ֱͼ߽(<16, 16~31, ... , >=1024)ʱ̼Ϊ 0ֵDMA 
+ *   ң֡      myPROF_report ֡ͷ//CRC ͸ظֶ, ͺͳ
+ * ȫͨʱ 0, ӡʧܵļ
+ *
+ ****************************************************************************************************
+ */
+
+#define myPROF_MOCK_CYCCNT
+
+#include <stdio.h>
+#include <string.h>
+#include "myPROF.h"
+#include "myFRAME.h"
+#include "myRAW.h"
+#include "myLINK.h"
+
+static uint8_t g_frame[myFRAME_MAX_PAYLOAD + myFRAME_OVERHEAD]; /* һνػ֡ */
+static uint16_t g_frame_len;
+static int g_checks, g_failed;
+
+#define CHECK(cond)                                                    \
+    do                                                                 \
+    {                                                                  \
+        g_checks++;                                                    \
+        if (!(cond))                                                   \
+        {                                                              \
+            g_failed++;                                                \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);     \
+        }                                                              \
+    } while (0)
+
+/* myFRAME.c ·ӿ: ػ͵ */
+uint8_t myRAW_running(void)
+{
+    return 0;
+}
+
+void myLINK_write(const uint8_t *data, uint16_t len)
+{
+    memcpy(g_frame, data, len);
+    g_frame_len = len;
+}
+
+static uint32_t sim_prof_u32(const uint8_t *p)
+{
+    return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+/*  myPROF_BEGIN/END ʱһγ cycles ڵĽ׶, Ϊ start */
+static void sim_prof_span(myPROF_STAGE stage, uint32_t start, uint32_t cycles)
+{
+    g_myprof_mock_cyccnt = start;
+    myPROF_BEGIN(stage);
+    g_myprof_mock_cyccnt = start + cycles;
+    myPROF_END(stage);
+}
+
+/*  DMA ʱΪ due ʱ,  due + late ж */
+static void sim_prof_isr(uint32_t due, int32_t late, uint8_t pending)
+{
+    g_myprof_mock_cyccnt = due - 100 * 10;
+    myPROF_dma_start(100); /* ת 10 : ʱΪ due */
+    myPROF_isr_entry(due + (uint32_t)late, pending);
+}
+
+static void sim_prof_stages(void)
+{
+    myPROF_SPAN *conv = &g_myprof_stats.stage[myPROF_STAGE_CONVERT];
+    myPROF_SPAN *loop = &g_myprof_stats.stage[myPROF_STAGE_LOOP];
+
+    myPROF_init();
+    CHECK(conv->count == 0 && conv->max == 0 && conv->sum == 0);
+
+    g_myprof_mock_cyccnt = 100;
+    {
+        myPROF_BEGIN(myPROF_STAGE_CONVERT);
+        g_myprof_mock_cyccnt = 350;
+        myPROF_END(myPROF_STAGE_CONVERT);
+    }
+    sim_prof_span(myPROF_STAGE_CONVERT, 1000, 40);
+    sim_prof_span(myPROF_STAGE_CONVERT, 5000, 1000);
+    CHECK(conv->count == 3);
+    CHECK(conv->min == 40);
+    CHECK(conv->max == 1000);
+    CHECK(conv->sum == 1290);
+
+    /* CYCCNT һ: ޷Եõȷĺʱ */
+    sim_prof_span(myPROF_STAGE_LOOP, 0xFFFFFF00u, 0x200);
+    CHECK(loop->count == 1 && loop->min == 0x200 && loop->max == 0x200);
+
+    /* ۼƳ 32 λ */
+    myPROF_record(myPROF_STAGE_LOOP, 0xF0000000u);
+    myPROF_record(myPROF_STAGE_LOOP, 0xF0000000u);
+    CHECK(loop->sum == 0x200 + 2 * (uint64_t)0xF0000000u);
+    CHECK(loop->max == 0xF0000000u);
+
+    /* ׶βӰ */
+    CHECK(g_myprof_stats.stage[myPROF_STAGE_AVERAGE].count == 0);
+}
+
+static void sim_prof_histogram(void)
+{
+    /* : <16, 16~31, 32~63, 64~127, 128~255, 256~511, 512~1023, >=1024 */
+    static const int32_t late[] = {-5, 0, 15, 16, 31, 32, 63, 64, 127, 128, 255, 256, 511, 512, 1023, 1024, 100000};
+    static const uint8_t bin[] = {0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7};
+    uint32_t expect[myPROF_ISR_BINS] = {0};
+    uint8_t i;
+
+    myPROF_init();
+    myPROF_set_conv_cycles(10);
+    for (i = 0; i < sizeof(late) / sizeof(late[0]); i++)
+    {
+        sim_prof_isr(0x80000000u + i * 4096u, late[i], i == 3);
+        expect[bin[i]]++;
+    }
+    for (i = 0; i < myPROF_ISR_BINS; i++)
+    {
+        CHECK(g_myprof_stats.isr_hist[i] == expect[i]);
+    }
+    CHECK(g_myprof_stats.isr_max == 100000);
+    CHECK(g_myprof_stats.dma_overrun == 1);
+
+    /* ʱ̸ */
+    myPROF_reset();
+    sim_prof_isr(0xFFFFFFF8u, 20, 0);
+    CHECK(g_myprof_stats.isr_hist[1] == 1 && g_myprof_stats.isr_max == 20);
+    myPROF_set_conv_cycles(myPROF_ADC_CONV_CYCLES);
+}
+
+static void sim_prof_report(void)
+{
+    const uint8_t *p = g_frame + myFRAME_HEADER_SIZE;
+    uint8_t i;
+    uint16_t len;
+
+    myPROF_init();
+    myPROF_record(myPROF_STAGE_PRINTF, 700);
+    myPROF_record(myPROF_STAGE_PRINTF, 300);
+    myPROF_record(myPROF_STAGE_LOOP, 0xF0000000u);
+    myPROF_record(myPROF_STAGE_LOOP, 0xF0000000u);
+    myPROF_set_conv_cycles(10);
+    sim_prof_isr(0x1000, 40, 1);
+    myPROF_set_conv_cycles(myPROF_ADC_CONV_CYCLES);
+    myPROF_uart_backlog();
+    myPROF_uart_backlog();
+
+    g_frame_len = 0;
+    myPROF_report();
+    len = g_frame[4] | g_frame[5] << 8;
+    CHECK(g_frame_len == myPROF_PAYLOAD_SIZE + myFRAME_OVERHEAD);
+    CHECK(g_frame[0] == myFRAME_SYNC0 && g_frame[1] == myFRAME_SYNC1);
+    CHECK(g_frame[2] == myFRAME_TYPE_TELEMETRY);
+    CHECK(len == myPROF_PAYLOAD_SIZE);
+    CHECK(myFRAME_crc16(g_frame + 2, len + 4, 0xFFFF) == (g_frame[myFRAME_HEADER_SIZE + len] | g_frame[myFRAME_HEADER_SIZE + len + 1] << 8));
+
+    CHECK(p[0] == myPROF_VERSION);
+    CHECK(p[1] == myPROF_STAGE_NUM);
+    CHECK(sim_prof_u32(p + 2) == myPROF_CPU_HZ);
+    p += 6;
+    for (i = 0; i < myPROF_STAGE_NUM; i++, p += 20)
+    {
+        uint64_t sum = sim_prof_u32(p + 12) | (uint64_t)sim_prof_u32(p + 16) << 32;
+
+        if (i == myPROF_STAGE_PRINTF)
+        {
+            CHECK(sim_prof_u32(p) == 2 && sim_prof_u32(p + 4) == 300 && sim_prof_u32(p + 8) == 700 && sum == 1000);
+        }
+        else if (i == myPROF_STAGE_LOOP)
+        {
+            CHECK(sim_prof_u32(p) == 2 && sum == 2 * (uint64_t)0xF0000000u);
+        }
+        else
+        {
+            CHECK(sim_prof_u32(p) == 0 && sim_prof_u32(p + 4) == 0 && sim_prof_u32(p + 8) == 0 && sum == 0); /* δʱĽ׶Сֵ 0 */
+        }
+    }
+    CHECK(p[0] == myPROF_ISR_BINS);
+    p++;
+    for (i = 0; i < myPROF_ISR_BINS; i++, p += 4)
+    {
+        CHECK(sim_prof_u32(p) == (i == 2));
+    }
+    CHECK(sim_prof_u32(p) == 40);
+    CHECK(sim_prof_u32(p + 4) == 1);
+    CHECK(sim_prof_u32(p + 8) == 2);
+    CHECK(p + 12 == g_frame + myFRAME_HEADER_SIZE + len);
+
+    /* ͺ */
+    CHECK(g_myprof_stats.stage[myPROF_STAGE_PRINTF].count == 0);
+    CHECK(g_myprof_stats.stage[myPROF_STAGE_PRINTF].min == 0xFFFFFFFFu);
+    CHECK(g_myprof_stats.isr_hist[2] == 0 && g_myprof_stats.isr_max == 0);
+    CHECK(g_myprof_stats.dma_overrun == 0 && g_myprof_stats.uart_backlog == 0);
+}
+
+int main(void)
+{
+    sim_prof_stages();
+    sim_prof_histogram();
+    sim_prof_report();
+    printf("myPROF: %d checks, %d failed\n", g_checks, g_failed);
+    return g_failed != 0;
+}
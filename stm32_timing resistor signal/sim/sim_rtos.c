@@ -0,0 +1,475 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_rtos.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * PC Ŀ: ʱµ FreeRTOS (make RTOS=1)
+ * 1, ÿһ ucontext, Ϸջ; ʱֻһ, ȫȷ
+ * 2, ӿʱлȼľ; ûоӦʱִ __WFI ƽʱ
+ * 3, ж( sim_advance ִ)Ѹȼ, ص߳ģʽʱ sim_rtos_preempt л,
+ *    ٽ͹жڼƳٵ˳ʱл
+ *
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+#include "sim_hal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#define SIM_RTOS_TASKS 8             /* () */
+#define SIM_RTOS_STACK (256 * 1024) /* ջ, ֽ; printf  libc ҪջԶڹ̼ջ */
+
+typedef enum
+{
+    SIM_RTOS_READY = 0,
+    SIM_RTOS_BLOCKED
+} sim_rtos_state_t;
+
+struct sim_rtos_task
+{
+    ucontext_t ctx;
+    TaskFunction_t fn;
+    void *arg;
+    const char *name;
+    UBaseType_t prio;
+    sim_rtos_state_t state;
+    const void *wait_obj;  /* ȴĶл֪ͨ, NULL ʾֻȳʱ */
+    uint8_t wait_forever;  /* ޳ʱ */
+    uint8_t timed_out;     /* ʱ */
+    TickType_t wake_tick;  /* ʱʱ */
+    uint32_t notify_value; /* ֵ֪ͨ */
+    uint8_t notified;      /* δȡߵ֪ͨ */
+};
+
+struct sim_rtos_queue
+{
+    uint8_t *storage;
+    UBaseType_t length, item_size;
+    UBaseType_t head, count;
+};
+
+static struct sim_rtos_task *g_rtos_tasks[SIM_RTOS_TASKS];
+static int g_rtos_task_num = 0;
+static struct sim_rtos_task *g_rtos_current = NULL;
+static ucontext_t g_rtos_main_ctx;
+static TickType_t g_rtos_tick = 0;
+static uint8_t g_rtos_started = 0;
+static int g_rtos_suspended = 0;         /* vTaskSuspendAll Ƕײ */
+static int g_rtos_critical = 0;          /* ٽǶײ */
+static uint8_t g_rtos_switch_pending = 0; /* иȼ, ȴл */
+
+/******************************************************************************************/
+/*  */
+
+static void sim_rtos_fatal(const char *msg)
+{
+    fprintf(stderr, "sim_rtos: %s (task %s)\n", msg, g_rtos_current ? g_rtos_current->name : "-");
+    abort();
+}
+
+/* ȼľ; 뵱ǰͬȼʱеǰ(ת) */
+static struct sim_rtos_task *sim_rtos_highest(void)
+{
+    struct sim_rtos_task *best = NULL;
+    int i;
+
+    if (g_rtos_current && g_rtos_current->state == SIM_RTOS_READY)
+    {
+        best = g_rtos_current;
+    }
+    for (i = 0; i < g_rtos_task_num; i++)
+    {
+        struct sim_rtos_task *t = g_rtos_tasks[i];
+
+        if (t->state == SIM_RTOS_READY && (best == NULL || t->prio > best->prio))
+        {
+            best = t;
+        }
+    }
+    return best;
+}
+
+static void sim_rtos_switch(void)
+{
+    struct sim_rtos_task *prev = g_rtos_current;
+    struct sim_rtos_task *next = sim_rtos_highest();
+
+    g_rtos_switch_pending = 0;
+    if (next == NULL)
+    {
+        sim_rtos_fatal("no ready task");
+    }
+    if (next == prev)
+    {
+        return;
+    }
+    g_rtos_current = next;
+    swapcontext(&prev->ctx, &next->ctx);
+}
+
+static uint8_t sim_rtos_can_switch(void)
+{
+    return g_rtos_started && !g_rtos_suspended && !g_rtos_critical && !sim_in_isr();
+}
+
+/* ӿڷǰ: ˸ȼʱл */
+static void sim_rtos_yield(void)
+{
+    if (g_rtos_switch_pending && sim_rtos_can_switch())
+    {
+        sim_rtos_switch();
+    }
+}
+
+/* жϷ߳ģʽʱ(sim_set_preempt), ൱ PendSV */
+static void sim_rtos_preempt(void)
+{
+    sim_rtos_yield();
+}
+
+static void sim_rtos_make_ready(struct sim_rtos_task *t, uint8_t timed_out)
+{
+    t->state = SIM_RTOS_READY;
+    t->wait_obj = NULL;
+    t->timed_out = timed_out;
+    if (g_rtos_current == NULL || t->prio > g_rtos_current->prio)
+    {
+        g_rtos_switch_pending = 1;
+    }
+}
+
+/* еȴ obj , Լ¼ */
+static void sim_rtos_wake(const void *obj)
+{
+    int i;
+
+    for (i = 0; i < g_rtos_task_num; i++)
+    {
+        struct sim_rtos_task *t = g_rtos_tasks[i];
+
+        if (t->state == SIM_RTOS_BLOCKED && t->wait_obj == obj)
+        {
+            sim_rtos_make_ready(t, 0);
+        }
+    }
+}
+
+/**
+ * @brief       ǰ, ֱ obj ѻʱ
+ * @param       obj  : ȴĶ, NULL ʾֻȳʱ
+ * @param       ticks: ʱ, portMAX_DELAY ʾ޵ȴ
+ * @retval      pdTRUE, ; pdFALSE, ʱ
+ */
+static BaseType_t sim_rtos_block(const void *obj, TickType_t ticks)
+{
+    struct sim_rtos_task *cur = g_rtos_current;
+
+    if (!sim_rtos_can_switch())
+    {
+        sim_rtos_fatal("blocking call with scheduler suspended, in a critical section or in an ISR");
+    }
+    cur->state = SIM_RTOS_BLOCKED;
+    cur->wait_obj = obj;
+    cur->wait_forever = ticks == portMAX_DELAY;
+    cur->wake_tick = g_rtos_tick + ticks;
+    cur->timed_out = 0;
+    sim_rtos_switch();
+    return cur->timed_out ? pdFALSE : pdTRUE;
+}
+
+static void sim_rtos_entry(void)
+{
+    g_rtos_current->fn(g_rtos_current->arg);
+    sim_rtos_fatal("task function returned");
+}
+
+static void sim_rtos_idle(void *arg)
+{
+    (void)arg;
+    while (1)
+    {
+        __WFI();
+    }
+}
+
+/******************************************************************************************/
+/*  */
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                               UBaseType_t prio, StackType_t *stack, StaticTask_t *tcb)
+{
+    struct sim_rtos_task *t;
+
+    (void)stack_depth;
+    (void)stack;
+    if (g_rtos_task_num >= SIM_RTOS_TASKS || prio >= configMAX_PRIORITIES)
+    {
+        return NULL;
+    }
+    t = calloc(1, sizeof(*t));
+    if (t == NULL)
+    {
+        return NULL;
+    }
+    t->fn = fn;
+    t->arg = arg;
+    t->name = name;
+    t->prio = prio;
+    t->state = SIM_RTOS_READY;
+    getcontext(&t->ctx);
+    t->ctx.uc_stack.ss_sp = malloc(SIM_RTOS_STACK);
+    t->ctx.uc_stack.ss_size = SIM_RTOS_STACK;
+    t->ctx.uc_link = NULL;
+    if (t->ctx.uc_stack.ss_sp == NULL)
+    {
+        free(t);
+        return NULL;
+    }
+    makecontext(&t->ctx, sim_rtos_entry, 0);
+    tcb->sim = t;
+    g_rtos_tasks[g_rtos_task_num++] = t;
+    return t;
+}
+
+void vTaskStartScheduler(void)
+{
+    StaticTask_t *idle_tcb;
+    StackType_t *idle_stack;
+    uint32_t idle_size;
+
+    vApplicationGetIdleTaskMemory(&idle_tcb, &idle_stack, &idle_size);
+    if (xTaskCreateStatic(sim_rtos_idle, "idle", idle_size, NULL, 0, idle_stack, idle_tcb) == NULL)
+    {
+        return;
+    }
+    g_rtos_started = 1;
+    sim_set_preempt(sim_rtos_preempt);
+    g_rtos_current = sim_rtos_highest();
+    g_rtos_switch_pending = 0;
+    swapcontext(&g_rtos_main_ctx, &g_rtos_current->ctx); /* ᷵ */
+}
+
+BaseType_t xTaskGetSchedulerState(void)
+{
+    if (!g_rtos_started)
+    {
+        return taskSCHEDULER_NOT_STARTED;
+    }
+    return g_rtos_suspended ? taskSCHEDULER_SUSPENDED : taskSCHEDULER_RUNNING;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return g_rtos_tick;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    if (ticks)
+    {
+        sim_rtos_block(NULL, ticks);
+    }
+}
+
+void vTaskSuspendAll(void)
+{
+    g_rtos_suspended++;
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+    uint8_t pending = g_rtos_switch_pending;
+
+    if (--g_rtos_suspended == 0)
+    {
+        sim_rtos_yield();
+    }
+    return pending && !g_rtos_suspended;
+}
+
+/* ж: ƽ, ѳʱ */
+void xPortSysTickHandler(void)
+{
+    int i;
+
+    g_rtos_tick++;
+    for (i = 0; i < g_rtos_task_num; i++)
+    {
+        struct sim_rtos_task *t = g_rtos_tasks[i];
+
+        if (t->state == SIM_RTOS_BLOCKED && !t->wait_forever && (TickType_t)(g_rtos_tick - t->wake_tick) < 0x80000000UL)
+        {
+            sim_rtos_make_ready(t, 1);
+        }
+    }
+}
+
+/******************************************************************************************/
+/* ֪ͨ */
+
+static void sim_rtos_notify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+    switch (action)
+    {
+    case eSetBits: task->notify_value |= value; break;
+    case eIncrement: task->notify_value++; break;
+    case eSetValueWithOverwrite: task->notify_value = value; break;
+    case eSetValueWithoutOverwrite:
+        if (!task->notified)
+        {
+            task->notify_value = value;
+        }
+        break;
+    default: break;
+    }
+    task->notified = 1;
+    sim_rtos_wake(&task->notified);
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+    sim_rtos_notify(task, value, action);
+    sim_rtos_yield();
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t *woken)
+{
+    sim_rtos_notify(task, value, action);
+    if (woken && g_rtos_current && task->state == SIM_RTOS_READY && task->prio > g_rtos_current->prio)
+    {
+        *woken = pdTRUE;
+    }
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t ticks)
+{
+    struct sim_rtos_task *cur = g_rtos_current;
+    BaseType_t ret;
+
+    if (!cur->notified)
+    {
+        cur->notify_value &= ~clear_on_entry;
+        if (ticks)
+        {
+            sim_rtos_block(&cur->notified, ticks);
+        }
+    }
+    if (value)
+    {
+        *value = cur->notify_value;
+    }
+    ret = cur->notified ? pdTRUE : pdFALSE;
+    if (ret)
+    {
+        cur->notify_value &= ~clear_on_exit;
+    }
+    cur->notified = 0;
+    return ret;
+}
+
+/******************************************************************************************/
+/*  */
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t *storage, StaticQueue_t *qcb)
+{
+    struct sim_rtos_queue *q = calloc(1, sizeof(*q));
+
+    if (q == NULL)
+    {
+        return NULL;
+    }
+    q->storage = storage;
+    q->length = length;
+    q->item_size = item_size;
+    qcb->sim = q;
+    return q;
+}
+
+/* ȴ״̬仯,  pdFALSE ʾѳʱ */
+static BaseType_t sim_rtos_queue_wait(QueueHandle_t q, TickType_t ticks, TickType_t start)
+{
+    TickType_t elapsed = g_rtos_tick - start;
+
+    if (ticks != portMAX_DELAY && elapsed >= ticks)
+    {
+        return pdFALSE;
+    }
+    sim_rtos_block(q, ticks == portMAX_DELAY ? portMAX_DELAY : ticks - elapsed);
+    return pdTRUE; /* ʱһּʱ pdFALSE */
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks)
+{
+    TickType_t start = g_rtos_tick;
+
+    while (q->count >= q->length)
+    {
+        if (sim_rtos_queue_wait(q, ticks, start) == pdFALSE)
+        {
+            return pdFAIL;
+        }
+    }
+    memcpy(q->storage + ((q->head + q->count) % q->length) * q->item_size, item, q->item_size);
+    q->count++;
+    sim_rtos_wake(q);
+    sim_rtos_yield();
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks)
+{
+    TickType_t start = g_rtos_tick;
+
+    while (q->count == 0)
+    {
+        if (sim_rtos_queue_wait(q, ticks, start) == pdFALSE)
+        {
+            return pdFAIL;
+        }
+    }
+    memcpy(item, q->storage + q->head * q->item_size, q->item_size);
+    q->head = (q->head + 1) % q->length;
+    q->count--;
+    sim_rtos_wake(q);
+    sim_rtos_yield();
+    return pdPASS;
+}
+
+/******************************************************************************************/
+/* ˿ */
+
+void vPortEnterCritical(void)
+{
+    __disable_irq();
+    g_rtos_critical++;
+}
+
+void vPortExitCritical(void)
+{
+    if (--g_rtos_critical == 0)
+    {
+        __enable_irq();
+        sim_rtos_yield();
+    }
+}
+
+void vPortYieldFromISR(BaseType_t woken)
+{
+    if (woken)
+    {
+        g_rtos_switch_pending = 1; /* ص߳ģʽʱ sim_rtos_preempt л */
+    }
+}
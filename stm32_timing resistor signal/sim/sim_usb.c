@@ -0,0 +1,778 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_usb.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * PC Ŀ: HAL PCD ͶԶ˵ USB , ̼ myUSB.c ԭ:
+ * 1, 豸: HAL_PCD_EP_Transmit/Receive ֻǼǶ˵ϵĴ, дʱֱӷʹ̼Ļ,
+ *    ɡSETUP ߸λΪ¼,  USB ж(HAL_PCD_IRQHandler)ù̼Ļص
+ * 2, : HAL_PCD_Start  100ms λ߲ö(ַáSET_LINE_CODING
+ *    SET_CONTROL_LINE_STATE 򿪶˿), κһ STALL Զ stderr 沢ֹͣ;
+ *    ֮ÿʱ϶(ȫ 64 ֽԼ 1ms/19)һ: еڵд OUT ˵,
+ *     IN ˵, ÿ֡ usb_in_per_frame ; ˵ûʱյ NAK, ¸ʱ϶
+ * 3, 봮ֽһ sim_set_uart_sink õȥ, -o ֱ telemetry 
+ * (PMA)˫Ӳϸڲģ: ˫ CPU װһʱصȴ, ﰴʱ
+ *
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "sim_hal.h"
+
+#define SIM_USB_ATTACH_NS 100000000ULL   /* ⵽ D+ ȥʱ */
+#define SIM_USB_RESET_NS 10000000ULL     /* ߸λ󵽵һ SETUP ʱ */
+#define SIM_USB_FRAME_NS 1000000ULL      /* ȫ֡ */
+#define SIM_USB_SLOT_NS (SIM_USB_FRAME_NS / 19) /* һ 64 ֽ(ơֺͼ)ʱ */
+#define SIM_USB_ADDRESS 5                /* ĵַ */
+#define SIM_USB_OUT_BYTES 4096           /* д OUT ˵ֽ */
+
+
+typedef struct
+{
+    uint8_t open;
+    uint8_t armed;  /* ̼˴ */
+    uint8_t stall;
+    uint8_t *buf;
+    uint32_t len;
+    uint32_t count; /* Ѵֽ */
+} sim_usb_ep_t;
+
+/* ״̬ */
+typedef enum
+{
+    SIM_USB_OFF = 0, /* ̼û USB */
+    SIM_USB_ATTACH,  /* ȴλ */
+    SIM_USB_ENUM,    /* ö */
+    SIM_USB_READY,   /* ˿Ѵ */
+    SIM_USB_FAIL     /* öʧ */
+} sim_usb_state_t;
+
+/* ƴ׶ */
+typedef enum
+{
+    SIM_CTRL_SETUP = 0,
+    SIM_CTRL_DATA_IN,
+    SIM_CTRL_DATA_OUT,
+    SIM_CTRL_STATUS_IN,
+    SIM_CTRL_STATUS_OUT
+} sim_ctrl_phase_t;
+
+static PCD_HandleTypeDef *g_usb_pcd = NULL;
+static sim_usb_ep_t g_usb_in[8];
+static sim_usb_ep_t g_usb_out[8];
+static uint8_t g_usb_address = 0; /* 豸ǰַ */
+
+static uint8_t g_usb_evt_reset = 0;
+static uint8_t g_usb_evt_setup = 0;
+static uint8_t g_usb_evt_in = 0;  /* ˵ŵλ: IN  */
+static uint8_t g_usb_evt_out = 0; /* ˵ŵλ: OUT  */
+
+static sim_usb_state_t g_usb_state = SIM_USB_OFF;
+static uint64_t g_usb_next_ns = UINT64_MAX; /* һʱ */
+static uint64_t g_usb_frame = 0;            /* ǰ֡ */
+static uint32_t g_usb_frame_in = 0;         /* ֡Ѷ IN  */
+
+static int g_usb_step = 0;                  /* öٲ */
+static sim_ctrl_phase_t g_usb_ctrl = SIM_CTRL_SETUP;
+static uint8_t g_usb_setup[8];
+static uint8_t g_usb_ctrl_buf[512];         /* ƴ */
+static uint16_t g_usb_ctrl_len = 0;
+static uint16_t g_usb_ctrl_sent = 0;        /* ݽ׶дֽ(OUT) */
+static uint16_t g_usb_cfg_len = 9;          /* ܳ */
+static uint8_t g_usb_bulk_in = 0;           /* ҵ˵ */
+static uint8_t g_usb_bulk_out = 0;
+static uint16_t g_usb_bulk_mps = 64;
+
+static uint64_t g_usb_out_t[SIM_USB_OUT_BYTES]; /* дֽڼʱ,  */
+static uint8_t g_usb_out_data[SIM_USB_OUT_BYTES];
+static int g_usb_out_num = 0;
+static uint8_t g_usb_out_zlp = 0; /* һ OUT ûк, 㳤Ȱδ */
+
+static const uint8_t g_usb_line_coding[7] = {0x00, 0xC2, 0x01, 0x00, 0x00, 0x00, 0x08}; /* 115200 8N1 */
+
+/******************************************************************************************/
+/* 豸: HAL PCD  */
+
+static void sim_usb_event(void)
+{
+    HAL_NVIC_SetPendingIRQ(USB_LP_CAN1_RX0_IRQn);
+}
+
+/* ̼˴: һʱ϶ */
+static void sim_usb_wake(void)
+{
+    uint64_t t = g_sim_stats.now_ns + SIM_USB_SLOT_NS;
+
+    if ((g_usb_state == SIM_USB_ENUM || g_usb_state == SIM_USB_READY) && t < g_usb_next_ns)
+    {
+        g_usb_next_ns = t;
+    }
+}
+
+HAL_StatusTypeDef HAL_PCD_Init(PCD_HandleTypeDef *hpcd)
+{
+    g_usb_pcd = hpcd;
+    memset(g_usb_in, 0, sizeof(g_usb_in));
+    memset(g_usb_out, 0, sizeof(g_usb_out));
+    return HAL_OK;
+}
+
+/*  D+ , ȥλ */
+HAL_StatusTypeDef HAL_PCD_Start(PCD_HandleTypeDef *hpcd)
+{
+    (void)hpcd;
+    g_usb_state = SIM_USB_ATTACH;
+    g_usb_next_ns = g_sim_stats.now_ns + SIM_USB_ATTACH_NS;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCDEx_PMAConfig(PCD_HandleTypeDef *hpcd, uint16_t ep_addr, uint16_t ep_kind, uint32_t pmaadress)
+{
+    PCD_EPTypeDef *ep = (ep_addr & 0x80) ? &hpcd->IN_ep[ep_addr & 7] : &hpcd->OUT_ep[ep_addr & 7];
+
+    ep->doublebuffer = (uint8_t)ep_kind;
+    ep->pmaadress = (uint16_t)pmaadress;
+    ep->pmaaddr0 = (uint16_t)pmaadress;
+    ep->pmaaddr1 = (uint16_t)(pmaadress >> 16);
+    return HAL_OK;
+}
+
+/*  HALһ: ַ״̬׶ε IN ɺЧ */
+HAL_StatusTypeDef HAL_PCD_SetAddress(PCD_HandleTypeDef *hpcd, uint8_t address)
+{
+    if (address == 0)
+    {
+        g_usb_address = 0;
+    }
+    else
+    {
+        hpcd->USB_Address = address;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCD_EP_Open(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint16_t ep_mps, uint8_t ep_type)
+{
+    sim_usb_ep_t *ep = (ep_addr & 0x80) ? &g_usb_in[ep_addr & 7] : &g_usb_out[ep_addr & 7];
+    PCD_EPTypeDef *hep = (ep_addr & 0x80) ? &hpcd->IN_ep[ep_addr & 7] : &hpcd->OUT_ep[ep_addr & 7];
+
+    memset(ep, 0, sizeof(*ep));
+    ep->open = 1;
+    hep->num = ep_addr & 7;
+    hep->is_in = (ep_addr & 0x80) != 0;
+    hep->maxpacket = ep_mps;
+    hep->type = ep_type;
+    hep->is_stall = 0;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCD_EP_Close(PCD_HandleTypeDef *hpcd, uint8_t ep_addr)
+{
+    sim_usb_ep_t *ep = (ep_addr & 0x80) ? &g_usb_in[ep_addr & 7] : &g_usb_out[ep_addr & 7];
+
+    (void)hpcd;
+    memset(ep, 0, sizeof(*ep));
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCD_EP_Transmit(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint8_t *pBuf, uint32_t len)
+{
+    sim_usb_ep_t *ep = &g_usb_in[ep_addr & 7];
+
+    ep->armed = 1;
+    ep->buf = pBuf;
+    ep->len = len;
+    ep->count = 0;
+    hpcd->IN_ep[ep_addr & 7].xfer_buff = pBuf;
+    hpcd->IN_ep[ep_addr & 7].xfer_len = len;
+    hpcd->IN_ep[ep_addr & 7].xfer_count = 0;
+    sim_usb_wake();
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCD_EP_Receive(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint8_t *pBuf, uint32_t len)
+{
+    sim_usb_ep_t *ep = &g_usb_out[ep_addr & 7];
+
+    ep->armed = 1;
+    ep->buf = pBuf;
+    ep->len = len;
+    ep->count = 0;
+    hpcd->OUT_ep[ep_addr & 7].xfer_buff = pBuf;
+    hpcd->OUT_ep[ep_addr & 7].xfer_len = len;
+    hpcd->OUT_ep[ep_addr & 7].xfer_count = 0;
+    sim_usb_wake();
+    return HAL_OK;
+}
+
+uint32_t HAL_PCD_EP_GetRxCount(PCD_HandleTypeDef *hpcd, uint8_t ep_addr)
+{
+    return hpcd->OUT_ep[ep_addr & 7].xfer_count;
+}
+
+HAL_StatusTypeDef HAL_PCD_EP_SetStall(PCD_HandleTypeDef *hpcd, uint8_t ep_addr)
+{
+    sim_usb_ep_t *ep = (ep_addr & 0x80) ? &g_usb_in[ep_addr & 7] : &g_usb_out[ep_addr & 7];
+
+    (void)hpcd;
+    ep->stall = 1;
+    ep->armed = 0;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCD_EP_ClrStall(PCD_HandleTypeDef *hpcd, uint8_t ep_addr)
+{
+    sim_usb_ep_t *ep = (ep_addr & 0x80) ? &g_usb_in[ep_addr & 7] : &g_usb_out[ep_addr & 7];
+
+    (void)hpcd;
+    ep->stall = 0;
+    return HAL_OK;
+}
+
+/* USB ж: δ߸λSETUPOUT  IN  */
+void HAL_PCD_IRQHandler(PCD_HandleTypeDef *hpcd)
+{
+    int i;
+
+    if (g_usb_evt_reset)
+    {
+        g_usb_evt_reset = 0;
+        g_usb_address = 0;
+        HAL_PCD_ResetCallback(hpcd);
+    }
+    if (g_usb_evt_setup)
+    {
+        g_usb_evt_setup = 0;
+        memcpy(hpcd->Setup, g_usb_setup, sizeof(g_usb_setup));
+        HAL_PCD_SetupStageCallback(hpcd);
+    }
+    for (i = 0; i < 8; i++)
+    {
+        if (g_usb_evt_out & (1U << i))
+        {
+            g_usb_evt_out &= ~(1U << i);
+            HAL_PCD_DataOutStageCallback(hpcd, (uint8_t)i);
+        }
+    }
+    for (i = 0; i < 8; i++)
+    {
+        if (g_usb_evt_in & (1U << i))
+        {
+            g_usb_evt_in &= ~(1U << i);
+            if (i == 0 && hpcd->USB_Address)
+            {
+                g_usb_address = hpcd->USB_Address;
+                hpcd->USB_Address = 0;
+            }
+            HAL_PCD_DataInStageCallback(hpcd, (uint8_t)i);
+        }
+    }
+}
+
+__weak void HAL_PCD_SetupStageCallback(PCD_HandleTypeDef *hpcd)
+{
+    (void)hpcd;
+}
+
+__weak void HAL_PCD_DataOutStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
+{
+    (void)hpcd;
+    (void)epnum;
+}
+
+__weak void HAL_PCD_DataInStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
+{
+    (void)hpcd;
+    (void)epnum;
+}
+
+__weak void HAL_PCD_ResetCallback(PCD_HandleTypeDef *hpcd)
+{
+    (void)hpcd;
+}
+
+__weak void HAL_PCD_SuspendCallback(PCD_HandleTypeDef *hpcd)
+{
+    (void)hpcd;
+}
+
+__weak void HAL_PCD_ResumeCallback(PCD_HandleTypeDef *hpcd)
+{
+    (void)hpcd;
+}
+
+/******************************************************************************************/
+/* : ö */
+
+static void sim_usb_fail(const char *what)
+{
+    fprintf(stderr, "usb: enumeration failed at step %d (request %02X %02X): %s\n", g_usb_step, g_usb_setup[0],
+            g_usb_setup[1], what);
+    g_usb_state = SIM_USB_FAIL;
+}
+
+static void sim_usb_make_setup(uint8_t type, uint8_t req, uint16_t value, uint16_t index, uint16_t length)
+{
+    g_usb_setup[0] = type;
+    g_usb_setup[1] = req;
+    g_usb_setup[2] = (uint8_t)value;
+    g_usb_setup[3] = (uint8_t)(value >> 8);
+    g_usb_setup[4] = (uint8_t)index;
+    g_usb_setup[5] = (uint8_t)(index >> 8);
+    g_usb_setup[6] = (uint8_t)length;
+    g_usb_setup[7] = (uint8_t)(length >> 8);
+}
+
+/*  step ,  0 ʾö */
+static int sim_usb_request(int step)
+{
+    switch (step)
+    {
+    case 0: sim_usb_make_setup(0x80, 0x06, 0x0100, 0, 64); break;               /* 豸(ȶ 64 ֽ) */
+    case 1: sim_usb_make_setup(0x00, 0x05, SIM_USB_ADDRESS, 0, 0); break;       /* SET_ADDRESS */
+    case 2: sim_usb_make_setup(0x80, 0x06, 0x0100, 0, 18); break;               /* 豸 */
+    case 3: sim_usb_make_setup(0x80, 0x06, 0x0200, 0, 9); break;                /* ͷ */
+    case 4: sim_usb_make_setup(0x80, 0x06, 0x0200, 0, g_usb_cfg_len); break;    /*  */
+    case 5: sim_usb_make_setup(0x80, 0x06, 0x0300, 0, 255); break;              /* б */
+    case 6: sim_usb_make_setup(0x80, 0x06, 0x0302, 0x0409, 255); break;         /* Ʒ */
+    case 7: sim_usb_make_setup(0x00, 0x09, 1, 0, 0); break;                     /* SET_CONFIGURATION */
+    case 8: sim_usb_make_setup(0x21, 0x20, 0, 0, sizeof(g_usb_line_coding)); break; /* SET_LINE_CODING */
+    case 9: sim_usb_make_setup(0x21, 0x22, 3, 0, 0); break;                     /* SET_CONTROL_LINE_STATE: DTR|RTS */
+    default: return 0;
+    }
+    return 1;
+}
+
+/* һĽ,  0 ʾ */
+static int sim_usb_check(int step)
+{
+    const uint8_t *d = g_usb_ctrl_buf;
+    uint16_t i;
+
+    switch (step)
+    {
+    case 0:
+    case 2:
+        if (g_usb_ctrl_len < 8 || d[0] != 18 || d[1] != 0x01 || (d[7] != 8 && d[7] != 16 && d[7] != 32 && d[7] != 64))
+        {
+            sim_usb_fail("bad device descriptor");
+            return 0;
+        }
+        if (step == 2 && g_usb_ctrl_len != 18)
+        {
+            sim_usb_fail("short device descriptor");
+            return 0;
+        }
+        break;
+
+    case 3:
+        if (g_usb_ctrl_len != 9 || d[1] != 0x02 || (d[2] | (d[3] << 8)) < 9)
+        {
+            sim_usb_fail("bad configuration descriptor");
+            return 0;
+        }
+        g_usb_cfg_len = (uint16_t)(d[2] | (d[3] << 8));
+        if (g_usb_cfg_len > sizeof(g_usb_ctrl_buf))
+        {
+            sim_usb_fail("configuration descriptor too long");
+            return 0;
+        }
+        break;
+
+    case 4: /* ӿڵ˵ */
+    {
+        uint8_t data_if = 0;
+
+        if (g_usb_ctrl_len != g_usb_cfg_len)
+        {
+            sim_usb_fail("short configuration descriptor");
+            return 0;
+        }
+        for (i = 0; i + 1 < g_usb_ctrl_len && d[i] >= 2; i += d[i])
+        {
+            if (d[i + 1] == 0x04 && i + 5 < g_usb_ctrl_len)
+            {
+                data_if = d[i + 5] == 0x0A;
+            }
+            else if (d[i + 1] == 0x05 && data_if && i + 5 < g_usb_ctrl_len && (d[i + 3] & 3) == 2)
+            {
+                if (d[i + 2] & 0x80)
+                {
+                    g_usb_bulk_in = d[i + 2];
+                }
+                else
+                {
+                    g_usb_bulk_out = d[i + 2];
+                }
+                g_usb_bulk_mps = (uint16_t)(d[i + 4] | (d[i + 5] << 8));
+            }
+        }
+        if (!g_usb_bulk_in || !g_usb_bulk_out || g_usb_bulk_mps == 0 || g_usb_bulk_mps > 64)
+        {
+            sim_usb_fail("no CDC data interface with bulk IN/OUT endpoints");
+            return 0;
+        }
+        break;
+    }
+
+    case 5:
+    case 6:
+        if (g_usb_ctrl_len < 2 || d[1] != 0x03 || d[0] != g_usb_ctrl_len)
+        {
+            sim_usb_fail("bad string descriptor");
+            return 0;
+        }
+        break;
+
+    default:
+        break;
+    }
+    return 1;
+}
+
+/* öеһ */
+static void sim_usb_ctrl_step(void)
+{
+    sim_usb_ep_t *in0 = &g_usb_in[0], *out0 = &g_usb_out[0];
+    uint16_t w_length;
+
+    if (g_usb_step > 1 && g_usb_address != SIM_USB_ADDRESS)
+    {
+        sim_usb_fail("device did not take the address");
+        return;
+    }
+
+    switch (g_usb_ctrl)
+    {
+    case SIM_CTRL_SETUP: /* SETUP Ǳ, ƶ˵ STALL */
+        if (!sim_usb_request(g_usb_step))
+        {
+            g_usb_state = SIM_USB_READY;
+            return;
+        }
+        in0->stall = 0;
+        out0->stall = 0;
+        g_usb_ctrl_len = 0;
+        g_usb_ctrl_sent = 0;
+        w_length = (uint16_t)(g_usb_setup[6] | (g_usb_setup[7] << 8));
+        g_usb_ctrl = w_length == 0 ? SIM_CTRL_STATUS_IN : (g_usb_setup[0] & 0x80) ? SIM_CTRL_DATA_IN : SIM_CTRL_DATA_OUT;
+        g_usb_evt_setup = 1;
+        sim_usb_event();
+        break;
+
+    case SIM_CTRL_DATA_IN:
+    {
+        uint32_t n;
+
+        w_length = (uint16_t)(g_usb_setup[6] | (g_usb_setup[7] << 8));
+        if (in0->stall)
+        {
+            sim_usb_fail("stalled");
+            return;
+        }
+        if (!in0->armed)
+        {
+            return; /* NAK */
+        }
+        n = in0->len - in0->count;
+        if (n > 64)
+        {
+            n = 64;
+        }
+        if (g_usb_ctrl_len + n > sizeof(g_usb_ctrl_buf))
+        {
+            sim_usb_fail("control data too long");
+            return;
+        }
+        memcpy(&g_usb_ctrl_buf[g_usb_ctrl_len], in0->buf + in0->count, n);
+        in0->count += n;
+        g_usb_ctrl_len += (uint16_t)n;
+        if (in0->count == in0->len)
+        {
+            in0->armed = 0;
+            g_usb_pcd->IN_ep[0].xfer_count = in0->count;
+            g_usb_evt_in |= 1;
+            sim_usb_event();
+        }
+        if (g_usb_ctrl_len > w_length)
+        {
+            sim_usb_fail("device sent more than requested");
+            return;
+        }
+        if (n < 64 || g_usb_ctrl_len == w_length)
+        {
+            g_usb_ctrl = SIM_CTRL_STATUS_OUT;
+        }
+        break;
+    }
+
+    case SIM_CTRL_DATA_OUT:
+    {
+        uint32_t n = sizeof(g_usb_line_coding) - g_usb_ctrl_sent;
+
+        if (out0->stall)
+        {
+            sim_usb_fail("stalled");
+            return;
+        }
+        if (!out0->armed)
+        {
+            return;
+        }
+        if (n > out0->len - out0->count)
+        {
+            n = out0->len - out0->count;
+        }
+        memcpy(out0->buf + out0->count, &g_usb_line_coding[g_usb_ctrl_sent], n);
+        out0->count += n;
+        g_usb_ctrl_sent += (uint16_t)n;
+        out0->armed = 0;
+        g_usb_pcd->OUT_ep[0].xfer_count = out0->count;
+        g_usb_evt_out |= 1;
+        sim_usb_event();
+        if (g_usb_ctrl_sent >= sizeof(g_usb_line_coding))
+        {
+            g_usb_ctrl = SIM_CTRL_STATUS_IN;
+        }
+        break;
+    }
+
+    case SIM_CTRL_STATUS_IN:
+        if (in0->stall)
+        {
+            sim_usb_fail("stalled");
+            return;
+        }
+        if (!in0->armed)
+        {
+            return;
+        }
+        if (in0->len != 0)
+        {
+            sim_usb_fail("data in status stage");
+            return;
+        }
+        in0->armed = 0;
+        g_usb_pcd->IN_ep[0].xfer_count = 0;
+        g_usb_evt_in |= 1;
+        sim_usb_event();
+        if (sim_usb_check(g_usb_step))
+        {
+            g_usb_step++;
+            g_usb_ctrl = SIM_CTRL_SETUP;
+        }
+        break;
+
+    case SIM_CTRL_STATUS_OUT:
+        if (out0->stall)
+        {
+            sim_usb_fail("stalled");
+            return;
+        }
+        if (!out0->armed)
+        {
+            return;
+        }
+        out0->armed = 0;
+        g_usb_pcd->OUT_ep[0].xfer_count = 0;
+        g_usb_evt_out |= 1;
+        sim_usb_event();
+        if (sim_usb_check(g_usb_step))
+        {
+            g_usb_step++;
+            g_usb_ctrl = SIM_CTRL_SETUP;
+        }
+        break;
+    }
+}
+
+/******************************************************************************************/
+/* :  */
+
+void sim_usb_inject(uint64_t t_ns, const uint8_t *data, uint16_t len)
+{
+    uint16_t k;
+
+    for (k = 0; k < len && g_usb_out_num < SIM_USB_OUT_BYTES; k++)
+    {
+        int i;
+
+        for (i = g_usb_out_num; i > 0 && g_usb_out_t[i - 1] > t_ns; i--)
+        {
+            g_usb_out_t[i] = g_usb_out_t[i - 1];
+            g_usb_out_data[i] = g_usb_out_data[i - 1];
+        }
+        g_usb_out_t[i] = t_ns;
+        g_usb_out_data[i] = data[k];
+        g_usb_out_num++;
+    }
+}
+
+static uint8_t sim_usb_out_due(void)
+{
+    return g_usb_out_num && g_usb_out_t[0] <= g_sim_stats.now_ns;
+}
+
+/* дһ OUT  */
+static void sim_usb_bulk_out(void)
+{
+    sim_usb_ep_t *ep = &g_usb_out[g_usb_bulk_out & 7];
+    uint32_t n = 0;
+
+    while (n < g_usb_bulk_mps && ep->count < ep->len && sim_usb_out_due())
+    {
+        ep->buf[ep->count++] = g_usb_out_data[0];
+        g_usb_out_num--;
+        memmove(&g_usb_out_t[0], &g_usb_out_t[1], (size_t)g_usb_out_num * sizeof(g_usb_out_t[0]));
+        memmove(&g_usb_out_data[0], &g_usb_out_data[1], (size_t)g_usb_out_num);
+        n++;
+    }
+    g_usb_out_zlp = n == g_usb_bulk_mps && !sim_usb_out_due();
+    if (n < g_usb_bulk_mps || ep->count == ep->len)
+    {
+        ep->armed = 0;
+        g_usb_pcd->OUT_ep[g_usb_bulk_out & 7].xfer_count = ep->count;
+        g_usb_evt_out |= 1U << (g_usb_bulk_out & 7);
+        sim_usb_event();
+    }
+}
+
+/* һ IN , һʱ */
+static void sim_usb_bulk_in(void)
+{
+    sim_usb_ep_t *ep = &g_usb_in[g_usb_bulk_in & 7];
+    uint32_t n = ep->len - ep->count;
+
+    if (n > g_usb_bulk_mps)
+    {
+        n = g_usb_bulk_mps;
+    }
+    if (n)
+    {
+        sim_usb_sink(ep->buf + ep->count, (uint16_t)n);
+        g_sim_stats.usb_bytes += n;
+    }
+    ep->count += n;
+    g_usb_frame_in++;
+    if (ep->count == ep->len)
+    {
+        ep->armed = 0;
+        g_usb_pcd->IN_ep[g_usb_bulk_in & 7].xfer_count = ep->count;
+        g_usb_evt_in |= 1U << (g_usb_bulk_in & 7);
+        sim_usb_event();
+    }
+}
+
+static uint8_t sim_usb_in_ready(void)
+{
+    return g_usb_in[g_usb_bulk_in & 7].armed && g_sim_config.usb_in_per_frame;
+}
+
+/* ˿ڴ򿪺һʱ϶: дڵ; OUT ˵ NAK ʱͬһʱ϶Ŷ IN, ѹʱȡӦ */
+static void sim_usb_bulk_step(void)
+{
+    if ((sim_usb_out_due() || g_usb_out_zlp) && g_usb_out[g_usb_bulk_out & 7].armed)
+    {
+        sim_usb_bulk_out();
+        return;
+    }
+    if (sim_usb_out_due())
+    {
+        g_sim_stats.usb_naks++;
+    }
+    if (sim_usb_in_ready() && g_usb_frame_in < g_sim_config.usb_in_per_frame)
+    {
+        sim_usb_bulk_in();
+    }
+}
+
+/* ûҪʱߵһʱ̻̼ */
+static void sim_usb_schedule(void)
+{
+    uint64_t now = g_sim_stats.now_ns;
+
+    if (g_usb_state == SIM_USB_ENUM)
+    {
+        g_usb_next_ns = now + SIM_USB_SLOT_NS;
+    }
+    else if (g_usb_state != SIM_USB_READY)
+    {
+        g_usb_next_ns = UINT64_MAX;
+    }
+    else if (sim_usb_out_due() || g_usb_out_zlp)
+    {
+        g_usb_next_ns = now + SIM_USB_SLOT_NS;
+    }
+    else if (sim_usb_in_ready())
+    {
+        g_usb_next_ns = g_usb_frame_in < g_sim_config.usb_in_per_frame ? now + SIM_USB_SLOT_NS
+                                                                       : (g_usb_frame + 1) * SIM_USB_FRAME_NS;
+    }
+    else
+    {
+        g_usb_next_ns = g_usb_out_num ? g_usb_out_t[0] : UINT64_MAX;
+    }
+}
+
+uint64_t sim_usb_next_ns(void)
+{
+    return g_usb_next_ns;
+}
+
+/**
+ * @brief       ʱ̺һ
+ * @param       
+ * @retval      1, ¼; 0, δʱ
+ */
+uint8_t sim_usb_fire(void)
+{
+    uint64_t frame;
+
+    if (g_sim_stats.now_ns < g_usb_next_ns)
+    {
+        return 0;
+    }
+    g_usb_next_ns = UINT64_MAX;
+
+    frame = g_sim_stats.now_ns / SIM_USB_FRAME_NS;
+    if (frame != g_usb_frame)
+    {
+        g_usb_frame = frame;
+        g_usb_frame_in = 0;
+    }
+
+    switch (g_usb_state)
+    {
+    case SIM_USB_ATTACH:
+        g_usb_state = SIM_USB_ENUM;
+        g_usb_step = 0;
+        g_usb_ctrl = SIM_CTRL_SETUP;
+        g_usb_evt_reset = 1;
+        sim_usb_event();
+        g_usb_next_ns = g_sim_stats.now_ns + SIM_USB_RESET_NS;
+        return 1;
+
+    case SIM_USB_ENUM:
+        sim_usb_ctrl_step();
+        break;
+
+    case SIM_USB_READY:
+        sim_usb_bulk_step();
+        break;
+
+    default:
+        break;
+    }
+    if (g_usb_next_ns == UINT64_MAX || g_usb_state == SIM_USB_READY)
+    {
+        sim_usb_schedule();
+    }
+    return 1;
+}
@@ -0,0 +1,320 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_valid.c
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * myVALID У PC (make check-valid ɲ validsim)
+ *
+ * ÷: validsim [-n blocks] [-s seed]
+ *   -n blocks  ϳݵĿ(ÿ 1 ), Ĭ 50000
+ *   -s seed    , Ĭ 1
+ *
+ * ϳ: ֵ 0.3 ~ 300M ֮仺Ư(ƯٶȱʱԼ 200 ), ƽÿ SIM_VALID_STEP_S սԾһ
+ * (һӦ), 㻻ɴ ADC ֵ, ÿ SIM_VALID_AVG ͺ main.c ķֵ;
+ * ƽÿ SIM_VALID_FAULT_S עһι:
+ *   open      Ͽ, ADC ӽ 0(ֵΪ inf)
+ *   saturate  ӵ, ADC (ֵΪ)
+ *   leak      ©絽 7000M , ֵΧ
+ *   spike      10% ĵܸ, ̻ 0(뵱ǰֵԶһ)
+ *   jump      ֵ 2.8 ʮ
+ *   stuck     ADC , ÿȫͬ
+ *
+ * : ϵļ/Ӧ״μӳ(), ɾݵ(սԾĵһ㡢
+ * ϻָ myVALID_WIN ںλ÷ֿͳ), ¼, У״̬Сÿĺʱ;
+ * ȫλõʵ SIM_VALID_FP_MAX ʱ 0
+ *
+ ****************************************************************************************************
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "myVALID.h"
+
+/*  main.c Ļһ: R = (3.26 - V) * 4.96 / V, V = code * 3.3 / 4096 */
+#define SIM_VALID_VREF 3.3
+#define SIM_VALID_VSUP 3.26
+#define SIM_VALID_RREF 4.96
+
+#define SIM_VALID_AVG 100          /* ÿ */
+#define SIM_VALID_NOISE_LSB 1.5    /* ÿ׼ */
+#define SIM_VALID_TAU_S 2.0        /* Ӧʱ䳣 */
+#define SIM_VALID_STEP_S 600       /* սԾƽ */
+#define SIM_VALID_FAULT_S 300      /* ϵƽ */
+#define SIM_VALID_QUIET 20         /* Ծ͹ǰټĿ */
+#define SIM_VALID_FP_MAX 0.001     /* (Ծĵһ͹ϻָ) */
+
+/* עĹ */
+enum
+{
+    SIM_FAULT_NONE = 0,
+    SIM_FAULT_OPEN,
+    SIM_FAULT_SAT,
+    SIM_FAULT_LEAK,
+    SIM_FAULT_SPIKE,
+    SIM_FAULT_JUMP,
+    SIM_FAULT_STUCK,
+    SIM_FAULT_KINDS
+};
+
+static const char *const g_fault_name[SIM_FAULT_KINDS] = {"clean", "open", "saturate", "leak", "spike", "jump", "stuck"};
+
+/* Ӧֵı־ */
+static const uint8_t g_fault_expect[SIM_FAULT_KINDS] = {
+    0,
+    myVALID_FLAG_OPEN,
+    myVALID_FLAG_SAT,
+    myVALID_FLAG_OPEN | myVALID_FLAG_RANGE,
+    myVALID_FLAG_OUTLIER,
+    myVALID_FLAG_RATE | myVALID_FLAG_RANGE, /* ǧ M ʱ ADC ֵȡֱԽ */
+    myVALID_FLAG_STUCK};
+
+static uint64_t g_rng = 1;
+
+/**
+ * @brief       xorshift64 ȷֲ [0, 1)
+ * @param       
+ * @retval      
+ */
+static double sim_valid_uniform(void)
+{
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return (g_rng >> 11) / 9007199254740992.0;
+}
+
+/**
+ * @brief       ׼ֲ̬(Box-Muller)
+ * @param       
+ * @retval      
+ */
+static double sim_valid_gauss(void)
+{
+    double u1 = 1.0 - sim_valid_uniform(), u2 = sim_valid_uniform();
+
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/**
+ * @brief       ֵ(M) -> ADC ֵ(δ), main.c 
+ * @param       r: ֵ, M
+ * @retval      ֵ, LSB
+ */
+static double sim_valid_code(double r)
+{
+    return SIM_VALID_VSUP * SIM_VALID_RREF / (r + SIM_VALID_RREF) * 4096.0 / SIM_VALID_VREF;
+}
+
+/**
+ * @brief       ɼһ: ֵ޷
+ * @param       code : ֵ
+ * @param       spike: ܸŵĵ(̻ 0)
+ * @retval      ۼӺ
+ */
+static uint32_t sim_valid_block(double code, int spike)
+{
+    uint32_t sum = 0;
+    double c;
+    int i;
+
+    for (i = 0; i < SIM_VALID_AVG; i++)
+    {
+        c = i < spike ? (code < 2048 ? 4095 : 0) : code + SIM_VALID_NOISE_LSB * sim_valid_gauss();
+        c = c < 0 ? 0 : (c > 4095 ? 4095 : c);
+        sum += (uint32_t)(c + 0.5);
+    }
+    return sum;
+}
+
+static double sim_valid_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+    static myVALID_STATE st;
+    uint32_t blocks = 50000, b, sum = 0, frozen = 0;
+    uint32_t expect[SIM_FAULT_KINDS] = {0}, hit[SIM_FAULT_KINDS] = {0}, count[SIM_FAULT_KINDS] = {0};
+    int latency[SIM_FAULT_KINDS], first_hit = -1;
+    uint32_t fp = 0, fp_step = 0, fp_recover = 0, clean = 0, steps = 0, events = 0, quiet = 0, since_fault = 1000;
+    uint32_t fault_len = 0, fault_pos = 0;
+    int fault = SIM_FAULT_NONE, k, i, failed = 0;
+    double level = 1.0, x = 1.0, drift = 0, t_check = 0, t0;
+    uint8_t flags, payload[myVALID_PAYLOAD_SIZE];
+
+    for (i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "-n") == 0)
+        {
+            blocks = (uint32_t)atol(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "-s") == 0)
+        {
+            g_rng = (uint64_t)atoll(argv[i + 1]) * 2654435761u + 1;
+        }
+    }
+    for (k = 0; k < SIM_FAULT_KINDS; k++)
+    {
+        latency[k] = -1;
+    }
+    myVALID_reset(&st);
+
+    for (b = 0; b < blocks; b++)
+    {
+        double r, code, voltage;
+        float R;
+        uint32_t adc_value;
+        int kind = SIM_FAULT_NONE, step_edge = 0;
+
+        /* : Ư, żԾ; ֵһӦ */
+        drift = 0.995 * drift + 0.0003 * sim_valid_gauss();
+        level += drift;
+        if (fault == SIM_FAULT_NONE && since_fault > SIM_VALID_QUIET && sim_valid_uniform() < 1.0 / SIM_VALID_STEP_S)
+        {
+            level += (sim_valid_uniform() < 0.5 ? -1 : 1) * (0.3 + 1.2 * sim_valid_uniform());
+            steps++;
+            step_edge = 1;
+            quiet = SIM_VALID_QUIET;
+        }
+        level = level < -0.5 ? -0.5 : (level > 2.5 ? 2.5 : level);
+        x += (level - x) * (1 - exp(-1.0 / SIM_VALID_TAU_S));
+        r = pow(10, x);
+        code = sim_valid_code(r);
+
+        /* ע */
+        if (fault == SIM_FAULT_NONE && !quiet && since_fault > SIM_VALID_QUIET &&
+            sim_valid_uniform() < 1.0 / SIM_VALID_FAULT_S)
+        {
+            fault = 1 + (int)(sim_valid_uniform() * (SIM_FAULT_KINDS - 1));
+            fault_len = fault == SIM_FAULT_SPIKE || fault == SIM_FAULT_JUMP ? 1 : 5 + (uint32_t)(sim_valid_uniform() * 115);
+            fault_pos = 0;
+            first_hit = -1;
+            count[fault]++;
+        }
+        if (fault != SIM_FAULT_NONE)
+        {
+            kind = fault;
+            switch (fault)
+            {
+            case SIM_FAULT_OPEN:
+                sum = sim_valid_block(0, 0);
+                break;
+            case SIM_FAULT_SAT:
+                sum = sim_valid_block(4095, 0);
+                break;
+            case SIM_FAULT_LEAK:
+                sum = sim_valid_block(sim_valid_code(7000), 0);
+                break;
+            case SIM_FAULT_SPIKE:
+                sum = sim_valid_block(code, SIM_VALID_AVG / 10);
+                break;
+            case SIM_FAULT_JUMP:
+                sum = sim_valid_block(sim_valid_code(pow(10, x > 0.85 ? x - 2.8 : x + 2.8)), 0);
+                break;
+            case SIM_FAULT_STUCK:
+                if (fault_pos == 0)
+                {
+                    frozen = sim_valid_block(code, 0); /* ڹϿʼʱһ */
+                }
+                sum = frozen;
+                break;
+            }
+        }
+        else
+        {
+            sum = sim_valid_block(code, 0);
+        }
+
+        /*  main.c ͬĻ */
+        adc_value = sum / SIM_VALID_AVG;
+        voltage = (float)adc_value * (3.3f / 4096);
+        R = (3.26 - voltage) * 4.96 / voltage;
+
+        t0 = sim_valid_now();
+        flags = myVALID_check(&st, b * 1000u, sum, SIM_VALID_AVG, R);
+        if (st.rise | st.fall)
+        {
+            myVALID_serialize(&st, payload);
+            events++;
+        }
+        t_check += sim_valid_now() - t0;
+
+        if (kind != SIM_FAULT_NONE)
+        {
+            /* ǰ myVALID_STUCK_N - 1 黹ʵƽź */
+            if (kind != SIM_FAULT_STUCK || fault_pos + 1 >= myVALID_STUCK_N)
+            {
+                expect[kind]++;
+                if (flags & g_fault_expect[kind])
+                {
+                    hit[kind]++;
+                }
+                else if (hit[kind] + 5 > expect[kind])
+                {
+                    fprintf(stderr, "block %u: %s missed, flags 0x%02X\n", b, g_fault_name[kind], flags);
+                }
+            }
+            if (flags && first_hit < 0)
+            {
+                first_hit = (int)fault_pos;
+                latency[kind] = latency[kind] > first_hit ? latency[kind] : first_hit;
+            }
+            if (++fault_pos >= fault_len)
+            {
+                fault = SIM_FAULT_NONE;
+                since_fault = 0;
+            }
+            continue;
+        }
+
+        clean++;
+        if (flags)
+        {
+            if (since_fault < myVALID_WIN)
+            {
+                fp_recover++;
+            }
+            else if (step_edge || quiet + 3 >= SIM_VALID_QUIET)
+            {
+                fp_step++;
+            }
+            else
+            {
+                fp++;
+                if (fp <= 5)
+                {
+                    fprintf(stderr, "block %u: clean sample flagged 0x%02X\n", b, flags);
+                }
+            }
+        }
+        since_fault++;
+        if (quiet)
+        {
+            quiet--;
+        }
+    }
+
+    printf("blocks %u  steps %u  faults injected / blocks detected / first detection (blocks):\n", blocks, steps);
+    for (k = 1; k < SIM_FAULT_KINDS; k++)
+    {
+        printf("  %-9s %4u  %6u / %-6u  %d\n", g_fault_name[k], count[k], hit[k], expect[k], latency[k]);
+        failed |= hit[k] != expect[k];
+    }
+    printf("clean %u  false positives %u (%.4f%%)  first step sample %u  fault recovery %u  events %u\n",
+           clean, fp, clean ? 100.0 * fp / clean : 0.0, fp_step, fp_recover, events);
+    printf("state %u bytes  host %.3f us/sample\n", (unsigned)sizeof(myVALID_STATE), t_check / blocks * 1e6);
+    failed |= clean && (double)fp / clean > SIM_VALID_FP_MAX;
+    return failed;
+}
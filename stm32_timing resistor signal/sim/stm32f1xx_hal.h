@@ -0,0 +1,21 @@
+/**
+ ****************************************************************************************************
+ * @file        stm32f1xx_hal.h
+ * @author      
+ * @version     V2.0
+ * @date        2024-09-03
+ * @brief       紫ӦԣPWMơADCжϣ
+ * @license     йҵѧȫѧԺ
+ ****************************************************************************************************
+ * @attention
+ *
+ * PC Ŀ: stm32f1xx_hal.h (stm32f1xx_it.c ʹ)
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __STM32F1xx_HAL_H
+#define __STM32F1xx_HAL_H
+#include "sim_hal.h"
+
+#endif
@@ -125,7 +125,7 @@ extern "C" {
   */
 #define  VDD_VALUE                    3300U /*!< Value of VDD in mv */
 #define  TICK_INT_PRIORITY            0x0FU /*!< tick interrupt priority */
-#define  USE_RTOS                     0U
+#define  USE_RTOS                     0U /* F1 HAL ֧1; FreeRTOS ܹ myTASK.h  myTASK_RTOS ѡ */
 #define  PREFETCH_ENABLE              1U
 
 #define  USE_HAL_ADC_REGISTER_CALLBACKS         0U /* ADC register callback disabled       */
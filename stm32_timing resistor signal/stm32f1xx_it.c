@@ -23,6 +23,7 @@
 #include "stm32f1xx_hal.h"
 #include "stm32f1xx_it.h"
 #include "./SYSTEM/sys/sys.h"
+#include "myTASK.h"
    
 /** @addtogroup STM32F1xx_HAL_Examples
   * @{
@@ -107,12 +108,15 @@ void UsageFault_Handler(void)
 
 /**
   * @brief  This function handles SVCall exception.
+  * @note   myTASK_RTOS Ϊ 1 ʱ FreeRTOS ˿ṩ( FreeRTOSConfig.h)
   * @param  None
   * @retval None
   */
+#if !myTASK_RTOS
 void SVC_Handler(void)
 {
 }
+#endif
 
 /**
   * @brief  This function handles Debug Monitor exception.
@@ -125,12 +129,15 @@ void DebugMon_Handler(void)
 
 /**
   * @brief  This function handles PendSVC exception.
+  * @note   myTASK_RTOS Ϊ 1 ʱ FreeRTOS ˿ṩ( FreeRTOSConfig.h)
   * @param  None
   * @retval None
   */
+#if !myTASK_RTOS
 void PendSV_Handler(void)
 {
 }
+#endif
 
 /**
   * @brief  This function handles SysTick Handler.
@@ -140,6 +147,9 @@ void PendSV_Handler(void)
 void SysTick_Handler(void)
 {
   HAL_IncTick();
+#if myTASK_RTOS
+  myTASK_tick(); /* SysTick ͬʱΪ FreeRTOS Ľ */
+#endif
 }
 
 /******************************************************************************/